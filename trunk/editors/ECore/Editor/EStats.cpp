@@ -16,6 +16,7 @@ CStats::CStats()
 	fTPS		= 0;
 	dwLevelSelFaceCount	= 0;
 	dwLevelSelVertexCount=0;
+	RenderDUMP_SKIN_Verts=0;
 }
 
 CStats::~CStats()
@@ -78,7 +79,7 @@ void CStats::Show(CGameFont* font)
 		F.OutNext	("SH/T/M/C:     %d/%d/%d/%d",	dwShader_Codes,dwShader_Textures,dwShader_Matrices,dwShader_Constants);
 		F.OutNext	("LIGHT S/T:    %d/%d",			dwLightInScene,dwTotalLight);
 		F.OutNext	("Skeletons:    %2.2fms, %d",	Animation.result,Animation.count);
-		F.OutNext	("Skinning:     %2.2fms",		RenderDUMP_SKIN.result);
+		F.OutNext	("Skinning:     %2.2fms, %d",	RenderDUMP_SKIN.result,RenderDUMP_SKIN_Verts);
 		F.OutSkip	();
 		F.OutNext	("Input:        %2.2fms",		Input.result);
 		F.OutNext	("clRAY:        %2.2fms, %d",	clRAY.result,clRAY.count);
@@ -113,6 +114,7 @@ void CStats::Show(CGameFont* font)
 		clFRUSTUM.FrameStart		();
 
 		RenderDUMP_SKIN.FrameStart	();
+		RenderDUMP_SKIN_Verts		= 0;
 		RenderDUMP_RT.FrameStart	();
 
 		RenderDUMP_DT_VIS.FrameStart();
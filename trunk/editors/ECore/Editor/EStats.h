@@ -27,6 +27,7 @@ public:
 	CStatTimer	RenderTOTAL_Real;
 	CStatTimer	RenderCALC;			// portal traversal, frustum culling, entities "OnVisible"
 	CStatTimer	RenderDUMP_SKIN;
+	u32			RenderDUMP_SKIN_Verts;
 	CStatTimer	Animation;			// skeleton calculation
 	CStatTimer	RenderDUMP_DT_VIS;	// ...details visibility detection
 	CStatTimer	RenderDUMP_DT_Render;// ...details rendering
@@ -40,6 +40,7 @@ LPCSTR CEngine::LastWindowsError()
 
 extern void __stdcall xrSkin1W_x86	(vertRender* D, vertBoned1W* S, u32 vCount, CBoneInstance* Bones);
 extern void __stdcall xrSkin2W_x86	(vertRender* D, vertBoned2W* S, u32 vCount, CBoneInstance* Bones);
+extern void __stdcall xrSkin4W_x86	(vertRender* D, vertBoned4W* S, u32 vCount, CBoneInstance* Bones);
 
 void CEngine::Initialize(void)
 {
@@ -59,6 +60,7 @@ void CEngine::Initialize(void)
     // for compliance with editor
     PSGP.skin1W				= xrSkin1W_x86;
     PSGP.skin2W				= xrSkin2W_x86;
+    PSGP.skin4W				= xrSkin4W_x86;
 #endif
 
 	ReloadSettings			();
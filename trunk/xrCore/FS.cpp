@@ -22,9 +22,11 @@ XRCORE_API DUMMY_STUFF	*g_dummy_stuff = 0;
 	u32								g_file_mapped_count	= 0;
 	typedef std::map<u32,std::pair<u32,shared_str> >	FILE_MAPPINGS;
 	FILE_MAPPINGS					g_file_mappings;
+	static xrCriticalSection		g_file_mappings_lock;		// archives are opened from the worker threads too
 
 void register_file_mapping			(void *address, const u32 &size, LPCSTR file_name)
 {
+	g_file_mappings_lock.Enter		();
 	FILE_MAPPINGS::const_iterator	I = g_file_mappings.find(*(u32*)&address);
 	VERIFY							(I == g_file_mappings.end());
 	g_file_mappings.insert			(std::make_pair(*(u32*)&address,std::make_pair(size,shared_str(file_name))));
@@ -37,10 +39,12 @@ void register_file_mapping			(void *address, const u32 &size, LPCSTR file_name)
 	sprintf_s						(temp, sizeof(temp),"file mapping: %s",file_name);
 	memory_monitor::monitor_alloc	(address,size,temp);
 #endif // USE_MEMORY_MONITOR
+	g_file_mappings_lock.Leave		();
 }
 
 void unregister_file_mapping		(void *address, const u32 &size)
 {
+	g_file_mappings_lock.Enter		();
 	FILE_MAPPINGS::iterator			I = g_file_mappings.find(*(u32*)&address);
 	VERIFY							(I != g_file_mappings.end());
 //	VERIFY2							((*I).second.first == size,make_string("file mapping sizes are different: %d -> %d",(*I).second.first,size));
@@ -52,6 +56,7 @@ void unregister_file_mapping		(void *address, const u32 &size)
 #ifdef USE_MEMORY_MONITOR
 	memory_monitor::monitor_free	(address);
 #endif // USE_MEMORY_MONITOR
+	g_file_mappings_lock.Leave		();
 }
 
 XRCORE_API void dump_file_mappings	()
@@ -130,8 +130,50 @@ public:
 //------------------------------------------------------------------------------------
 template <typename implementation_type>
 class IReaderBase {
+private:
+	// root chunks directory, built by the second find_chunk - loaders mostly look up several chunks
+	struct chunk
+	{
+		u32			id;
+		u32			offset;			// of the data
+		u32			size;
+		BOOL		compressed;
+	};
+	struct chunk_pred
+	{
+		IC bool		operator()	(const chunk& a, const chunk& b) const	{ return a.id<b.id;	}
+		IC bool		operator()	(const chunk& a, u32 id) const			{ return a.id<id;	}
+		IC bool		operator()	(u32 id, const chunk& b) const			{ return id<b.id;	}
+	};
+	typedef xr_vector<chunk>	CHUNKS;
+
+	CHUNKS*			m_chunks;
+	u32				m_find_count;
+
+	IC	void		build_chunks()
+	{
+		m_chunks	= xr_new<CHUNKS>();
+		rewind		();
+		while (!eof()) {
+			chunk	C;
+			u32		dwType	= r_u32();
+			C.size			= r_u32();
+			C.id			= dwType&(~CFS_CompressMark);
+			C.compressed	= dwType&CFS_CompressMark;
+			C.offset		= (u32)impl().tell();
+			VERIFY	(C.offset + C.size <= (u32)impl().length());
+			m_chunks->push_back	(C);
+			impl().advance		(C.size);
+		}
+		// stable, so duplicate IDs resolve to the first one as with the scan
+		std::stable_sort	(m_chunks->begin(),m_chunks->end(),chunk_pred());
+	}
+
 public:
-	virtual			~IReaderBase()				{}
+					IReaderBase	()							: m_chunks(0), m_find_count(0)	{}
+					IReaderBase	(const IReaderBase&)		: m_chunks(0), m_find_count(0)	{}
+	IReaderBase&	operator=	(const IReaderBase&)		{ xr_delete(m_chunks); m_find_count=0; return *this; }
+	virtual			~IReaderBase()				{ xr_delete(m_chunks); }
 
 	IC implementation_type&impl	()				{return *(implementation_type*)this;}
 	IC const implementation_type&impl() const	{return *(implementation_type*)this;}
@@ -188,6 +230,18 @@ public:
 
 	IC	u32 		find_chunk	(u32 ID, BOOL* bCompressed = 0)	
 	{
+		if (m_chunks || (++m_find_count > 1)) {
+			if (!m_chunks)	build_chunks();
+			typename CHUNKS::const_iterator	I = std::lower_bound(m_chunks->begin(),m_chunks->end(),ID,chunk_pred());
+			if ((I==m_chunks->end()) || (I->id!=ID)) {
+				impl().seek	(impl().length());
+				return		0;
+			}
+			impl().seek		(I->offset);
+			if (bCompressed) *bCompressed = I->compressed;
+			return			I->size;
+		}
+
 		u32	dwSize,dwType;
 
 		rewind();
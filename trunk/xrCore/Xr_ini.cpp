@@ -8,6 +8,21 @@ XRCORE_API CInifile *pSettings	= NULL;
 CInifile* CInifile::Create(const char* szFileName, BOOL ReadOnly)
 {	return xr_new<CInifile>(szFileName,ReadOnly); }
 
+CInifile* CInifile::Create_cached(LPCSTR szFileName, LPCSTR cache_name)
+{
+	CInifile*	ini	= xr_new<CInifile>(szFileName,TRUE,FALSE,FALSE);
+	if (ini->load_cache(cache_name))
+		return	ini;
+
+	Sources		sources;
+	ini->m_sources	= &sources;
+	ini->load_file	();
+	if (!ini->DATA.empty())
+		ini->save_cache	(cache_name);
+	ini->m_sources	= 0;
+	return		ini;
+}
+
 void CInifile::Destroy(CInifile* ini)
 {	xr_delete(ini); }
 
@@ -22,6 +37,25 @@ bool item_pred(const CInifile::Item& x, LPCSTR val)
     else				   		return xr_strcmp(*x.first,val)<0;
 }
 
+// case insensitive, so r_section can look up before lowering the name
+IC u32 name_hash(LPCSTR S)
+{
+	u32		h	= 2166136261u;
+	for (; *S; ++S) {
+		u8	c	= u8(*S);
+		if (c>='A' && c<='Z')	c	+= 'a'-'A';
+		h		= (h^c)*16777619u;
+	}
+	return	h;
+}
+
+static u32 index_size(u32 count)
+{
+	u32		size	= 16;
+	while (size < count*2)	size	<<= 1;
+	return	size;
+}
+
 //------------------------------------------------------------------------------
 //  Inifile
 //------------------------------------------------------------------------------
@@ -64,13 +98,43 @@ XRCORE_API void _decorate(LPSTR dest, LPCSTR src)
 
 BOOL	CInifile::Sect::line_exist( LPCSTR L, LPCSTR* val )
 {
-	SectCIt A = std::lower_bound(Data.begin(),Data.end(),L,item_pred);
-    if (A!=Data.end() && xr_strcmp(*A->first,L)==0){
+	const Item*	A	= find(L);
+    if (A){
     	if (val) *val = *A->second;
     	return TRUE;
     }
 	return FALSE;
 }
+
+const CInifile::Item* CInifile::Sect::find( LPCSTR L ) const
+{
+	if (Index.empty()) {
+		SectCIt A = std::lower_bound(Data.begin(),Data.end(),L,item_pred);
+		return	(A!=Data.end() && xr_strcmp(*A->first,L)==0) ? &*A : 0;
+	}
+
+	u32			mask	= Index.size()-1;
+	for (u32 h=name_hash(L)&mask; Index[h]!=u32(-1); h=(h+1)&mask) {
+		const Item&	I	= Data[Index[h]];
+		if (0==xr_strcmp(*I.first,L))	return &I;
+	}
+	return		0;
+}
+
+void	CInifile::Sect::build_index( )
+{
+	Index.clear			();
+	if (Data.empty())	return;
+
+	Index.assign		(index_size(Data.size()),u32(-1));
+	u32			mask	= Index.size()-1;
+	for (u32 i=0; i<Data.size(); ++i) {
+		if (!Data[i].first)	continue;
+		u32		h		= name_hash(*Data[i].first)&mask;
+		while (Index[h]!=u32(-1))	h = (h+1)&mask;
+		Index[h]		= i;
+	}
+}
 //------------------------------------------------------------------------------
 
 CInifile::CInifile(IReader* F ,LPCSTR path)
@@ -78,7 +142,9 @@ CInifile::CInifile(IReader* F ,LPCSTR path)
 	fName		= 0;
 	bReadOnly	= TRUE;
 	bSaveAtEnd	= FALSE;
+	m_sources	= 0;
 	Load		(F,path);
+	index_items	();
 }
 
 CInifile::CInifile(LPCSTR szFileName, BOOL ReadOnly, BOOL bLoad, BOOL SaveAtEnd)
@@ -86,17 +152,35 @@ CInifile::CInifile(LPCSTR szFileName, BOOL ReadOnly, BOOL bLoad, BOOL SaveAtEnd)
 	fName		= szFileName?xr_strdup(szFileName):0;
     bReadOnly	= ReadOnly;
     bSaveAtEnd	= SaveAtEnd;
+	m_sources	= 0;
 	if (bLoad)
-	{	
-    	string_path	path,folder; 
-		_splitpath	(fName, path, folder, 0, 0 );
-        strcat		(path,folder);
-		IReader* R 	= FS.r_open(szFileName);
-        if (R){
-			Load		(R,path);
-			FS.r_close	(R);
-        }
+		load_file	();
+}
+
+void CInifile::load_file( )
+{
+	string_path	path,folder; 
+	_splitpath	(fName, path, folder, 0, 0 );
+	strcat		(path,folder);
+	IReader* R 	= open_source(fName);
+	if (R){
+		Load		(R,path);
+		FS.r_close	(R);
+	}
+	index_items	();
+}
+
+IReader* CInifile::open_source( LPCSTR fn )
+{
+	IReader* R	= FS.r_open(fn);
+	if (R && m_sources) {
+		source	S;
+		S.name	= fn;
+		S.size	= R->length();
+		S.crc	= crc32(R->pointer(),R->length());
+		m_sources->push_back	(S);
 	}
+	return		R;
 }
 
 CInifile::~CInifile( )
@@ -163,18 +247,14 @@ void	CInifile::Load(IReader* F, LPCSTR path)
                 strconcat	(sizeof(fn),fn,path,inc_name);
 				_splitpath	(fn,inc_path,folder, 0, 0 );
 				strcat		(inc_path,folder);
-            	IReader* I 	= FS.r_open(fn); R_ASSERT3(I,"Can't find include file:", inc_name);
+            	IReader* I 	= open_source(fn); R_ASSERT3(I,"Can't find include file:", inc_name);
             	Load		(I,inc_path);
                 FS.r_close	(I);
             }
         }else if (str[0] && (str[0]=='[')){
 			// insert previous filled section
-			if (Current){
-				RootIt I		= std::lower_bound(DATA.begin(),DATA.end(),*Current->Name,sect_pred);
-				if ((I!=DATA.end())&&((*I)->Name==Current->Name))
-					Debug.fatal(DEBUG_INFO,"Duplicate section '%s' found.",*Current->Name);
-				DATA.insert		(I,Current);
-			}
+			if (Current)
+				insert_section	(Current);
 			Current				= xr_new<Sect>();
 			Current->Name		= 0;
 			// start new section
@@ -230,14 +310,131 @@ void	CInifile::Load(IReader* F, LPCSTR path)
 		}
 	}
 	if (Current)
-	{
-		RootIt I		= std::lower_bound(DATA.begin(),DATA.end(),*Current->Name,sect_pred);
-		if ((I!=DATA.end())&&((*I)->Name==Current->Name))
-			Debug.fatal(DEBUG_INFO,"Duplicate section '%s' found.",*Current->Name);
-		DATA.insert		(I,Current);
+		insert_section	(Current);
+}
+
+void	CInifile::insert_section(Sect* S)
+{
+	if (find_section(*S->Name))
+		Debug.fatal(DEBUG_INFO,"Duplicate section '%s' found.",*S->Name);
+	RootIt I		= std::lower_bound(DATA.begin(),DATA.end(),*S->Name,sect_pred);
+	DATA.insert		(I,S);
+
+	if (DATA.size()*2 > INDEX.size()) {
+		index_sections	();
+		return;
+	}
+	u32	mask		= INDEX.size()-1;
+	u32	h			= name_hash(*S->Name)&mask;
+	while (INDEX[h])	h = (h+1)&mask;
+	INDEX[h]		= S;
+}
+
+void	CInifile::index_sections()
+{
+	INDEX.assign	(index_size(DATA.size()),(Sect*)0);
+	u32	mask		= INDEX.size()-1;
+	for (RootIt it=DATA.begin(); it!=DATA.end(); ++it) {
+		u32	h		= name_hash(*(*it)->Name)&mask;
+		while (INDEX[h])	h = (h+1)&mask;
+		INDEX[h]	= *it;
 	}
 }
 
+void	CInifile::index_items()
+{
+	for (RootIt it=DATA.begin(); it!=DATA.end(); ++it)
+		(*it)->build_index	();
+}
+
+CInifile::Sect*	CInifile::find_section(LPCSTR S)
+{
+	if (INDEX.empty())	return 0;
+
+	u32	mask		= INDEX.size()-1;
+	for (u32 h=name_hash(S)&mask; INDEX[h]; h=(h+1)&mask)
+		if (0==xr_strcmp(*INDEX[h]->Name,S))	return INDEX[h];
+	return			0;
+}
+
+//--------------------------------------------------------------------------------------
+// Binary cache: resolved sections of a read-only file, valid while all the files it was
+// read from (with includes) keep their size and crc
+//--------------------------------------------------------------------------------------
+#define LTX_CACHE_VERSION	1
+
+static shared_str	r_cache_string(IReader* F)
+{
+	LPCSTR		S	= (LPCSTR)F->pointer();
+	F->advance	(xr_strlen(S)+1);
+	return		S[0] ? shared_str(S) : shared_str(0);
+}
+
+BOOL	CInifile::load_cache(LPCSTR cache_name)
+{
+	if (!FS.exist(cache_name))	return FALSE;
+	IReader*	F	= FS.r_open(cache_name);
+	if (!F)		return FALSE;
+
+	BOOL	valid	= (F->length() > 2*sizeof(u32)) && (F->r_u32()==LTX_CACHE_VERSION);
+	if (valid) {
+		u32		count	= F->r_u32();
+		for (u32 it=0; valid && it<count; ++it) {
+			string_path	fn;
+			F->r_stringZ(fn,sizeof(fn));
+			u32		size	= F->r_u32();
+			u32		crc		= F->r_u32();
+			IReader* S		= FS.exist(fn) ? FS.r_open(fn) : 0;
+			valid			= S && (S->length()==int(size)) && (crc32(S->pointer(),size)==crc);
+			if (S)	FS.r_close	(S);
+		}
+	}
+
+	if (valid) {
+		// sections and items are stored sorted
+		u32		count	= F->r_u32();
+		DATA.reserve	(count);
+		for (u32 it=0; it<count; ++it) {
+			Sect*	S	= xr_new<Sect>();
+			S->Name		= r_cache_string(F);
+			S->Data.resize	(F->r_u32());
+			for (SectIt_ I=S->Data.begin(); I!=S->Data.end(); ++I) {
+				I->first	= r_cache_string(F);
+				I->second	= r_cache_string(F);
+			}
+			S->build_index	();
+			DATA.push_back	(S);
+		}
+		index_sections	();
+	}
+	FS.r_close		(F);
+	return			valid;
+}
+
+void	CInifile::save_cache(LPCSTR cache_name)
+{
+	VERIFY			(m_sources && bReadOnly);
+	CMemoryWriter	F;
+	F.w_u32			(LTX_CACHE_VERSION);
+	F.w_u32			(m_sources->size());
+	for (Sources::const_iterator it=m_sources->begin(); it!=m_sources->end(); ++it) {
+		F.w_stringZ	(it->name);
+		F.w_u32		(it->size);
+		F.w_u32		(it->crc);
+	}
+	F.w_u32			(DATA.size());
+	for (RootIt it=DATA.begin(); it!=DATA.end(); ++it) {
+		F.w_stringZ	((*it)->Name);
+		F.w_u32		((*it)->Data.size());
+		for (SectCIt I=(*it)->Data.begin(); I!=(*it)->Data.end(); ++I) {
+			F.w_stringZ	(I->first);
+			F.w_stringZ	(I->second);
+		}
+	}
+	if (!F.save_to(cache_name))
+		Msg			("! Can't write ini cache '%s'",cache_name);
+}
+
 bool	CInifile::save_as( LPCSTR new_fname )
 {
 	// save if needed
@@ -303,16 +500,13 @@ bool	CInifile::save_as( LPCSTR new_fname )
 
 BOOL	CInifile::section_exist( LPCSTR S )
 {
-	RootIt I = std::lower_bound(DATA.begin(),DATA.end(),S,sect_pred);
-	return (I!=DATA.end() && xr_strcmp(*(*I)->Name,S)==0);
+	return (0!=find_section(S));
 }
 
 BOOL	CInifile::line_exist( LPCSTR S, LPCSTR L )
 {
-	if (!section_exist(S)) return FALSE;
-	Sect&	I = r_section(S);
-	SectCIt A = std::lower_bound(I.Data.begin(),I.Data.end(),L,item_pred);
-	return (A!=I.Data.end() && xr_strcmp(*A->first,L)==0);
+	Sect*	I = find_section(S);
+	return (I && I->find(L));
 }
 
 u32		CInifile::line_count(LPCSTR Sname)
@@ -337,17 +531,17 @@ BOOL			CInifile::section_exist	( const shared_str& S	)					{ return	section_exis
 CInifile::Sect& CInifile::r_section( LPCSTR S )
 {
 	char	section[256]; strcpy_s(section,sizeof(section),S); strlwr(section);
-	RootIt I = std::lower_bound(DATA.begin(),DATA.end(),section,sect_pred);
-	if (!(I!=DATA.end() && xr_strcmp(*(*I)->Name,section)==0))
+	Sect*	I = find_section(section);
+	if (!I)
 		Debug.fatal(DEBUG_INFO,"Can't open section '%s'",S);
-	return	**I;
+	return	*I;
 }
 
 LPCSTR	CInifile::r_string(LPCSTR S, LPCSTR L)
 {
 	Sect&	I = r_section(S);
-	SectCIt	A = std::lower_bound(I.Data.begin(),I.Data.end(),L,item_pred);
-	if (A!=I.Data.end() && xr_strcmp(*A->first,L)==0)	return *A->second;
+	const Item*	A = I.find(L);
+	if (A)	return *A->second;
 	else
 		Debug.fatal(DEBUG_INFO,"Can't find variable %s in [%s]",L,S);
 	return 0;
@@ -512,8 +706,7 @@ void	CInifile::w_string	( LPCSTR S, LPCSTR L, LPCSTR			V, LPCSTR comment)
 		// create _new_ section
 		Sect			*NEW = xr_new<Sect>();
 		NEW->Name		= sect;
-		RootIt I		= std::lower_bound(DATA.begin(),DATA.end(),sect,sect_pred);
-		DATA.insert		(I,NEW);
+		insert_section	(NEW);
 	}
 
 	// parse line/value
@@ -540,6 +733,7 @@ void	CInifile::w_string	( LPCSTR S, LPCSTR L, LPCSTR			V, LPCSTR comment)
     } else {
 		data.Data.insert(it,I);
     }
+	data.build_index	();
 }
 void	CInifile::w_u8			( LPCSTR S, LPCSTR L, u8				V, LPCSTR comment )
 {
@@ -637,6 +831,7 @@ void	CInifile::remove_line	( LPCSTR S, LPCSTR L )
 		SectIt_ A = std::lower_bound(data.Data.begin(),data.Data.end(),L,item_pred);
     	R_ASSERT(A!=data.Data.end() && xr_strcmp(*A->first,L)==0);
         data.Data.erase(A);
+		data.build_index	();
     }
 }
 
@@ -7,6 +7,13 @@ extern XRCORE_API u32		rtc_compress	(void *dst, u32 dst_len, const void* src, u3
 extern XRCORE_API u32		rtc_decompress	(void *dst, u32 dst_len, const void* src, u32 src_len);
 extern XRCORE_API u32		rtc_csize		(u32 in);
 
+// chunked container, decompression may be limited to [offset..offset+size) of the source
+extern XRCORE_API u32		rtcc_compress	(void *dst, u32 dst_len, const void* src, u32 src_len);
+extern XRCORE_API u32		rtcc_decompress	(void *dst, u32 dst_len, const void* src, u32 src_len, u32 offset=0, u32 size=u32(-1));
+extern XRCORE_API u32		rtcc_csize		(u32 in);
+extern XRCORE_API BOOL		rtcc_test		(const void* src, u32 src_len);
+extern XRCORE_API u32		rtcc_size		(const void* src);
+
 extern XRCORE_API void      rtc9_initialize	();
 extern XRCORE_API void      rtc9_uninitialize	();
 extern XRCORE_API u32       rtc9_compress   (void *dst, u32 dst_len, const void* src, u32 src_len);
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+// Framed container of independently compressed rtc (LZO) chunks:
+//		header, u32 compressed size of every chunk, chunks back to back
+// Chunks are decompressed in parallel, any range of the source can be unpacked
+// without touching the rest.
+
+#define RTCC_MAGIC		u32(0x43435452)		// 'RTCC'
+#define RTCC_CHUNK		u32(256*1024)
+
+struct	rtcc_header
+{
+	u32			magic;
+	u32			raw_size;
+	u32			chunk_size;
+	u32			chunk_count;
+};
+
+IC	u32			rtcc_chunks		(u32 in)	{ return (in+RTCC_CHUNK-1)/RTCC_CHUNK;	}
+
+u32		rtcc_csize		(u32 in)
+{
+	VERIFY			(in);
+	return			sizeof(rtcc_header) + rtcc_chunks(in)*(sizeof(u32) + rtc_csize(RTCC_CHUNK));
+}
+
+BOOL	rtcc_test		(const void* src, u32 src_len)
+{
+	if (src_len<sizeof(rtcc_header))	return FALSE;
+	const rtcc_header*	H	= (const rtcc_header*)src;
+	if (H->magic!=RTCC_MAGIC)			return FALSE;
+	if (0==H->chunk_size)				return FALSE;
+	if (H->chunk_count!=(H->raw_size+H->chunk_size-1)/H->chunk_size)	return FALSE;
+	return			(src_len >= sizeof(rtcc_header) + H->chunk_count*sizeof(u32));
+}
+
+u32		rtcc_size		(const void* src)
+{
+	return			((const rtcc_header*)src)->raw_size;
+}
+
+struct	rtcc_task
+{
+	u8*				dst;
+	const u8*		src;
+	u32				raw_size;
+	u32				chunk_size;
+	u32*			sizes;			// compressed
+	u32*			offsets;		// compressed
+	u32				first;			// chunk
+
+	void __stdcall	decompress		(u32 begin, u32 end, u32 worker_id)
+	{
+		for (u32 it=first+begin; it<first+end; it++)	{
+			u32		raw		= _min(chunk_size,raw_size-it*chunk_size);
+			u32		size	= rtc_decompress(dst+it*chunk_size,raw,src+offsets[it],sizes[it]);
+			R_ASSERT2		(size==raw,"Corrupted compressed chunk");
+		}
+	}
+};
+
+u32		rtcc_compress	(void *dst, u32 dst_len, const void* src, u32 src_len)
+{
+	R_ASSERT		(dst_len>=rtcc_csize(src_len));
+	rtcc_header*	H	= (rtcc_header*)dst;
+	H->magic			= RTCC_MAGIC;
+	H->raw_size			= src_len;
+	H->chunk_size		= RTCC_CHUNK;
+	H->chunk_count		= rtcc_chunks(src_len);
+
+	// on the calling thread: the saves are packed on the background save thread, a batch on
+	// WorkerPool would turn the frame's parallel work serial until the save is done
+	u32*			sizes	= (u32*)(H+1);
+	u8*				data	= (u8*)(sizes+H->chunk_count);
+	u32				pos		= 0;
+	for (u32 it=0; it<H->chunk_count; it++)	{
+		u32			raw		= _min(RTCC_CHUNK,src_len-it*RTCC_CHUNK);
+		sizes[it]			= rtc_compress(data+pos,rtc_csize(RTCC_CHUNK),(const u8*)src+it*RTCC_CHUNK,raw);
+		pos					+= sizes[it];
+	}
+	return			u32(data+pos-(u8*)dst);
+}
+
+u32		rtcc_decompress	(void *dst, u32 dst_len, const void* src, u32 src_len, u32 offset, u32 size)
+{
+	R_ASSERT2		(rtcc_test(src,src_len),"Invalid compressed container");
+	const rtcc_header*	H	= (const rtcc_header*)src;
+	R_ASSERT		(dst_len>=H->raw_size);
+	if (0==H->raw_size)					return 0;
+	if (offset>=H->raw_size)			return 0;
+	size				= _min(size,H->raw_size-offset);
+	if (0==size)						return 0;
+
+	u32*			sizes	= (u32*)(H+1);
+	const u8*		data	= (const u8*)(sizes+H->chunk_count);
+	xr_vector<u32>	offsets	(H->chunk_count);
+	u32				pos		= 0;
+	for (u32 it=0; it<H->chunk_count; it++)	{
+		offsets[it]			= pos;
+		pos					+= sizes[it];
+	}
+	R_ASSERT2		(data+pos<=(const u8*)src+src_len,"Truncated compressed container");
+
+	// only the chunks covering the range
+	u32				first	= offset/H->chunk_size;
+	u32				last	= (offset+size-1)/H->chunk_size;
+	rtcc_task		task	= { (u8*)dst, data, H->raw_size, H->chunk_size, sizes, &*offsets.begin(), first };
+	WorkerPool.parallel_for	(last-first+1,1,CWorkerPool::range_callback(&task,&rtcc_task::decompress));
+	return			H->raw_size;
+}
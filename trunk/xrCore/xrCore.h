@@ -246,6 +246,7 @@ DEFINE_VECTOR	(xr_rtoken,RTokenVec,RTokenVecIt);
 #include "FileSystem.h"
 #include "FTimer.h"
 #include "fastdelegate.h"
+#include "xrWorkerPool.h"
 #include "intrusive_ptr.h"
 
 // destructor
@@ -0,0 +1,126 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+#include "xrWorkerPool.h"
+
+XRCORE_API CWorkerPool	WorkerPool;
+
+CWorkerPool::CWorkerPool	()
+{
+	m_count					= 0;
+	m_state					= 0;
+	m_busy					= 0;
+	m_exit					= 0;
+	m_active				= 0;
+	m_start					= 0;
+	m_done					= 0;
+	m_size					= 0;
+	m_grain					= 1;
+	m_next					= 0;
+}
+
+CWorkerPool::~CWorkerPool	()
+{
+	// threads are already gone at this point (process shutdown), just release handles
+	if (m_start)			CloseHandle	(m_start);
+	if (m_done)				CloseHandle	(m_done);
+}
+
+void CWorkerPool::initialize	()
+{
+	if (2==m_state)			return;
+	if (0!=InterlockedCompareExchange(&m_state,1,0))	{
+		while (2!=m_state)	Sleep(0);
+		return;
+	}
+
+	SYSTEM_INFO				info;
+	GetSystemInfo			(&info);
+	u32	count				= info.dwNumberOfProcessors ? info.dwNumberOfProcessors-1 : 0;
+	if (strstr(Core.Params,"-noworkers"))	count = 0;
+	clamp					(count,u32(0),u32(max_workers));
+
+	m_start					= CreateSemaphore	(NULL,0,max_workers,NULL);
+	m_done					= CreateEvent		(NULL,FALSE,FALSE,NULL);
+	for (u32 it=0; it<count; ++it)	{
+		m_workers[it].pool	= this;
+		m_workers[it].id	= it+1;
+		thread_spawn		(worker_entry,"X-RAY Worker thread",0,&m_workers[it]);
+	}
+	m_count					= count;
+	Msg						("* Worker pool: %d thread(s)",m_count);
+	InterlockedExchange		(&m_state,2);
+}
+
+void CWorkerPool::_destroy		()
+{
+	if (2!=m_state)			return;
+	if (m_count)	{
+		InterlockedExchange	(&m_exit,1);
+		InterlockedExchange	(&m_active,m_count);
+		ReleaseSemaphore	(m_start,m_count,NULL);
+		WaitForSingleObject	(m_done,INFINITE);
+	}
+	CloseHandle				(m_start);	m_start	= 0;
+	CloseHandle				(m_done);	m_done	= 0;
+	m_count					= 0;
+	m_exit					= 0;
+	InterlockedExchange		(&m_state,0);
+}
+
+void CWorkerPool::worker_entry	(void* P)
+{
+	worker*			W		= (worker*)P;
+	CWorkerPool*	pool	= W->pool;
+	for (;;)	{
+		WaitForSingleObject	(pool->m_start,INFINITE);
+		if (!pool->m_exit)	pool->process	(W->id);
+		BOOL	bExit		= pool->m_exit;
+		if (0==InterlockedDecrement(&pool->m_active))	SetEvent(pool->m_done);
+		if (bExit)			break;
+	}
+}
+
+void CWorkerPool::process		(u32 worker_id)
+{
+	for (;;)	{
+		u32	begin			= u32(InterlockedExchangeAdd(&m_next,long(m_grain)));
+		if (begin>=m_size)	break;
+		u32	end				= _min(begin+m_grain,m_size);
+		m_callback			(begin,end,worker_id);
+	}
+}
+
+u32 CWorkerPool::workers		()
+{
+	initialize				();
+	return					m_count+1;
+}
+
+void CWorkerPool::parallel_for	(u32 size, u32 grain, const range_callback& callback)
+{
+	if (0==size)			return;
+	if (0==grain)			grain	= 1;
+	initialize				();
+
+	u32	pieces				= (size+grain-1)/grain;
+	if ((pieces<2) || (0==m_count) || (0!=InterlockedCompareExchange(&m_busy,1,0)))	{
+		// serial: tiny batch, no workers, pool busy or nested call
+		callback			(0,size,0);
+		return;
+	}
+
+	m_callback				= callback;
+	m_size					= size;
+	m_grain					= grain;
+	m_next					= 0;
+
+	u32	wake				= _min(m_count,pieces-1);
+	InterlockedExchange		(&m_active,wake);
+	ReleaseSemaphore		(m_start,wake,NULL);
+	process					(0);
+	WaitForSingleObject		(m_done,INFINITE);
+
+	m_callback.clear		();
+	InterlockedExchange		(&m_busy,0);
+}
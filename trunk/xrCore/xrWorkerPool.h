@@ -0,0 +1,55 @@
+#ifndef xrWorkerPoolH
+#define xrWorkerPoolH
+#pragma once
+
+// Desc: fixed set of worker threads for fork-join 'parallel for' batches
+//		 The calling thread always takes part in the batch and the call returns only
+//		 when the whole range is processed. If the pool is already busy with a batch
+//		 issued from another thread (or the call is nested inside a batch), the range
+//		 is processed serially on the calling thread - so callers never block on each other.
+class XRCORE_API CWorkerPool
+{
+public:
+	typedef fastdelegate::FastDelegate3<u32,u32,u32>	range_callback;		// (begin, end, worker_id)
+	enum	{
+		max_workers				= 16
+	};
+private:
+	struct	worker
+	{
+		CWorkerPool*			pool;
+		u32						id;
+	};
+private:
+	worker						m_workers	[max_workers];
+	u32							m_count;									// spawned threads
+	volatile long				m_state;									// 0=none, 1=spawning, 2=ready
+	volatile long				m_busy;
+	volatile long				m_exit;
+	volatile long				m_active;									// threads not yet finished with current batch
+	void*						m_start;									// semaphore
+	void*						m_done;										// event
+
+	// current batch
+	range_callback				m_callback;
+	u32							m_size;
+	u32							m_grain;
+	volatile long				m_next;
+private:
+	static	void				worker_entry	(void* P);
+			void				process			(u32 worker_id);
+			void				initialize		();
+public:
+								CWorkerPool		();
+								~CWorkerPool	();
+			void				_destroy		();
+
+	// number of threads taking part in a batch (workers + caller), valid ids are [0..workers())
+			u32					workers			();
+	// splits [0..size) into pieces of 'grain' items and blocks until all of them are processed
+			void				parallel_for	(u32 size, u32 grain, const range_callback& callback);
+};
+
+extern XRCORE_API	CWorkerPool	WorkerPool;
+
+#endif // xrWorkerPoolH
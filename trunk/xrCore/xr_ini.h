@@ -32,25 +32,47 @@ public:
     struct XRCORE_API	Sect {
 		shared_str		Name;
 		Items			Data;
+		xr_vector<u32>	Index;		// open addressing hash of Data, empty while Data is being filled
 
 //.		IC SectCIt		begin()		{ return Data.begin();	}
 //.		IC SectCIt		end()		{ return Data.end();	}
 //.		IC size_t		size()		{ return Data.size();	}
 //.		IC void			clear()		{ Data.clear();			}
 	    BOOL			line_exist	(LPCSTR L, LPCSTR* val=0);
+		const Item*		find		(LPCSTR L) const;
+		void			build_index	();
 	};
 	typedef	xr_vector<Sect*>		Root;
 	typedef Root::iterator			RootIt;
 
 	// factorisation
 	static CInifile*	Create		( LPCSTR szFileName, BOOL ReadOnly=TRUE);
+	static CInifile*	Create_cached( LPCSTR szFileName, LPCSTR cache_name );	// read-only, from/to the binary cache
 	static void			Destroy		( CInifile*);
     static IC BOOL		IsBOOL		( LPCSTR B)	{ return (xr_strcmp(B,"on")==0 || xr_strcmp(B,"yes")==0 || xr_strcmp(B,"true")==0 || xr_strcmp(B,"1")==0);}
 private:
+	struct source
+	{
+		shared_str	name;
+		u32			size;
+		u32			crc;
+	};
+	typedef xr_vector<source>	Sources;
+
 	LPSTR		fName;
 	Root		DATA;
+	Root		INDEX;			// open addressing hash of DATA
 	BOOL		bReadOnly;
+	Sources*	m_sources;		// files read by Load, while building the cache
 	void		Load			(IReader* F, LPCSTR path);
+	void		load_file		();
+	IReader*	open_source		(LPCSTR fn);
+	Sect*		find_section	(LPCSTR S);
+	void		insert_section	(Sect* S);
+	void		index_sections	();
+	void		index_items		();
+	BOOL		load_cache		(LPCSTR cache_name);
+	void		save_cache		(LPCSTR cache_name);
 public:
     BOOL		bSaveAtEnd;
 public:
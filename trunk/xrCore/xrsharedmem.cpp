@@ -50,11 +50,26 @@ smem_value*			smem_container::dock			(u32 dwCRC, u32 dwLength, void* ptr)
 		container.insert		(saved_place,result);
 	}
 
+	// referenced under the lock, so the value can't be released in between
+	result->dwReference			++;
+
 	// exit
 	cs.Leave					();
 	return						result;
 }
 
+void				smem_container::release			(smem_value* value)
+{
+	cs.Enter					();
+	if (0==InterlockedDecrement((LONG*)&value->dwReference))	{
+		cdb::iterator	it		= std::lower_bound	(container.begin(),container.end(),value,smem_search);
+		while (*it!=value)		it++;
+		container.erase			(it);
+		xr_free					(value);
+	}
+	cs.Leave					();
+}
+
 void				smem_container::clean			()
 {
 	cs.Enter		();
@@ -46,7 +46,8 @@ private:
 	xrCriticalSection					cs;
 	cdb									container;
 public:
-	smem_value*			dock			(u32 dwCRC, u32 dwLength, void* ptr);
+	smem_value*			dock			(u32 dwCRC, u32 dwLength, void* ptr);	// the value is returned referenced
+	void				release			(smem_value* value);					// drops the reference, frees the value if it was the last one
 	void				clean			();
 	void				dump			();
 	u32					stat_economy	();
@@ -65,9 +66,9 @@ private:
 	smem_value*			p_;
 protected:
 	// ref-counting
-	void				_dec		()								{	if (0==p_) return;	p_->dwReference--; 	if (0==p_->dwReference)	p_=0;						}
+	void				_dec		()								{	if (0==p_) return;	if (0==InterlockedDecrement((LONG*)&p_->dwReference))	p_=0;		}
 public:
-	void				_set		(ref_smem const &rhs)			{	smem_value* v = rhs.p_; if (0!=v) v->dwReference++; _dec(); p_ = v;							}
+	void				_set		(ref_smem const &rhs)			{	smem_value* v = rhs.p_; if (0!=v) InterlockedIncrement((LONG*)&v->dwReference); _dec(); p_ = v;	}
 	const smem_value*	_get		()	const						{	return p_;																					}
 public:
 	// construction
@@ -78,8 +79,10 @@ public:
 	void				create		(u32 dwCRC, u32 dwLength, T* ptr)
 	{
 		smem_value* v	= g_pSharedMemoryContainer->dock(dwCRC,dwLength*sizeof(T),ptr); 
-		if (0!=v)		v->dwReference++; _dec(); p_ = v;	
+		_dec();			p_ = v;	
 	}
+	// unlike the assignment of an empty ref, gives the memory back at once
+	void				release		()								{	if (0==p_) return;	g_pSharedMemoryContainer->release(p_);	p_ = 0;	}
 
 	// assignment & accessors
 	ref_smem<T>&		operator=	(ref_smem<T> const &rhs)		{	_set(rhs);	return (ref_smem<T>&)*this;						}
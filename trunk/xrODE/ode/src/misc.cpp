@@ -27,36 +27,70 @@
 //****************************************************************************
 // random numbers
 
+// the seed is per thread: the islands are stepped on several threads at once.
+// A tls slot rather than __declspec(thread), the library is loaded at run time
+
+#ifdef _WIN32
+
+#include "windows.h"
+
+static DWORD seed_slot = TlsAlloc();
+
+static inline unsigned long get_seed()
+{
+  return (unsigned long) (size_t) TlsGetValue (seed_slot);
+}
+
+static inline void set_seed (unsigned long s)
+{
+  TlsSetValue (seed_slot,(LPVOID) (size_t) s);
+}
+
+#else
+
 static unsigned long seed = 0;
 
+static inline unsigned long get_seed()
+{
+  return seed;
+}
+
+static inline void set_seed (unsigned long s)
+{
+  seed = s;
+}
+
+#endif
+
 unsigned long dRand()
 {
-  seed = (1664525L*seed + 1013904223L) & 0xffffffff;
+  unsigned long seed = (1664525L*get_seed() + 1013904223L) & 0xffffffff;
+  set_seed (seed);
   return seed;
 }
 
 
 unsigned long  dRandGetSeed()
 {
-  return seed;
+  return get_seed();
 }
 
 
 void dRandSetSeed (unsigned long s)
 {
-  seed = s;
+  set_seed (s);
 }
 
 
 int dTestRand()
 {
-  unsigned long oldseed = seed;
+  unsigned long oldseed = get_seed();
   int ret = 1;
-  seed = 0;
+  set_seed (0);
   if (dRand() != 0x3c6ef35f || dRand() != 0x47502932 ||
       dRand() != 0xd1ccf6e9 || dRand() != 0xaaf95334 ||
       dRand() != 0x6252e503) ret = 0;
-  seed = oldseed;
+  set_seed (oldseed);
   return ret;
 }
 
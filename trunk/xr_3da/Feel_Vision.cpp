@@ -8,7 +8,7 @@
 
 namespace Feel {
 
-	Vision::Vision():pure_relcase(&Vision::feel_vision_relcase)
+	Vision::Vision()
 	{	
 	}
 	Vision::~Vision()
@@ -36,11 +36,15 @@ namespace Feel {
 		}
 		return (fp->vis>fp->vis_threshold); 
 	}
-	void	Vision::o_new		(CObject* O)
+	void	Vision::o_new		(u32 handle)
 	{
+		CObject*	O			= g_object_handles.resolve(handle);
+		if (0==O)				return;
+
 		feel_visible.push_back	(feel_visible_Item());
 		feel_visible_Item&	I	= feel_visible.back();
 		I.O						= O;
+		I.handle				= handle;
 		I.Cache_vis				= 1.f;
 		I.Cache.verts[0].set	(0,0,0);
 		I.Cache.verts[1].set	(0,0,0);
@@ -48,16 +52,27 @@ namespace Feel {
 		I.fuzzy					= -EPS_S;
 		I.cp_LP.set				(0,0,0);
 	}
-	void	Vision::o_delete	(CObject* O)
+	void	Vision::o_delete	(u32 handle)
 	{
 		xr_vector<feel_visible_Item>::iterator I=feel_visible.begin(),TE=feel_visible.end();
 		for (; I!=TE; I++)
-			if (I->O==O) {
+			if (I->handle==handle) {
 				feel_visible.erase(I);
 				return;
 			}
 	}
 
+	void	Vision::o_purge		()
+	{
+		// objects went to destroy since the last update
+		for (u32 it=0; it<feel_visible.size(); it++)
+		{
+			if (feel_visible[it].valid())	continue;
+			feel_visible.erase	(feel_visible.begin()+it);
+			it					--;
+		}
+	}
+
 	void	Vision::feel_vision_clear	()
 	{
 		seen.clear			();
@@ -66,19 +81,6 @@ namespace Feel {
 		feel_visible.clear	();
 	}
 
-	void	Vision::feel_vision_relcase	(CObject* object)
-	{
-		xr_vector<CObject*>::iterator Io;
-		Io = std::find		(seen.begin(),seen.end(),object);
-		if (Io!=seen.end())	seen.erase	(Io);
-		Io = std::find		(query.begin(),query.end(),object);
-		if (Io!=query.end())query.erase	(Io);
-		Io = std::find		(diff.begin(),diff.end(),object);
-		if (Io!=diff.end())	diff.erase	(Io);
-		xr_vector<feel_visible_Item>::iterator Ii=feel_visible.begin(),IiE=feel_visible.end();
-		for (; Ii!=IiE; ++Ii)if (Ii->O==object){ feel_visible.erase(Ii); break; }
-	}
-
 	void	Vision::feel_vision_query	(Fmatrix& mFull, Fvector& P)
 	{
 		CFrustum								Frustum		;
@@ -100,27 +102,29 @@ namespace Feel {
 		{
 			ISpatial*	spatial								= r_spatial					[o_it];
 			CObject*	object								= spatial->dcast_CObject	();
-			if (object && feel_vision_isRelevant(object))	seen.push_back				(object);
+			if (object && object->handle() && feel_vision_isRelevant(object))	seen.push_back	(object->handle());
 		}
 		if (seen.size()>1) 
 		{
 			std::sort							(seen.begin(),seen.end());
-			xr_vector<CObject*>::iterator end	= std::unique	(seen.begin(),seen.end());
+			xr_vector<u32>::iterator end		= std::unique	(seen.begin(),seen.end());
 			if (end!=seen.end()) seen.erase		(end,seen.end());
 		}
 	}
 
 	void	Vision::feel_vision_update	(CObject* parent, Fvector& P, float dt, float vis_threshold)
 	{
+		o_purge				();
+
 		// B-A = objects, that become visible
 		if (!seen.empty()) 
 		{
-			xr_vector<CObject*>::iterator E		= std::remove(seen.begin(),seen.end(),parent);
+			xr_vector<u32>::iterator E			= std::remove(seen.begin(),seen.end(),parent->handle());
 			seen.resize			(E-seen.begin());
 
 			{
 				diff.resize	(_max(seen.size(),query.size()));
-				xr_vector<CObject*>::iterator	E = std::set_difference(
+				xr_vector<u32>::iterator	E = std::set_difference(
 					seen.begin(), seen.end(),
 					query.begin(),query.end(),
 					diff.begin() );
@@ -134,7 +138,7 @@ namespace Feel {
 		if (!query.empty()) 
 		{
 			diff.resize	(_max(seen.size(),query.size()));
-			xr_vector<CObject*>::iterator	E = std::set_difference(
+			xr_vector<u32>::iterator	E = std::set_difference(
 				query.begin(),query.end(),
 				seen.begin(), seen.end(),
 				diff.begin() );
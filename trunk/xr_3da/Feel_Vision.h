@@ -2,7 +2,7 @@
 
 #include "xr_collide_defs.h"
 #include "render.h"
-#include "pure_relcase.h"
+#include "xr_object_handle.h"
 
 class IRender_Sector;
 class CObject;
@@ -15,17 +15,20 @@ namespace Feel
 	const float fuzzy_guaranteed	= 0.001f;		// distance which is supposed 100% visible
 	const float lr_granularity		= 0.1f;			// assume similar positions
 
-	class ENGINE_API Vision: private pure_relcase
+	// Objects are referenced by weak handles (see xr_object_handle.h) - the destroyed ones
+	// are dropped on the next update instead of by relcase callback
+	class ENGINE_API Vision
 	{
 	private:
-		xr_vector<CObject*>			seen;
-		xr_vector<CObject*>			query;
-		xr_vector<CObject*>			diff;
+		xr_vector<u32>				seen;		// handles, sorted
+		xr_vector<u32>				query;
+		xr_vector<u32>				diff;
 		collide::rq_results			RQR;
 		xr_vector<ISpatial*>		r_spatial;
 
-		void						o_new		(CObject* E);
-		void						o_delete	(CObject* E);
+		void						o_new		(u32 handle);
+		void						o_delete	(u32 handle);
+		void						o_purge		();
 		void						o_trace		(Fvector& P, float dt, float vis_threshold);
 	public:
 									Vision		();
@@ -34,27 +37,29 @@ namespace Feel
 		{
 			float				fuzzy;		// note range: (-1[no]..1[yes])
 			CObject*			O;
+			u32					handle;		// of O, the item is stale when invalid
 			collide::ray_cache	Cache;
 			float				Cache_vis;
 			Fvector				cp_LP;
 			Fvector				cp_LR_src;
 			Fvector				cp_LR_dst;
 			Fvector				cp_LAST;	// last point found to be visible
+
+			IC bool				valid		() const	{ return g_object_handles.valid(handle); }
 		};
 		xr_vector<feel_visible_Item>	feel_visible;
 	public:
 		void						feel_vision_clear		();
 		void						feel_vision_query		(Fmatrix& mFull,	Fvector& P);
 		void						feel_vision_update		(CObject* parent,	Fvector& P, float dt, float vis_threshold);
-		void	__stdcall			feel_vision_relcase		(CObject* object);
 		void						feel_vision_get			(xr_vector<CObject*>& R)		{
 			R.clear					();
 			xr_vector<feel_visible_Item>::iterator I=feel_visible.begin(),E=feel_visible.end();
-			for (; I!=E; I++)	if (positive(I->fuzzy)) R.push_back(I->O);
+			for (; I!=E; I++)	if (positive(I->fuzzy) && I->valid()) R.push_back(I->O);
 		}
 		Fvector						feel_vision_get_vispoint(CObject* _O)					{
 			xr_vector<feel_visible_Item>::iterator I=feel_visible.begin(),E=feel_visible.end();
-			for (; I!=E; I++)		if (_O == I->O) {
+			for (; I!=E; I++)		if ((_O == I->O) && I->valid()) {
 				VERIFY	(positive(I->fuzzy));
 				return	I->cp_LAST;
 			}
@@ -7,6 +7,8 @@ ISheduled::ISheduled	()
 	shedule.t_min		= 20;
 	shedule.t_max		= 1000;
 	shedule.b_locked	= FALSE;
+	shedule.b_MT		= FALSE;
+	shedule_slot		= u32(-1);
 #ifdef DEBUG
 	dbg_startframe		= 1;
 	dbg_update_shedule	= 0;
@@ -8,7 +8,9 @@ public:
 		u32		t_max		:	14;		// maximal bound of update time (sample: 200ms)
 		u32		b_RT		:	1;
 		u32		b_locked	:	1;
+		u32		b_MT		:	1;		// shedule_Update is thread-safe, may run in parallel with others
 	}	shedule;
+	u32									shedule_slot;		// handle in the sheduler
 
 #ifdef DEBUG
 	u32									dbg_startframe;
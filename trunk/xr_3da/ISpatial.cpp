@@ -3,6 +3,7 @@
 #include "render.h"
 #include "xr_object.h"
 #include "PS_Instance.h"
+#include "frustum.h"
 
 ENGINE_API ISpatial_DB*		g_SpatialSpace			= NULL;
 ENGINE_API ISpatial_DB*		g_SpatialSpacePhysic	= NULL;
@@ -27,6 +28,8 @@ ISpatial::ISpatial			(ISpatial_DB* space)
 	spatial.node_center.set	(0,0,0);
 	spatial.node_radius		= 0;
 	spatial.node_ptr		= NULL;
+	spatial.node_slot		= 0;
+	spatial.move_slot		= u32(-1);
 	spatial.sector			= NULL;
 	spatial.space			= space;
 }
@@ -94,8 +97,7 @@ void	ISpatial::spatial_move	()
 
 		//*** check if we are supposed to correct it's spatial location
 		if						(spatial_inside())	return;		// ???
-		spatial.space->remove	(this);
-		spatial.space->insert	(this);
+		spatial.space->move		(this);
 	} else {
 		//*** we are not registered yet, or already unregistered
 		//*** ignore request
@@ -121,16 +123,20 @@ void			ISpatial_NODE::_init			(ISpatial_NODE* _parent)
 void			ISpatial_NODE::_insert			(ISpatial* S)			
 {	
 	S->spatial.node_ptr			=	this;
+	S->spatial.node_slot		=	items.size();
 	items.push_back					(S);
 	S->spatial.space->stat_objects	++;
 }
 
 void			ISpatial_NODE::_remove			(ISpatial* S)			
 {	
+	u32		slot				=	S->spatial.node_slot;
+	VERIFY				(slot<items.size() && items[slot]==S);
 	S->spatial.node_ptr			=	NULL;
-	xr_vector<ISpatial*>::iterator	it = std::find(items.begin(),items.end(),S);
-	VERIFY				(it!=items.end());
-	items.erase			(it);
+	ISpatial*	last			=	items.back();
+	items[slot]					=	last;
+	last->spatial.node_slot		=	slot;
+	items.pop_back		();
 	S->spatial.space->stat_objects	--;
 }
 
@@ -144,6 +150,7 @@ ISpatial_DB::ISpatial_DB()
 	m_root					= NULL;
 	stat_nodes				= 0;
 	stat_objects			= 0;
+	stat_moved				= 0;
 }
 
 ISpatial_DB::~ISpatial_DB()
@@ -152,6 +159,7 @@ ISpatial_DB::~ISpatial_DB()
 		allocator.destroy		(allocator_pool.back());
 		allocator_pool.pop_back	();
 	}
+	if (m_root)	allocator.destroy	(m_root);
 }
 
 
@@ -246,7 +254,17 @@ void			ISpatial_DB::insert		(ISpatial* S)
 	cs.Enter			();
 #ifdef DEBUG
 	stat_insert.Begin	();
+#endif
+	_insert_object		(S);
+#ifdef DEBUG
+	stat_insert.End		();
+#endif
+	cs.Leave			();
+}
 
+void			ISpatial_DB::_insert_object	(ISpatial* S)
+{
+#ifdef DEBUG
 	BOOL		bValid	= _valid(S->spatial.sphere.R) && _valid(S->spatial.sphere.P);
 	if (!bValid)	
 	{
@@ -273,10 +291,6 @@ void			ISpatial_DB::insert		(ISpatial* S)
 		S->spatial.node_center.set	(m_center);
 		S->spatial.node_radius		=	m_bounds;
 	}
-#ifdef DEBUG
-	stat_insert.End		();
-#endif
-	cs.Leave			();
 }
 
 void			ISpatial_DB::_remove	(ISpatial_NODE* N, ISpatial_NODE* N_sub)
@@ -309,6 +323,10 @@ void			ISpatial_DB::remove		(ISpatial* S)
 #endif
 	ISpatial_NODE* N	= S->spatial.node_ptr;
 	N->_remove			(S);
+	if (u32(-1)!=S->spatial.move_slot)	{
+		moved[S->spatial.move_slot]	= NULL;
+		S->spatial.move_slot		= u32(-1);
+	}
 
 	// Recurse
 	if (N->_empty())					_remove(N->parent,N);
@@ -318,12 +336,135 @@ void			ISpatial_DB::remove		(ISpatial* S)
 	cs.Leave			();
 }
 
+void			ISpatial_DB::move		(ISpatial* S)
+{
+	cs.Enter			();
+	if (u32(-1)==S->spatial.move_slot)	{
+		S->spatial.move_slot	= moved.size();
+		moved.push_back			(S);
+	}
+	cs.Leave			();
+}
+
+// the items moved since the last call get their nodes in one go, a query always sees them relocated
+void			ISpatial_DB::_relocate	()
+{
+	if (moved.empty())	return;
+	stat_update.Begin	();
+	for (u32 it=0; it<moved.size(); ++it)
+	{
+		ISpatial*	S	= moved[it];
+		if (0==S)		continue;				// removed since
+		S->spatial.move_slot	= u32(-1);
+		if (S->spatial_inside())	continue;	// back in the node
+
+		// the old node is pruned after the insertion - the path is kept if the item stays close
+		ISpatial_NODE*	N	= S->spatial.node_ptr;
+		N->_remove		(S);
+		_insert_object	(S);
+		if (N->_empty())	_remove(N->parent,N);
+		stat_moved		++;
+	}
+	moved.clear_not_free();
+	stat_update.End		();
+}
+
 void			ISpatial_DB::update		(u32 nodes/* =8 */)
 {
-#ifdef DEBUG
 	if (0==m_root)	return;
 	cs.Enter		();
+	_relocate		();
 	VERIFY			(verify());
 	cs.Leave		();
-#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+class	spatial_bench_item	: public ISpatial
+{
+public:
+	spatial_bench_item		(ISpatial_DB* space) : ISpatial(space)	{}
+};
+
+void			ISpatial_DB::benchmark	(u32 count)
+{
+	// a private space with the items of the level scale: everything walks a bit each frame and
+	// a tenth of the items jumps far, the queries are issued around the items
+	ISpatial_DB		space;
+	Fbox			BB;		BB.set	(-1024,-1024,-1024,1024,1024,1024);
+	space.initialize		(BB);
+
+	CRandom			rnd		(0x2f1a);
+	xr_vector<ISpatial*>	items;
+	items.reserve			(count);
+	for (u32 it=0; it<count; it++)
+	{
+		ISpatial*	S		= xr_new<spatial_bench_item>(&space);
+		S->spatial.type		= STYPE_RENDERABLE|STYPE_COLLIDEABLE;
+		S->spatial.sphere.P.set	(rnd.randFs(900.f),rnd.randFs(50.f),rnd.randFs(900.f));
+		S->spatial.sphere.R	= rnd.randF(0.3f,6.f);
+		items.push_back		(S);
+	}
+
+	CTimer			T;
+	const u32		frames	= 16;
+	u32				found	= 0;
+	float			t_insert, t_move, t_update, t_sphere, t_frustum, t_remove;
+
+	T.Start					();
+	for (u32 it=0; it<count; it++)	items[it]->spatial_register	();
+	t_insert				= T.GetElapsed_sec()*1000.f;
+
+	t_move = t_update		= 0;
+	for (u32 f=0; f<frames; f++)
+	{
+		T.Start				();
+		for (u32 it=0; it<count; it++)
+		{
+			Fvector&	P	= items[it]->spatial.sphere.P;
+			if (0==rnd.randI(10))	P.set	(rnd.randFs(900.f),rnd.randFs(50.f),rnd.randFs(900.f));
+			else					P.add	(Fvector().set(rnd.randFs(0.5f),0,rnd.randFs(0.5f)));
+			items[it]->spatial_move	();
+		}
+		t_move				+= T.GetElapsed_sec()*1000.f;
+		T.Start				();
+		space.update		();
+		t_update			+= T.GetElapsed_sec()*1000.f;
+	}
+
+	xr_vector<ISpatial*>	R;
+	u32				queries	= _max(count/16,u32(1));
+	T.Start					();
+	for (u32 q=0; q<queries; q++)
+	{
+		space.q_sphere		(R,0,STYPE_COLLIDEABLE,items[q*count/queries]->spatial.sphere.P,10.f);
+		found				+= R.size();
+	}
+	t_sphere				= T.GetElapsed_sec()*1000.f;
+
+	Fmatrix			mProject,mView,mFull;
+	mProject.build_projection	(deg2rad(90.f),1.f,0.2f,300.f);
+	T.Start					();
+	for (u32 q=0; q<queries; q++)
+	{
+		Fvector		P		= items[q*count/queries]->spatial.sphere.P;
+		Fvector		D;		D.setHP	(rnd.randF(PI_MUL_2),0);
+		mView.build_camera_dir	(P,D,Fvector().set(0,1,0));
+		mFull.mul			(mProject,mView);
+		CFrustum	F;		F.CreateFromMatrix	(mFull,FRUSTUM_P_ALL);
+		space.q_frustum		(R,0,STYPE_RENDERABLE,F);
+		found				+= R.size();
+	}
+	t_frustum				= T.GetElapsed_sec()*1000.f;
+
+	T.Start					();
+	for (u32 it=0; it<count; it++)	items[it]->spatial_unregister	();
+	t_remove				= T.GetElapsed_sec()*1000.f;
+	for (u32 it=0; it<count; it++)	xr_delete	(items[it]);
+
+	Msg		("- spatial: %d items, %d nodes, %d found",count,space.stat_nodes,found);
+	Msg		("- insert  : %2.3fms",t_insert);
+	Msg		("- move    : %2.3fms, update %2.3fms, %d relocated in %d frames",t_move,t_update,space.stat_moved,frames);
+	Msg		("- sphere  : %2.3fms, %d queries",t_sphere,queries);
+	Msg		("- frustum : %2.3fms, %d queries",t_frustum,queries);
+	Msg		("- remove  : %2.3fms",t_remove);
 }
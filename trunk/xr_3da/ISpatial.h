@@ -24,6 +24,7 @@ Requirements:
 */
 
 const float						c_spatial_min	= 8.f;
+const u32						c_spatial_stack	= 64;	// nodes pending in the query walks, 1+7*depth of the tree
 //////////////////////////////////////////////////////////////////////////
 enum
 {
@@ -70,10 +71,12 @@ public:
 		Fvector					node_center;	// Cached node center for TBV optimization
 		float					node_radius;	// Cached node bounds for TBV optimization
 		ISpatial_NODE*			node_ptr;		// Cached parent node for "empty-members" optimization
+		u32						node_slot;		// index in node_ptr->items
+		u32						move_slot;		// index in the moved list of the space, u32(-1) - not moved
 		IRender_Sector*			sector;
 		ISpatial_DB*			space;			// allow different spaces
 
-		_spatial() : type(0)	{}				// safe way to enhure type is zero before any contstructors takes place
+		_spatial() : type(0), move_slot(u32(-1))	{}	// safe way to enhure type is zero before any contstructors takes place
 	}							spatial;
 public:
 	BOOL						spatial_inside		()			;
@@ -105,7 +108,7 @@ public:
 public:
 	ISpatial_NODE*				parent;					// parent node for "empty-members" optimization
 	ISpatial_NODE*				children		[8];	// children nodes
-	xr_vector<ISpatial*>		items;					// own items
+	xr_vector<ISpatial*>		items;					// own items, in no particular order
 public:
 	void						_init			(ISpatial_NODE* _parent);
 	void						_remove			(ISpatial*		_S);
@@ -131,6 +134,7 @@ private:
 	poolSS<ISpatial_NODE,128>		allocator;
 	xr_vector<ISpatial_NODE*>		allocator_pool;
 	ISpatial*						rt_insert_object;
+	xr_vector<ISpatial*>			moved;				// left their nodes, relocated before the next query or update
 public:
 	ISpatial_NODE*					m_root;
 	Fvector							m_center;
@@ -140,6 +144,8 @@ public:
 	u32								stat_objects;
 	CStatTimer						stat_insert;
 	CStatTimer						stat_remove;
+	CStatTimer						stat_update;		// relocation of the moved items
+	u32								stat_moved;
 private:
 	IC u32							_octant			(u32 x, u32 y, u32 z)			{	return z*4 + y*2 + x;	}
 	IC u32							_octant			(Fvector& base, Fvector& rel)
@@ -156,6 +162,8 @@ private:
 
 	void							_insert			(ISpatial_NODE* N, Fvector& n_center, float n_radius);
 	void							_remove			(ISpatial_NODE* N, ISpatial_NODE* N_sub);
+	void							_insert_object	(ISpatial* S);
+	void							_relocate		();
 public:
 	ISpatial_DB();
 	~ISpatial_DB();
@@ -165,8 +173,10 @@ public:
 	//void							destroy			();
 	void							insert			(ISpatial* S);
 	void							remove			(ISpatial* S);
+	void							move			(ISpatial* S);
 	void							update			(u32 nodes=8);
 	BOOL							verify			();
+	static void						benchmark		(u32 count);
 
 public:
 	enum
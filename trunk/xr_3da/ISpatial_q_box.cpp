@@ -6,12 +6,21 @@ extern Fvector	c_spatial_offset[8];
 template <bool b_first>
 class	walker
 {
+public:
+	struct	pending
+	{
+		ISpatial_NODE*	N;
+		Fvector			C;
+		float			R;
+		bool			inside;		// the node is inside the box
+	};
 public:
 	u32				mask;
 	Fvector			center;
 	Fvector			size;
 	Fbox			box;
 	ISpatial_DB*	space;
+	svector<pending,c_spatial_stack>	stack;
 public:
 	walker					(ISpatial_DB*	_space, u32 _mask, const Fvector& _center, const Fvector&	_size)
 	{
@@ -21,38 +30,64 @@ public:
 		box.setb(center,size);
 		space	= _space;
 	}
-	void		walk		(ISpatial_NODE* N, Fvector& n_C, float n_R)
+	IC void		push		(ISpatial_NODE* N, const Fvector& n_C, float n_R, bool inside)
 	{
-		// box
-		float	n_vR	=		2*n_R;
-		Fbox	BB;		BB.set	(n_C.x-n_vR, n_C.y-n_vR, n_C.z-n_vR, n_C.x+n_vR, n_C.y+n_vR, n_C.z+n_vR);
-		if		(!BB.intersect(box))			return;
-
-		// test items
-		xr_vector<ISpatial*>::iterator _it	=	N->items.begin	();
-		xr_vector<ISpatial*>::iterator _end	=	N->items.end	();
-		for (; _it!=_end; _it++)
+		stack.push_back		(pending());
+		pending&	P		= stack.back();
+		P.N					= N;
+		P.C					= n_C;
+		P.R					= n_R;
+		P.inside			= inside;
+	}
+	// the nodes are visited in the same order the recursive walk had; the items are within the loose
+	// bounds of their node, so all of them intersect the box when the node is inside it (but the root,
+	// it keeps the items outside of the space too)
+	void		walk		(ISpatial_NODE* root, Fvector& r_C, float r_R)
+	{
+		push				(root,r_C,r_R,false);
+		while (stack.size())
 		{
-			ISpatial*		S	= *_it;
-			if (0==(S->spatial.type&mask))	continue;
+			pending		P	=	stack.back();
+			stack.pop_back	();
+			ISpatial_NODE*	N	= P.N;
+			bool	inside	=	P.inside;
 
-			Fvector&		sC		= S->spatial.sphere.P;
-			float			sR		= S->spatial.sphere.R;
-			Fbox			sB;		sB.set	(sC.x-sR, sC.y-sR, sC.z-sR, sC.x+sR, sC.y+sR, sC.z+sR);
-			if (!sB.intersect(box))	continue;
+			// box
+			if (!inside)	{
+				float	n_vR	=		2*P.R;
+				Fbox	BB;		BB.set	(P.C.x-n_vR, P.C.y-n_vR, P.C.z-n_vR, P.C.x+n_vR, P.C.y+n_vR, P.C.z+n_vR);
+				if		(!BB.intersect(box))			continue;
+				inside			=		0!=box.contains(BB);
+			}
 
-			space->q_result->push_back	(S);
-			if (b_first)			return;
-		}
+			// test items
+			bool	test	=	!inside || !N->parent;
+			ISpatial**	_it		=	N->items.empty() ? 0 : &N->items.front();
+			ISpatial**	_end	=	_it + N->items.size();
+			for (; _it!=_end; _it++)
+			{
+				ISpatial*		S	= *_it;
+				if (0==(S->spatial.type&mask))	continue;
 
-		// recurse
-		float	c_R		= n_R/2;
-		for (u32 octant=0; octant<8; octant++)
-		{
-			if (0==N->children[octant])	continue;
-			Fvector		c_C;			c_C.mad	(n_C,c_spatial_offset[octant],c_R);
-			walk						(N->children[octant],c_C,c_R);
-			if (b_first && !space->q_result->empty())	return;
+				if (test)		{
+					Fvector&		sC		= S->spatial.sphere.P;
+					float			sR		= S->spatial.sphere.R;
+					Fbox			sB;		sB.set	(sC.x-sR, sC.y-sR, sC.z-sR, sC.x+sR, sC.y+sR, sC.z+sR);
+					if (!sB.intersect(box))	continue;
+				}
+
+				space->q_result->push_back	(S);
+				if (b_first)			return;
+			}
+
+			// children, the first octant goes on top
+			float	c_R		= P.R/2;
+			for (int octant=7; octant>=0; octant--)
+			{
+				if (0==N->children[octant])	continue;
+				Fvector		c_C;			c_C.mad	(P.C,c_spatial_offset[octant],c_R);
+				push						(N->children[octant],c_C,c_R,inside);
+			}
 		}
 	}
 };
@@ -60,6 +95,7 @@ public:
 void	ISpatial_DB::q_box			(xr_vector<ISpatial*>& R, u32 _o, u32 _mask, const Fvector& _center, const Fvector& _size)
 {
 	cs.Enter			();
+	_relocate			();
 	q_result			= &R;
 	q_result->clear_not_free		();
 	if (_o & O_ONLYFIRST)			{ walker<true>	W(this,_mask,_center,_size);	W.walk(m_root,m_center,m_bounds); } 
@@ -6,10 +6,19 @@ extern Fvector	c_spatial_offset[8];
 
 class	walker
 {
+public:
+	struct	pending
+	{
+		ISpatial_NODE*	N;
+		Fvector			C;
+		float			R;
+		u32				fmask;		// planes still to test, 0 - the node is inside
+	};
 public:
 	u32				mask;
 	CFrustum*		F;
 	ISpatial_DB*	space;
+	svector<pending,c_spatial_stack>	stack;
 public:
 	walker					(ISpatial_DB*	_space, u32 _mask, const CFrustum* _F)
 	{
@@ -17,36 +26,60 @@ public:
 		F		= (CFrustum*)_F;
 		space	= _space;
 	}
-	void		walk		(ISpatial_NODE* N, Fvector& n_C, float n_R, u32 fmask)
+	IC void		push		(ISpatial_NODE* N, const Fvector& n_C, float n_R, u32 fmask)
+	{
+		stack.push_back		(pending());
+		pending&	P		= stack.back();
+		P.N					= N;
+		P.C					= n_C;
+		P.R					= n_R;
+		P.fmask				= fmask;
+	}
+	// the nodes are visited in the same order the recursive walk had, the whole subtree of a node
+	// found inside the frustum is collected without the tests
+	void		walk		(ISpatial_NODE* root, Fvector& r_C, float r_R, u32 r_mask)
 	{
-		// box
-		float	n_vR	=		2*n_R;
-		Fbox	BB;		BB.set	(n_C.x-n_vR, n_C.y-n_vR, n_C.z-n_vR, n_C.x+n_vR, n_C.y+n_vR, n_C.z+n_vR);
-		if		(fcvNone==F->testAABB(BB.data(),fmask))	return;
-
-		// test items
-		xr_vector<ISpatial*>::iterator _it	=	N->items.begin	();
-		xr_vector<ISpatial*>::iterator _end	=	N->items.end	();
-		for (; _it!=_end; _it++)
+		push				(root,r_C,r_R,r_mask);
+		while (stack.size())
 		{
-			ISpatial*		S	= *_it;
-			if (0==(S->spatial.type&mask))	continue;
+			pending		P	=	stack.back();
+			stack.pop_back	();
+			ISpatial_NODE*	N	= P.N;
+			u32		fmask	=	P.fmask;
 
-			Fvector&		sC		= S->spatial.sphere.P;
-			float			sR		= S->spatial.sphere.R;
-			u32				tmask	= fmask;
-			if (fcvNone==F->testSphere(sC,sR,tmask))	continue;
+			// box
+			if (fmask)		{
+				float	n_vR	=		2*P.R;
+				Fbox	BB;		BB.set	(P.C.x-n_vR, P.C.y-n_vR, P.C.z-n_vR, P.C.x+n_vR, P.C.y+n_vR, P.C.z+n_vR);
+				if		(fcvNone==F->testAABB(BB.data(),fmask))	continue;
+			}
 
-			space->q_result->push_back	(S);
-		}
+			// test items
+			ISpatial**	_it		=	N->items.empty() ? 0 : &N->items.front();
+			ISpatial**	_end	=	_it + N->items.size();
+			for (; _it!=_end; _it++)
+			{
+				ISpatial*		S	= *_it;
+				if (0==(S->spatial.type&mask))	continue;
 
-		// recurse
-		float	c_R		= n_R/2;
-		for (u32 octant=0; octant<8; octant++)
-		{
-			if (0==N->children[octant])	continue;
-			Fvector		c_C;			c_C.mad	(n_C,c_spatial_offset[octant],c_R);
-			walk						(N->children[octant],c_C,c_R,fmask);
+				if (fmask)		{
+					Fvector&		sC		= S->spatial.sphere.P;
+					float			sR		= S->spatial.sphere.R;
+					u32				tmask	= fmask;
+					if (fcvNone==F->testSphere(sC,sR,tmask))	continue;
+				}
+
+				space->q_result->push_back	(S);
+			}
+
+			// children, the first octant goes on top
+			float	c_R		= P.R/2;
+			for (int octant=7; octant>=0; octant--)
+			{
+				if (0==N->children[octant])	continue;
+				Fvector		c_C;			c_C.mad	(P.C,c_spatial_offset[octant],c_R);
+				push						(N->children[octant],c_C,c_R,fmask);
+			}
 		}
 	}
 };
@@ -54,6 +87,7 @@ public:
 void	ISpatial_DB::q_frustum		(xr_vector<ISpatial*>& R, u32 _o, u32 _mask, const CFrustum& _frustum)	
 {
 	cs.Enter			();
+	_relocate			();
 	q_result			= &R;
 	q_result->clear_not_free();
 	walker				W(this,_mask,&_frustum); W.walk(m_root,m_center,m_bounds,_frustum.getMask()); 
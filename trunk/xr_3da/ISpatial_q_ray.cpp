@@ -268,6 +268,7 @@ public:
 void	ISpatial_DB::q_ray	(xr_vector<ISpatial*>& R, u32 _o, u32 _mask_and, const Fvector&	_start,  const Fvector&	_dir, float _range)
 {
 	cs.Enter						();
+	_relocate						();
 	q_result						= &R;
 	q_result->clear_not_free		();
 	if (CPU::ID.feature&_CPU_FEATURE_SSE)	{
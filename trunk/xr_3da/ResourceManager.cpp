@@ -25,6 +25,37 @@ void fix_texture_name(LPSTR fn)
 		0==stricmp(_ext,".ogm")	) )
 		*_ext = 0;
 }
+
+// the DDS texture_load reads for the texture, the bump maps generated from the base ones are skipped
+bool texture_find_dds(LPCSTR _name, string_path& fn)
+{
+	string_path				name;
+	strcpy_s				(name,_name);
+	fix_texture_name		(name);
+	if (!FS.exist(fn,"$game_textures$",name,".dds") && strstr(name,"_bump"))	return false;
+	if (FS.exist(fn,"$level$",			name,".dds"))	return true;
+	if (FS.exist(fn,"$game_saves$",		name,".dds"))	return true;
+	if (FS.exist(fn,"$game_textures$",	name,".dds"))	return true;
+	return					false;
+}
+
+#ifndef _EDITOR
+int					psTextureLoadParallel	= 1;
+static const u32	prefetch_batch			= 64*1024*1024;	// bytes of the texture files read ahead at once
+
+// the file CTexture::Load ends up reading, false - a video, a sequence or a generated texture
+static bool texture_prefetch_file(CTexture* T, string_path& fn, u32& size)
+{
+	LPCSTR	name		= *T->cName;
+	if (T->pSurface || 0==stricmp(name,"$null") || strstr(name,"$user$"))	return false;
+	if (FS.exist(fn,"$game_textures$",name,".ogm"))	return false;
+	if (FS.exist(fn,"$game_textures$",name,".avi"))	return false;
+	if (FS.exist(fn,"$game_textures$",name,".seq"))	return false;
+	if (!texture_find_dds(name,fn))					return false;
+	size				= FS.exist(fn)->size_real;
+	return	true;
+}
+#endif
 //--------------------------------------------------------------------------------------------------------------
 template <class T>
 BOOL	reclaim		(xr_vector<T*>& vec, const T* ptr)
@@ -262,13 +293,82 @@ void CResourceManager::Delete(const Shader* S)
 	Msg	("! ERROR: Failed to find complete shader");
 }
 
+void	CResourceManager::_PrefetchTextures_MT	(u32 begin, u32 end, u32 worker_id)
+{
+	for (u32 it=begin; it<end; ++it)
+	{
+		texture_prefetch&	P	= m_prefetch[it];
+		if (P.file[0])		P.data	= FS.r_open(P.file);
+	}
+}
+
+IReader*	CResourceManager::_OpenTexture		(LPCSTR fn)
+{
+	texture_prefetch*	P	= m_prefetch_current;
+	if (P && P->data && 0==xr_strcmp(P->file,fn))
+	{
+		IReader*	R		= P->data;
+		P->data				= 0;
+		return		R;
+	}
+	return		FS.r_open	(fn);
+}
+
 void	CResourceManager::DeferredUpload	()
 {
 	if (!Device.b_is_Ready)				return;
+	CTimer	T;		T.Start				();
+
+	// loading may register the generated textures (and drop them), the registry is reordered then
+	xr_vector<CTexture*>	textures;
+	textures.reserve		(m_textures.size());
 	for (map_TextureIt t=m_textures.begin(); t!=m_textures.end(); t++)
+		textures.push_back	(t->second);
+	u32		count	= textures.size		();
+#ifndef _EDITOR
+	if (psTextureLoadParallel)
 	{
-		t->second->Load();
+		// the files (and the decompression of the archived ones) are read on the workers a batch
+		// at a time, the surfaces are created here in the same order as before
+		u32		read	= 0;
+		for (u32 from=0; from<count; )
+		{
+			u32		bytes	= 0;
+			m_prefetch.clear_not_free	();
+			for (; from<count && bytes<prefetch_batch; ++from)
+			{
+				texture_prefetch	P;
+				P.texture		= textures[from];
+				P.size			= 0;
+				P.data			= 0;
+				if (!texture_prefetch_file(P.texture,P.file,P.size))	P.file[0] = 0;
+				bytes			+= P.size;
+				m_prefetch.push_back	(P);
+			}
+
+			FS.lock_rescan				();
+			WorkerPool.parallel_for		(m_prefetch.size(),1,CWorkerPool::range_callback(this,&CResourceManager::_PrefetchTextures_MT));
+			FS.unlock_rescan			();
+
+			for (u32 it=0; it<m_prefetch.size(); ++it)
+			{
+				texture_prefetch&	P	= m_prefetch[it];
+				bool	ahead			= 0!=P.data;
+				m_prefetch_current		= &P;
+				P.texture->Load			();
+				if (P.data)				FS.r_close(P.data);		// not the file the texture was loaded from
+				else if (ahead)			++read;
+			}
+			m_prefetch_current			= 0;
+		}
+		m_prefetch.clear				();
+		Msg		("* [textures] upload: %d (%d read ahead), %d ms",count,read,T.GetElapsed_ms());
+		return;
 	}
+#endif
+	for (u32 it=0; it<count; ++it)
+		textures[it]->Load		();
+	Msg			("* [textures] upload: %d, %d ms",count,T.GetElapsed_ms());
 }
 /*
 void	CResourceManager::DeferredUnload	()
@@ -9,6 +9,10 @@
 #include	"shader.h"
 #include	"tss_def.h"
 #include	"TextureDescrManager.h"
+#include	"ResourceRegistry.h"
+#ifndef _EDITOR
+#include	"TextureStreaming.h"
+#endif
 // refs
 struct		lua_State;
 
@@ -24,15 +28,21 @@ private:
 		const char*			T;
 		R_constant_setup*	cs;
 	};
+	struct texture_prefetch	{
+		CTexture*			texture;
+		string_path			file;		// empty - loaded as before
+		u32					size;
+		IReader*			data;		// read ahead, taken by _OpenTexture
+	};
 public:
 	DEFINE_MAP_PRED(const char*,IBlender*,		map_Blender,	map_BlenderIt,		str_pred);
-	DEFINE_MAP_PRED(const char*,CTexture*,		map_Texture,	map_TextureIt,		str_pred);
-	DEFINE_MAP_PRED(const char*,CMatrix*,		map_Matrix,		map_MatrixIt,		str_pred);
-	DEFINE_MAP_PRED(const char*,CConstant*,		map_Constant,	map_ConstantIt,		str_pred);
-	DEFINE_MAP_PRED(const char*,CRT*,			map_RT,			map_RTIt,			str_pred);
-	DEFINE_MAP_PRED(const char*,CRTC*,			map_RTC,		map_RTCIt,			str_pred);
-	DEFINE_MAP_PRED(const char*,SVS*,			map_VS,			map_VSIt,			str_pred);
-	DEFINE_MAP_PRED(const char*,SPS*,			map_PS,			map_PSIt,			str_pred);
+	typedef resource_registry<CTexture>			map_Texture;	typedef map_Texture::iterator	map_TextureIt;
+	typedef resource_registry<CMatrix>			map_Matrix;		typedef map_Matrix::iterator	map_MatrixIt;
+	typedef resource_registry<CConstant>		map_Constant;	typedef map_Constant::iterator	map_ConstantIt;
+	typedef resource_registry<CRT>				map_RT;			typedef map_RT::iterator		map_RTIt;
+	typedef resource_registry<CRTC>				map_RTC;		typedef map_RTC::iterator		map_RTCIt;
+	typedef resource_registry<SVS>				map_VS;			typedef map_VS::iterator		map_VSIt;
+	typedef resource_registry<SPS>				map_PS;			typedef map_PS::iterator		map_PSIt;
 	DEFINE_MAP_PRED(const char*,texture_detail,	map_TD,			map_TDIt,			str_pred);
 private:
 	// data
@@ -62,9 +72,16 @@ private:
 	xr_vector<Shader*>									v_shaders;
 	
 	xr_vector<ref_texture>								m_necessary;
+
+	// texture files read ahead by DeferredUpload
+	xr_vector<texture_prefetch>							m_prefetch;
+	texture_prefetch*									m_prefetch_current;
 	// misc
 public:
 	CTextureDescrMngr									m_textures_description;
+#ifndef _EDITOR
+	CTextureStreaming									m_textures_streaming;
+#endif
 //.	CInifile*											m_textures_description;
 	xr_vector<std::pair<shared_str,R_constant_setup*> >	v_constant_setup;
 	lua_State*											LSVM;
@@ -72,6 +89,7 @@ public:
 private:
 	void							LS_Load				();
 	void							LS_Unload			();
+	void	__stdcall				_PrefetchTextures_MT(u32 begin, u32 end, u32 worker_id);
 public:
 	// Miscelaneous
 	void							_ParseList			(sh_list& dest, LPCSTR names);
@@ -98,6 +116,7 @@ public:
 	// Low level resource creation
 	CTexture*						_CreateTexture		(LPCSTR Name);
 	void							_DeleteTexture		(const CTexture* T);
+	IReader*						_OpenTexture		(LPCSTR fn);		// the file of the texture being loaded, read ahead if possible
 
 	CMatrix*						_CreateMatrix		(LPCSTR Name);
 	void							_DeleteMatrix		(const CMatrix*  M);
@@ -147,7 +166,7 @@ public:
 	Shader*							_lua_Create			(LPCSTR		s_shader,	LPCSTR s_textures);
 	BOOL							_lua_HasShader		(LPCSTR		s_shader);
 
-	CResourceManager						()	: bDeferredLoad(TRUE)/*, m_description(0)*/	{	}
+	CResourceManager						()	: bDeferredLoad(TRUE), m_prefetch_current(0)/*, m_description(0)*/	{	}
 	~CResourceManager						()	;
 
 	void			OnDeviceCreate			(IReader* F);
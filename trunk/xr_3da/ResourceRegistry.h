@@ -0,0 +1,105 @@
+#ifndef ResourceRegistryH
+#define ResourceRegistryH
+#pragma once
+
+// Named resources of the manager: the items are kept dense (in no particular order) and chained
+// into buckets by the crc of the name, so a lookup compares the names of the same hash only.
+// The key is the interned name of the resource (set_name), the iterators are the ones of the
+// dense storage and are invalidated by insert/erase.
+template <class T>
+class resource_registry
+{
+public:
+	typedef std::pair<const char*,T*>				value_type;
+	typedef xr_vector<value_type>					storage;
+	typedef typename storage::iterator				iterator;
+	typedef typename storage::const_iterator		const_iterator;
+private:
+	enum	{
+		min_buckets		= 64,
+	};
+	storage					m_items;
+	xr_vector<u32>			m_hash;			// of the item names
+	xr_vector<u32>			m_next;			// chain, u32(-1) - last
+	xr_vector<u32>			m_buckets;		// first item, u32(-1) - empty
+private:
+	static IC u32			hash			(const char* name)	{ return crc32(name,xr_strlen(name));	}
+	IC u32					bucket			(u32 h) const		{ return h&(m_buckets.size()-1);		}
+
+	// the link pointing to the item
+	u32*					link			(u32 id)
+	{
+		u32*	L			= &m_buckets[bucket(m_hash[id])];
+		while (*L!=id)		L	= &m_next[*L];
+		return	L;
+	}
+	void					rehash			(u32 count)
+	{
+		m_buckets.assign	(count,u32(-1));
+		for (u32 id=0; id<m_items.size(); ++id)
+		{
+			u32&	head	= m_buckets[bucket(m_hash[id])];
+			m_next[id]		= head;
+			head			= id;
+		}
+	}
+public:
+							resource_registry	()				{ m_buckets.assign(min_buckets,u32(-1));	}
+
+	IC iterator				begin			()					{ return m_items.begin();	}
+	IC iterator				end				()					{ return m_items.end();		}
+	IC const_iterator		begin			() const			{ return m_items.begin();	}
+	IC const_iterator		end				() const			{ return m_items.end();		}
+	IC u32					size			() const			{ return m_items.size();	}
+	IC bool					empty			() const			{ return m_items.empty();	}
+	IC value_type&			operator[]		(u32 id)			{ return m_items[id];		}
+
+	iterator				find			(const char* name)
+	{
+		u32		h			= hash(name);
+		for (u32 id=m_buckets[bucket(h)]; id!=u32(-1); id=m_next[id])
+			if (m_hash[id]==h && 0==xr_strcmp(m_items[id].first,name))	return m_items.begin()+id;
+		return	m_items.end	();
+	}
+	void					insert			(const value_type& v)
+	{
+		VERIFY				(find(v.first)==end());
+		u32		h			= hash(v.first);
+		m_items.push_back	(v);
+		m_hash.push_back	(h);
+		m_next.push_back	(u32(-1));
+		if (m_items.size()>m_buckets.size())	{
+			rehash			(m_buckets.size()*2);
+			return;
+		}
+		u32		id			= m_items.size()-1;
+		u32&	head		= m_buckets[bucket(h)];
+		m_next[id]			= head;
+		head				= id;
+	}
+	// the last item takes the place of the erased one
+	void					erase			(iterator it)
+	{
+		u32		id			= u32(it-m_items.begin());
+		u32		last		= m_items.size()-1;
+		*link(id)			= m_next[id];
+		if (id!=last)		{
+			*link(last)		= id;
+			m_items[id]		= m_items[last];
+			m_hash[id]		= m_hash[last];
+			m_next[id]		= m_next[last];
+		}
+		m_items.pop_back	();
+		m_hash.pop_back		();
+		m_next.pop_back		();
+	}
+	void					clear			()
+	{
+		m_items.clear		();
+		m_hash.clear		();
+		m_next.clear		();
+		m_buckets.assign	(min_buckets,u32(-1));
+	}
+};
+
+#endif
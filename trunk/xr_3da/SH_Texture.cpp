@@ -35,6 +35,9 @@ CTexture::CTexture		()
 	flags.bUser			= false;
 	flags.seqCycles		= FALSE;
 	m_material			= 1.0f;
+	m_stream			= u32(-1);
+	m_stream_frame		= u32(-1);
+	m_stream_size		= 0;
 	bind				= fastdelegate::FastDelegate1<u32>(this,&CTexture::apply_load);
 }
 
@@ -60,6 +63,13 @@ IDirect3DBaseTexture9*	CTexture::surface_get	()
 	return pSurface;
 }
 
+#ifndef _EDITOR
+void					CTexture::stream_register	()
+{
+	Device.Resources->m_textures_streaming.add	(this);
+}
+#endif
+
 void CTexture::PostLoad	()
 {
 	if (pTheora)				bind		= fastdelegate::FastDelegate1<u32>(this,&CTexture::apply_theora);
@@ -290,6 +300,9 @@ void CTexture::Unload	()
 //.	if (flags.bLoaded)		Msg		("* Unloaded: %s",cName.c_str());
 	
 	flags.bLoaded			= FALSE;
+#ifndef _EDITOR
+	if (u32(-1)!=m_stream)	Device.Resources->m_textures_streaming.remove(this);
+#endif
 	if (!seqDATA.empty())	{
 		for (u32 I=0; I<seqDATA.size(); I++)
 		{
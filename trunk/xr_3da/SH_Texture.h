@@ -33,6 +33,11 @@ public:
 	// Sequence data
 	xr_vector<IDirect3DBaseTexture9*>	seqDATA;
 
+	// Streaming: the largest screen-space size (radius/distance) of the use in the main view
+	u32									m_stream;			// entry, u32(-1) - not registered
+	u32									m_stream_frame;
+	float								m_stream_size;
+
 	// Description
 	IDirect3DBaseTexture9*				desc_cache;
 	D3DSURFACE_DESC						desc;
@@ -55,6 +60,16 @@ public:
 	void								surface_set		(IDirect3DBaseTexture9* surf);
 	IDirect3DBaseTexture9*				surface_get 	();
 
+	void								stream_register	();
+	IC void								stream_usage	(float size, u32 frame)
+	{
+		if (m_stream_frame!=frame)		{
+			if (u32(-1)==m_stream)		stream_register	();
+			m_stream_frame				= frame;
+			m_stream_size				= size;
+		} else if (size>m_stream_size)	m_stream_size	= size;
+	}
+
 	IC BOOL								isUser			()		{ return flags.bUser;					}
 	IC u32								get_Width		()		{ desc_enshure(); return desc.Width;	}
 	IC u32								get_Height		()		{ desc_enshure(); return desc.Height;	}
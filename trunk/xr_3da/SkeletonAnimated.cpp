@@ -192,6 +192,7 @@ void CKinematicsAnimated::IBlendSetup(CBlend& B,u16 part,u8 channel, MotionID mo
 	B.motionID		= motion_ID;
 	B.timeCurrent	= 0;
 	B.timeTotal	= m_Motions[B.motionID.slot].bone_motions[LL_GetBoneRoot()]->at(motion_ID.idx).GetLength();
+	m_Motions[B.motionID.slot].motions.touch(motion_ID.idx);
 	B.bone_or_part	= part;
 	B.stop_at_end	= noloop;
 	B.playing		= TRUE;
@@ -212,6 +213,7 @@ void CKinematicsAnimated::IFXBlendSetup(CBlend &B, MotionID motion_ID, float ble
 	B.motionID		= motion_ID;
 	B.timeCurrent	= 0;
 	B.timeTotal	= m_Motions[B.motionID.slot].bone_motions[bone]->at(motion_ID.idx).GetLength();
+	m_Motions[B.motionID.slot].motions.touch(motion_ID.idx);
 	B.bone_or_part	= bone;
 
 	B.playing		= TRUE;
@@ -608,7 +610,7 @@ void CKinematicsAnimated::Load(const char* N, IReader *data, u32 dwFlags)
             if( !g_pMotionsContainer->has(nm) ) //optimize fs operations
 			{
 				IReader* MS						= FS.r_open(fn);
-				m_Motions.back().motions.create	(nm,MS,bones);
+				m_Motions.back().motions.create	(nm,MS,bones,fn);
 				FS.r_close						(MS);
 			}
 			m_Motions.back().motions.create	(nm,NULL,bones);
@@ -692,111 +694,15 @@ ICF float smooth(float x)
     return ((s*pow(_abs(x0),1.f/1.5f))+1.f)/2.f;
 }
 */
-IC	void QR2Quat(const CKeyQR &K,Fquaternion &Q)
-{
-	Q.x		= float(K.x)*KEY_QuantI;
-	Q.y		= float(K.y)*KEY_QuantI;
-	Q.z		= float(K.z)*KEY_QuantI;
-	Q.w		= float(K.w)*KEY_QuantI;
-}
-
-IC void QT2T(const CKeyQT& K,const CMotion& M,Fvector &T)
-{
-	T.x		= float(K.x)*M._sizeT.x+M._initT.x;
-	T.y		= float(K.y)*M._sizeT.y+M._initT.y;
-	T.z		= float(K.z)*M._sizeT.z+M._initT.z;
-}
-
 IC void Dequantize(CKey& K,const CBlend& BD,const CMotion& M)
 {
-	CKey*			D		=	&K;
-	const CBlend*	B		=	&BD;
-	float			time	=	B->timeCurrent*float(SAMPLE_FPS);
-
+	float			time	=	BD.timeCurrent*float(SAMPLE_FPS);
 	u32				frame	=	iFloor(time);
-	float			delta	=	time-float(frame);
-	u32				count	=	M.get_count();
-	// rotation
-	if (M.test_flag(flRKeyAbsent)){
-		const CKeyQR *		K		=	&M._keysR[0];
-		QR2Quat(*K,D->Q);
-	}else{
-		const CKeyQR*		K1r		=	&M._keysR[(frame+0)%count];
-		const CKeyQR*		K2r		=	&M._keysR[(frame+1)%count];
-		Fquaternion	Q1,Q2;
-		QR2Quat(*K1r,Q1);
-		QR2Quat(*K2r,Q2);
-		D->Q.slerp	(Q1,Q2,clampr(delta,0.f,1.f));
-	}
-
-	// translate
-	if (M.test_flag(flTKeyPresent))
-	{
-		const CKeyQT*	K1t	= &M._keysT[(frame+0)%count];
-		const CKeyQT*	K2t	= &M._keysT[(frame+1)%count];
-
-		Fvector T1,T2;
-		QT2T(*K1t,M,T1);
-		QT2T(*K2t,M,T2);
-		/*
-		T1.x		= float(K1t->x)*M._sizeT.x+M._initT.x;
-		T1.y		= float(K1t->y)*M._sizeT.y+M._initT.y;
-		T1.z		= float(K1t->z)*M._sizeT.z+M._initT.z;
-
-		T2.x		= float(K2t->x)*M._sizeT.x+M._initT.x;
-		T2.y		= float(K2t->y)*M._sizeT.y+M._initT.y;
-		T2.z		= float(K2t->z)*M._sizeT.z+M._initT.z;
-		*/
-		D->T.lerp	(T1,T2,delta);
-		/*					
-		if ((_abs(D->T.y)>10000) || (_abs(D->T.x)>10000) || (_abs(D->T.z)>10000))
-		{
-		Log("xxx");
-		Log("Blend--------");
-		Log("blendAmount", B->blendAmount);
-		Log("timeCurrent", B->timeCurrent);
-		Log("timeTotal", B->timeTotal);
-		Log("bone_or_part", B->bone_or_part);
-
-		Log("blendAccrue", B->blendAccrue);
-		Log("blendFalloff", B->blendFalloff);
-		Log("blendPower", B->blendPower);
-		Log("speed", B->speed);
-		Log("playing", B->playing);
-		Log("stop_at_end", B->stop_at_end);
-		Log("motionID", (u32)B->motionID.idx);
-		Log("blend", B->blend);
-
-		Log("dwFrame", B->dwFrame);
-		Log("Device.dwFrame", Device.dwFrame);
-		Log("Blend-------end");
-
-		Log("Bone",LL_BoneName_dbg(SelfID));
-		Log("parent",*parent);
-		Msg("K1t %d,%d,%d",K1t->x,K1t->y,K1t->z);
-		Msg("K2t %d,%d,%d",K2t->x,K2t->y,K2t->z);
-
-		Log("count",count);
-		Log("time",time);
-		Log("frame",frame);
-		Log("T1",T1);
-		Log("T2",T2);
-		Log("delta",delta);
-		Log("Dt",D->T);
-		VERIFY(0);
-
-		}
-		*/
-	} //if (M.test_flag(flTKeyPresent))
-	else
-	{
-		D->T.set	(M._initT);
-	}
+	M.sample		(frame,time-float(frame),K);
 }
 
 
 
-
 IC void MixInterlerp( CKey &Result, const CKey	*R, const float* BA, int b_count )
 {
 
@@ -1056,12 +962,7 @@ void CKinematicsAnimated::CLBone(const CBoneData* bd,CBoneInstance& BONE_INST,co
 				CMotion			&M			=*LL_GetMotion(B->motionID,SelfID);
 				Dequantize(*D,*B,M);
 
-				QR2Quat( M._keysR[0], BK[channel][b_count].Q	);
-
-				if(M.test_flag(flTKeyPresent))
-					QT2T(M._keysT[0] ,M ,BK[channel][b_count].T );
-				else
-					BK[channel][b_count].T.set(M._initT);
+				M.sample(0, 0.f, BK[channel][b_count]);
 
 				++b_count;
 			///               PSGP.blerp				(D,&K1,&K2,delta);
@@ -1203,6 +1104,7 @@ void	CKinematicsAnimated::BoneChain_Calculate		(const CBoneData* bd, CBoneInstan
 //
 	if(SelfID==LL_GetBoneRoot())
 	{
+		LL_TouchMotions();
 		CLBone(bd, bi, &Fidentity, Blend, mask_channel);
 //restore callback	
 		bi.Callback	= bc;
@@ -1223,6 +1125,18 @@ void	CKinematicsAnimated::BoneChain_Calculate		(const CBoneData* bd, CBoneInstan
 void CKinematicsAnimated::OnCalculateBones		()
 {
 	UpdateTracks	()	;
+	LL_TouchMotions	()	;
+}
+
+// keeps the keys of the played motions paged in
+void CKinematicsAnimated::LL_TouchMotions		()
+{
+	BlendSVecIt I,E;
+	for (u16 part=0; part<MAX_PARTS; part++)
+		for (I=blend_cycles[part].begin(),E=blend_cycles[part].end(); I!=E; I++)
+			m_Motions[(*I)->motionID.slot].motions.touch((*I)->motionID.idx);
+	for (I=blend_fx.begin(),E=blend_fx.end(); I!=E; I++)
+		m_Motions[(*I)->motionID.slot].motions.touch((*I)->motionID.idx);
 }
 
 #ifdef _EDITOR
@@ -139,6 +139,7 @@ public:
 	virtual void				Bone_Calculate			(CBoneData* bd, Fmatrix* parent);
 			void				Bone_GetAnimPos			(Fmatrix& pos,u16 id, u8 channel_mask, bool ignore_callbacks);
 	virtual void				OnCalculateBones		();
+			void				LL_TouchMotions			();
 public: 
 #ifdef _EDITOR
 public:
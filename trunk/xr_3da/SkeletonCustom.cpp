@@ -25,12 +25,13 @@ void		CBoneInstance::construct	()
 	mRenderTransform.identity	();
 	Callback_overwrite			= FALSE;
 }
-void		CBoneInstance::set_callback	(u32 Type, BoneCallback C, void* Param, BOOL overwrite)
+void		CBoneInstance::set_callback	(u32 Type, BoneCallback C, void* Param, BOOL overwrite, BOOL mt)
 {	
 	Callback			= C; 
 	Callback_Param		= Param; 
 	Callback_overwrite	= overwrite;
 	Callback_type		= Type;
+	Callback_mt			= mt;
 }
 void		CBoneInstance::reset_callback()
 {
@@ -38,6 +39,7 @@ void		CBoneInstance::reset_callback()
 	Callback_Param		= 0; 
 	Callback_overwrite	= FALSE;
 	Callback_type		= 0;
+	Callback_mt			= FALSE;
 }
 
 void		CBoneInstance::set_param	(u32 idx, float data)
@@ -43,9 +43,10 @@ public:
 	BOOL				Callback_overwrite;					// performance hint - don't calc anims
 	float				param			[MAX_BONE_PARAMS];	// 
 	u32					Callback_type;						//
+	BOOL				Callback_mt;						// callback reads its owner and writes this bone only - may run on worker threads
 	// methods
 	void				construct		();
-	void				set_callback	(u32 Type, BoneCallback C, void* Param, BOOL overwrite=FALSE);
+	void				set_callback	(u32 Type, BoneCallback C, void* Param, BOOL overwrite=FALSE, BOOL mt=FALSE);
 	void				reset_callback	();
 	void				set_param		(u32 idx, float data);
 	float				get_param		(u32 idx);
@@ -175,6 +176,7 @@ class ENGINE_API	CKinematics: public FHierrarhyVisual
 	typedef FHierrarhyVisual	inherited;
 	friend class				CBoneData;
 	friend class				CSkeletonX;
+	friend class				CKinematicsBatch;
 public: 
 #ifdef DEBUG
 	BOOL						dbg_single_use_marker;
@@ -217,6 +219,12 @@ protected:
 	void						Visibility_Update		()	;
 
     void						LL_Validate				();
+
+	// CalculateBones stages, prepare/finish run game callbacks and must stay on the calling thread
+	BOOL						CalculateBones_Prepare	(BOOL bForceExact);	// FALSE if nothing to calculate
+	void						CalculateBones_Hierarchy();
+	void						CalculateBones_Finish	();
+	BOOL						CalculateBones_MT		();					// hierarchy may be calculated on worker threads
 public:
 	UpdateCallback				Update_Callback;
 	void*						Update_Callback_Param;
@@ -291,5 +299,20 @@ public:
 	}
 };
 IC CKinematics* PKinematics		(IRender_Visual* V)		{ return V?V->dcast_PKinematics():0; }
+
+// Frame-level bones calculation: kinematics collected before rendering are calculated together,
+// hierarchies of the ones without thread-unsafe bone callbacks are spread over worker threads
+class ENGINE_API	CKinematicsBatch
+{
+	xr_vector<CKinematics*>		items		;
+	xr_vector<CKinematics*>		serial		;
+private:
+	void	__stdcall			calculate_MT	(u32 begin, u32 end, u32 worker_id);
+public:
+	void						add				(CKinematics* K);
+	void						calculate		();
+	BOOL						empty			()	{ return items.empty();	}
+	void						clear			()	{ items.clear(); serial.clear();	}
+};
 //---------------------------------------------------------------------------
 #endif
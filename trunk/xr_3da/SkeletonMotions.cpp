@@ -8,6 +8,8 @@
 #include	"motion.h"
 
 motions_container*	g_pMotionsContainer	= 0;
+float				psAnimCompress		= 0.f;		// error bound of the compressed keys, 0 - keep as loaded
+int					psAnimCache			= 64;		// (Mb) of paged motion keys, 0 - load all the keys with the motions
 
 u16 find_bone_id(vecBones* bones, shared_str nm)
 {
@@ -17,7 +19,21 @@ u16 find_bone_id(vecBones* bones, shared_str nm)
 }
 
 //-----------------------------------------------------------------------
-BOOL motions_value::load		(LPCSTR N, IReader *data, vecBones* bones)
+motions_value::motions_value	()
+{
+	m_dwReference				= 0;
+	m_file						= 0;
+	m_keys						= 0;
+	m_key_resident				= 0;
+}
+
+motions_value::~motions_value	()
+{
+	if (m_keys)					m_keys->close	();
+	if (m_file)					FS.r_close		(m_file);
+}
+
+BOOL motions_value::load		(LPCSTR N, IReader *data, vecBones* bones, LPCSTR source)
 {
 
 	m_id						= N;
@@ -113,6 +129,50 @@ BOOL motions_value::load		(LPCSTR N, IReader *data, vecBones* bones)
 	for (u32 i=0; i<bones->size(); i++)
 		m_motions[bones->at(i)->name].resize(dwCNT);
 
+	// bone motions in the file order
+	m_key_bones.resize	(bones->size());
+	for (u32 i=0; i<bones->size(); i++){
+		u16 bone_id		= rm_bones[i];
+		VERIFY2			(bone_id!=BI_NONE,"Invalid remap index.");
+		m_key_bones[i]	= &m_motions[bones->at(bone_id)->name];
+	}
+
+#ifndef _EDITOR
+	// page the keys from the mapped file: index the motions now, read the keys on the first use.
+	// A compressed file is opened decompressed in memory as a whole, there is nothing to page then.
+	// The keys compression is too slow for the page in, compressed keys are loaded once and stay
+	const CLocatorAPI::file* desc	= (source && psAnimCache && psAnimCompress<=0.f)?FS.exist(source):0;
+	if (desc && (desc->size_real==desc->size_compressed)){
+		m_file			= FS.r_open(source);
+		m_keys			= m_file?m_file->open_chunk(OGF_S_MOTIONS):0;
+		if (m_keys){
+			m_key_offset.resize	(dwCNT);
+			m_key_used.assign	(dwCNT,0);
+			m_key_links.resize	(dwCNT);
+			for (u16 m_idx=0; m_idx<(u16)dwCNT; m_idx++){
+				R_ASSERT			(m_keys->find_chunk(m_idx+1));
+				m_keys->skip_stringZ();
+				u32 dwLen			= m_keys->r_u32();
+				m_key_offset[m_idx]	= m_keys->tell();
+				m_key_links[m_idx].value	= this;
+				m_key_links[m_idx].m_idx	= m_idx;
+				for (u32 i=0; i<m_key_bones.size(); i++){
+					CMotion&	M	= m_key_bones[i]->at(m_idx);
+					M.set_count		(dwLen);
+					M.set_flags		(m_keys->r_u8());
+					if (M.test_flag(flRKeyAbsent))	m_keys->advance	(sizeof(CKeyQR));
+					else							m_keys->advance	(sizeof(u32)+dwLen*sizeof(CKeyQR));
+					if (M.test_flag(flTKeyPresent))	m_keys->advance	(sizeof(u32)+dwLen*sizeof(CKeyQT)+2*sizeof(Fvector));
+					else							m_keys->advance	(sizeof(Fvector));
+				}
+			}
+			MS->close	();
+			return		bRes;
+		}
+		if (m_file)		FS.r_close	(m_file);
+	}
+#endif
+
 	// load motions
 	for (u16 m_idx=0; m_idx<(u16)dwCNT; m_idx++){
 		string128			mname;
@@ -126,33 +186,10 @@ BOOL motions_value::load		(LPCSTR N, IReader *data, vecBones* bones)
         VERIFY3				(I->second==m_idx,"Invalid motion index:",mname);
 #endif
 		u32 dwLen			= MS->r_u32();
-		for (u32 i=0; i<bones->size(); i++){
-			u16 bone_id		= rm_bones[i];
-			VERIFY2			(bone_id!=BI_NONE,"Invalid remap index.");
-			CMotion&		M	= m_motions[bones->at(bone_id)->name][m_idx];
-			M.set_count			(dwLen);
-			M.set_flags			(MS->r_u8());
-            
-            if (M.test_flag(flRKeyAbsent))	{
-                CKeyQR* r 		= (CKeyQR*)MS->pointer();
-				u32 crc_q		= crc32(r,sizeof(CKeyQR));
-				M._keysR.create	(crc_q,1,r);
-                MS->advance		(1 * sizeof(CKeyQR));
-            }else{
-                u32 crc_q		= MS->r_u32	();
-                M._keysR.create	(crc_q,dwLen,(CKeyQR*)MS->pointer());
-                MS->advance		(dwLen * sizeof(CKeyQR));
-            }
-            if (M.test_flag(flTKeyPresent))	{
-                u32 crc_t		= MS->r_u32	();
-                M._keysT.create	(crc_t,dwLen,(CKeyQT*)MS->pointer());
-                MS->advance		(dwLen * sizeof(CKeyQT));
-                MS->r_fvector3	(M._sizeT);
-                MS->r_fvector3	(M._initT);
-            }else{
-                MS->r_fvector3	(M._initT);
-            }
-		}
+		load_keys			(MS,m_idx,dwLen);
+		if (psAnimCompress>0.f)
+			for (u32 i=0; i<m_key_bones.size(); i++)
+				m_key_bones[i]->at(m_idx).compress	(psAnimCompress);
 	}
 //	Msg("Motions %d/%d %4d/%4d/%d, %s",p_cnt,m_cnt, m_load,m_total,m_r,N);
 	MS->close();
@@ -160,6 +197,239 @@ BOOL motions_value::load		(LPCSTR N, IReader *data, vecBones* bones)
 	return bRes;
 }
 
+// keys of all the bones of the motion, MS is at the first one
+void motions_value::load_keys	(IReader* MS, u16 m_idx, u32 dwLen)
+{
+	for (u32 i=0; i<m_key_bones.size(); i++){
+		CMotion&		M	= m_key_bones[i]->at(m_idx);
+		M.set_count			(dwLen);
+		M.set_flags			(MS->r_u8());
+        
+        if (M.test_flag(flRKeyAbsent))	{
+            CKeyQR* r 		= (CKeyQR*)MS->pointer();
+			u32 crc_q		= crc32(r,sizeof(CKeyQR));
+			M._keysR.create	(crc_q,1,r);
+            MS->advance		(1 * sizeof(CKeyQR));
+        }else{
+            u32 crc_q		= MS->r_u32	();
+            M._keysR.create	(crc_q,dwLen,(CKeyQR*)MS->pointer());
+            MS->advance		(dwLen * sizeof(CKeyQR));
+        }
+        if (M.test_flag(flTKeyPresent))	{
+            u32 crc_t		= MS->r_u32	();
+            M._keysT.create	(crc_t,dwLen,(CKeyQT*)MS->pointer());
+            MS->advance		(dwLen * sizeof(CKeyQT));
+            MS->r_fvector3	(M._sizeT);
+            MS->r_fvector3	(M._initT);
+        }else{
+            MS->r_fvector3	(M._initT);
+        }
+	}
+}
+
+void motions_value::touch_keys	(u16 m_idx)
+{
+	// used this frame already, nothing used this or the previous frame is paged out
+	if (m_key_used[m_idx]==Device.dwFrame+1)	return;
+	g_pMotionsContainer->page_in	(this,m_idx);
+}
+
+u32 motions_value::key_size		(u16 m_idx)
+{
+	u32		sz		= 0;
+	for (u32 i=0; i<m_key_bones.size(); i++)
+		sz			+= m_key_bones[i]->at(m_idx).keys_size();
+	return	sz;
+}
+
+//-----------------------------------
+// keys paging, the motions are touched from the worker threads (CKinematicsBatch), so both
+// the stamps and the use order change under the lock only
+IC void lru_unlink				(motion_keys_link* L)
+{
+	L->prev->next				= L->next;
+	L->next->prev				= L->prev;
+}
+
+IC void lru_push_back			(motion_keys_link* head, motion_keys_link* L)
+{
+	L->prev						= head->prev;
+	L->next						= head;
+	head->prev->next			= L;
+	head->prev					= L;
+}
+
+void motions_container::page_in	(motions_value* V, u16 m_idx)
+{
+	m_key_lock.Enter			();
+	motion_keys_link*	L		= &V->m_key_links[m_idx];
+	if (V->m_key_used[m_idx])	{
+		V->m_key_used[m_idx]	= Device.dwFrame+1;
+		lru_unlink				(L);
+		lru_push_back			(&m_key_lru,L);
+		m_key_lock.Leave		();
+		return;
+	}
+
+	V->m_keys->seek				(V->m_key_offset[m_idx]);
+	V->load_keys				(V->m_keys,m_idx,V->m_key_bones.front()->at(m_idx).get_count());
+	V->m_key_used[m_idx]		= Device.dwFrame+1;
+	lru_push_back				(&m_key_lru,L);
+
+	u32		sz					= V->key_size(m_idx);
+	V->m_key_resident			+= sz;
+	m_key_resident				+= sz;
+
+	// least recently used motions first, but nothing used this or the previous frame
+	u32		budget				= u32(psAnimCache)*1024*1024;
+	while (budget && (m_key_resident>budget)){
+		motion_keys_link*	lru	= m_key_lru.next;
+		if (lru==&m_key_lru)	break;
+		if (lru->value->m_key_used[lru->m_idx]>=Device.dwFrame)	break;
+		page_out				(lru->value,lru->m_idx);
+	}
+	m_key_lock.Leave			();
+}
+
+void motions_container::page_out	(motions_value* V, u16 m_idx)
+{
+	u32		sz					= V->key_size(m_idx);
+	for (u32 i=0; i<V->m_key_bones.size(); i++){
+		CMotion&		M		= V->m_key_bones[i]->at(m_idx);
+		M._keysR.release		();
+		M._keysT.release		();
+		M._keysC.release		();
+	}
+	V->m_key_used[m_idx]		= 0;
+	V->m_key_resident			-= sz;
+	m_key_resident				-= sz;
+	lru_unlink					(&V->m_key_links[m_idx]);
+}
+
+// the keys go with the motions, they only leave the use order
+void motions_container::drop_keys	(motions_value* V)
+{
+	for (u32 m=0; m<V->m_key_used.size(); m++)
+		if (V->m_key_used[m])	lru_unlink	(&V->m_key_links[m]);
+	m_key_resident				-= V->m_key_resident;
+}
+
+//-----------------------------------------------------------------------
+// Keys compression
+//-----------------------------------------------------------------------
+static const u32	max_key_distance	= 64;	// frames, bounds the encoding time
+
+// keeps the first and the last frames and the ones linear interpolation can't restore
+static void reduce_keys	(const float* src, u32 frames, u32 components, float error, xr_vector<u16>& keys)
+{
+	keys.clear			();
+	keys.push_back		(0);
+	for (u32 a=0; a+1<frames; ){
+		u32		b		= a+1;
+		for (; (b+1<frames) && (b+1-a<=max_key_distance); b++){
+			u32		e		= b+1;
+			bool	fits	= true;
+			for (u32 f=a+1; fits && (f<e); f++){
+				float	t	= float(f-a)/float(e-a);
+				for (u32 c=0; c<components; c++){
+					float	v	= src[a*components+c] + (src[e*components+c]-src[a*components+c])*t;
+					if (_abs(v-src[f*components+c])>error)	{ fits = false; break; }
+				}
+			}
+			if (!fits)	break;
+		}
+		keys.push_back	(u16(b));
+		a				= b;
+	}
+}
+
+// half of the error goes to the keys reduction, half to the quantization
+static void encode_track	(xr_vector<u8>& dst, const float* src, u32 frames, u32 components, float error)
+{
+	xr_vector<u16>		keys;
+	reduce_keys			(src,frames,components,error*.5f,keys);
+
+	float	vmin[4],vmax[4];
+	for (u32 c=0; c<components; c++){
+		vmin[c]			= flt_max;
+		vmax[c]			= -flt_max;
+		for (u32 k=0; k<keys.size(); k++){
+			float	v	= src[keys[k]*components+c];
+			vmin[c]		= _min(vmin[c],v);
+			vmax[c]		= _max(vmax[c],v);
+		}
+	}
+	u32		bits		= 8;
+	for (u32 c=0; c<components; c++)
+		if ((vmax[c]-vmin[c])/255.f*.5f > error*.5f)	bits = 16;
+	float	levels		= (8==bits)?255.f:65535.f;
+
+	u32		offset		= dst.size();
+	dst.resize			(offset+CKeyTrack::size(keys.size(),components,bits),0);
+	CKeyTrack*	T		= (CKeyTrack*)&dst[offset];
+	T->count			= u16(keys.size());
+	T->components		= u8(components);
+	T->bits				= u8(bits);
+	for (u32 c=0; c<4; c++){
+		T->base[c]		= (c<components)?vmin[c]:0.f;
+		T->scale[c]		= (c<components)?(vmax[c]-vmin[c])/levels:0.f;
+	}
+
+	u16*	F			= (u16*)T->frames();
+	u8*		V			= (u8*)T->values();
+	for (u32 k=0; k<keys.size(); k++){
+		F[k]			= keys[k];
+		for (u32 c=0; c<components; c++){
+			float	q	= (T->scale[c]>0.f)?(src[keys[k]*components+c]-T->base[c])/T->scale[c]:0.f;
+			s32		v	= iFloor(q+.5f);
+			clamp		(v,0,iFloor(levels));
+			if (8==bits)	V[k*components+c]			= u8(v);
+			else			((u16*)V)[k*components+c]	= u16(v);
+		}
+	}
+}
+
+BOOL CMotion::compress(float error)
+{
+	u32					count	= get_count();
+	if (test_flag(flKeysCompressed) || (count>0xffff))	return FALSE;
+
+	xr_vector<float>	src;
+	xr_vector<u8>		blob;
+
+	u32					r_frames = test_flag(flRKeyAbsent)?1:count;
+	src.resize			(r_frames*4);
+	for (u32 f=0; f<r_frames; f++){
+		Fquaternion		Q;
+		QR2Quat			(_keysR[f],Q);
+		src[f*4+0]		= Q.x;
+		src[f*4+1]		= Q.y;
+		src[f*4+2]		= Q.z;
+		src[f*4+3]		= Q.w;
+	}
+	encode_track		(blob,&*src.begin(),r_frames,4,error);
+
+	if (test_flag(flTKeyPresent)){
+		src.resize		(count*3);
+		for (u32 f=0; f<count; f++){
+			Fvector		T;
+			QT2T		(_keysT[f],*this,T);
+			src[f*3+0]	= T.x;
+			src[f*3+1]	= T.y;
+			src[f*3+2]	= T.z;
+		}
+		encode_track	(blob,&*src.begin(),count,3,error);
+	}
+
+	if (blob.size()>=raw_size())	return FALSE;
+
+	_keysC.create		(crc32(&*blob.begin(),blob.size()),blob.size(),&*blob.begin());
+	_keysR.release		();
+	_keysT.release		();
+	set_flag			(flKeysCompressed,TRUE);
+	return				TRUE;
+}
+
 MotionVec* motions_value::bone_motions(shared_str bone_name)
 {
 	BoneMotionMapIt it			= m_motions.find(bone_name); VERIFY(it!=m_motions.end());
@@ -168,6 +438,11 @@ MotionVec* motions_value::bone_motions(shared_str bone_name)
 //-----------------------------------
 motions_container::motions_container()
 {
+	m_key_resident		= 0;
+	m_key_lru.value		= 0;
+	m_key_lru.m_idx		= 0;
+	m_key_lru.prev		= &m_key_lru;
+	m_key_lru.next		= &m_key_lru;
 }
 extern shared_str s_bones_array_const;
 motions_container::~motions_container()
@@ -184,7 +459,7 @@ bool motions_container::has(shared_str key)
 	return (container.find(key)!=container.end());
 }
 
-motions_value* motions_container::dock(shared_str key, IReader *data, vecBones* bones)
+motions_value* motions_container::dock(shared_str key, IReader *data, vecBones* bones, LPCSTR source)
 {
 	motions_value*	result		= 0	;
 	SharedMotionsMapIt	I		= container.find	(key);
@@ -194,7 +469,7 @@ motions_value* motions_container::dock(shared_str key, IReader *data, vecBones*
 		VERIFY					(data);
 		result					= xr_new<motions_value>();
 		result->m_dwReference	= 0;
-		BOOL bres				= result->load	(key.c_str(),data,bones);
+		BOOL bres				= result->load	(key.c_str(),data,bones,source);
 		if (bres)				container.insert(mk_pair(key,result));
 		else					xr_delete		(result);
 	}
@@ -207,6 +482,7 @@ void motions_container::clean(bool force_destroy)
 	if (force_destroy){
 		for (; it!=_E; it++){
 			motions_value*	sv = it->second;
+			drop_keys		(sv);
 			xr_delete		(sv);
 		}
 		container.clear		();
@@ -217,6 +493,7 @@ void motions_container::clean(bool force_destroy)
 			{
 				SharedMotionsMapIt	i_current	= it;
 				SharedMotionsMapIt	i_next		= ++it;
+				drop_keys			(sv);
 				xr_delete			(sv);
 				container.erase		(i_current);
 				it					= i_next;
@@ -234,12 +511,58 @@ void motions_container::dump()
 	u32 sz					= sizeof(*this);
 	for (u32 k=0; it!=_E; k++,it++){
 		sz					+= it->second->mem_usage();
-		Msg("#%3d: [%3d/%5d Kb] - %s",k,it->second->m_dwReference,it->second->mem_usage()/1024,it->first.c_str());
+		motions_value*		V	= it->second;
+		if (V->m_keys){
+			u32	resident		= 0;
+			for (u32 m=0; m<V->m_key_used.size(); m++)	if (V->m_key_used[m])	resident++;
+			Msg("#%3d: [%3d/%5d Kb] - %s, paged %d/%d motions, %d Kb",k,V->m_dwReference,V->mem_usage()/1024,it->first.c_str(),resident,V->m_key_used.size(),V->m_key_resident/1024);
+		}else
+			Msg("#%3d: [%3d/%5d Kb] - %s",k,V->m_dwReference,V->mem_usage()/1024,it->first.c_str());
 	}
 	Msg ("--- items: %d, mem usage: %d Kb ",container.size(),sz/1024);
+
+	u32 raw=0, stored=0, motions=0, compressed=0;
+	for (it=container.begin(); it!=_E; it++){
+		for (BoneMotionMapIt bm_it=it->second->m_motions.begin(); bm_it!=it->second->m_motions.end(); bm_it++)
+			for (MotionVecIt m_it=bm_it->second.begin(); m_it!=bm_it->second.end(); m_it++){
+				raw			+= m_it->raw_size();
+				stored		+= m_it->mem_usage()-sizeof(CMotion);
+				motions		++;
+				if (m_it->test_flag(flKeysCompressed))	compressed++;
+			}
+	}
+	Msg ("--- keys: %d Kb as loaded, %d Kb stored, compressed %d of %d",raw/1024,stored/1024,compressed,motions);
+	Msg ("--- paged keys: %d Kb of %d Mb",m_key_resident/1024,psAnimCache);
 	Log	("--- motion container --- end.");
 }
 
+// decode cost of the uncompressed and the compressed keys, per sampled frame
+void motions_container::benchmark()
+{
+	u32		raw_keys	= 0,	packed_keys	= 0;
+	float	raw_time	= 0.f,	packed_time	= 0.f;
+	float	sink		= 0.f;
+	CTimer	T;
+	CKey	K;
+	for (SharedMotionsMapIt it=container.begin(); it!=container.end(); it++)
+		for (BoneMotionMapIt bm_it=it->second->m_motions.begin(); bm_it!=it->second->m_motions.end(); bm_it++)
+			for (MotionVecIt m_it=bm_it->second.begin(); m_it!=bm_it->second.end(); m_it++){
+				u32		count	= m_it->get_count();
+				T.Start			();
+				for (u32 f=0; f<count; f++){
+					m_it->sample(f,.5f,K);
+					sink		+= K.Q.w+K.T.y;
+				}
+				float	time	= T.GetElapsed_sec();
+				if (m_it->test_flag(flKeysCompressed))	{ packed_keys += count; packed_time += time; }
+				else									{ raw_keys += count; raw_time += time; }
+			}
+	Msg		("--- motion keys decode: raw %d keys, %2.1f ns/key; compressed %d keys, %2.1f ns/key [%f]",
+		raw_keys,	raw_keys?raw_time*1e9f/float(raw_keys):0.f,
+		packed_keys,packed_keys?packed_time*1e9f/float(packed_keys):0.f,
+		sink);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // High level control
 void CMotionDef::Load(IReader* MP, u32 fl, u16 version)
@@ -22,6 +22,7 @@ const	f32		KEY_QuantI			=	1.f/KEY_Quant;
 enum{
     flTKeyPresent 	= (1<<0),
     flRKeyAbsent 	= (1<<1),
+    flKeysCompressed= (1<<7),	// runtime only, keys are in _keysC
 };
 #pragma pack(push,2)
 struct ENGINE_API CKey
@@ -39,6 +40,57 @@ struct ENGINE_API CKeyQT
 };
 #pragma pack(pop)
 
+// Compressed track: only the keys linear interpolation can't restore within the error bound,
+// quantized to 8 or 16 bits in the range of the track. The first key is at frame 0, the last
+// one at the last frame, which blends into frame 0 as the uncompressed keys do.
+struct ENGINE_API CKeyTrack
+{
+	u16			count;
+	u8			components;
+	u8			bits;
+	float		base		[4];
+	float		scale		[4];
+//	u16			frames		[count];
+//	u8/u16		values		[count][components];
+
+	IC const u16*		frames		() const	{ return (const u16*)(this+1);										}
+	IC const u8*		values		() const	{ return (const u8*)(frames()+count);								}
+	IC static u32		size		(u32 count, u32 components, u32 bits)
+	{
+		u32 sz			= sizeof(CKeyTrack) + count*sizeof(u16) + count*components*(bits/8);
+		return			(sz+3)&~3;
+	}
+	IC u32				size		() const	{ return size(count,components,bits);								}
+	IC const CKeyTrack*	next		() const	{ return (const CKeyTrack*)((const u8*)this+size());				}
+
+	IC void				value		(u32 key, float* dst) const
+	{
+		if (8==bits)	{
+			const u8*	v	= values() + key*components;
+			for (u32 c=0; c<components; c++)	dst[c] = float(v[c])*scale[c] + base[c];
+		} else {
+			const u16*	v	= (const u16*)values() + key*components;
+			for (u32 c=0; c<components; c++)	dst[c] = float(v[c])*scale[c] + base[c];
+		}
+	}
+	// keys around the frame and the factor between them
+	IC void				locate		(u32 frame, float delta, u32& k1, u32& k2, float& t) const
+	{
+		const u16*	F	= frames();
+		if (frame>=F[count-1])	{ k1 = count-1; k2 = 0; t = delta; return; }
+		u32	lo			= 0;
+		u32	hi			= count-1;
+		while (hi-lo>1)	{
+			u32	mid		= (lo+hi)/2;
+			if (F[mid]<=frame)	lo = mid;
+			else				hi = mid;
+		}
+		k1				= lo;
+		k2				= hi;
+		t				= (float(frame-F[lo])+delta)/float(F[hi]-F[lo]);
+	}
+};
+
 //*** Motion Data *********************************************************************************
 class ENGINE_API		CMotion
 {
@@ -49,6 +101,7 @@ class ENGINE_API		CMotion
 public:
     ref_smem<CKeyQR>	_keysR;
     ref_smem<CKeyQT>	_keysT;
+	ref_smem<u8>		_keysC;		// rotation CKeyTrack, then translation one
 	Fvector				_initT;
     Fvector				_sizeT;
 public:    
@@ -61,14 +114,86 @@ public:
 
 	float				GetLength			(){ return float(_count)*SAMPLE_SPF; }
 
+	// replaces the keys with the compressed tracks, if that saves memory
+	BOOL				compress			(float error);
+	IC void				sample				(u32 frame, float delta, CKey& K) const;
+
+	u32					keys_size			(){ return _keysR.size()*sizeof(CKeyQR)+_keysT.size()*sizeof(CKeyQT)+_keysC.size(); }
+	u32					raw_size			(){
+		u32 sz			= test_flag(flRKeyAbsent)?sizeof(CKeyQR):get_count()*sizeof(CKeyQR);
+		if (test_flag(flTKeyPresent))	sz += get_count()*sizeof(CKeyQT);
+		return			sz;
+	}
 	u32					mem_usage			(){ 
 		u32 sz			= sizeof(*this);
 		if (_keysR.size()) sz += _keysR.size()*sizeof(CKeyQR)/_keysR.ref_count();
 		if (_keysT.size()) sz += _keysT.size()*sizeof(CKeyQT)/_keysT.ref_count();
+		if (_keysC.size()) sz += _keysC.size()/_keysC.ref_count();
 		return			sz;
 	}
 };
 
+IC	void QR2Quat(const CKeyQR &K,Fquaternion &Q)
+{
+	Q.x		= float(K.x)*KEY_QuantI;
+	Q.y		= float(K.y)*KEY_QuantI;
+	Q.z		= float(K.z)*KEY_QuantI;
+	Q.w		= float(K.w)*KEY_QuantI;
+}
+
+IC void QT2T(const CKeyQT& K,const CMotion& M,Fvector &T)
+{
+	T.x		= float(K.x)*M._sizeT.x+M._initT.x;
+	T.y		= float(K.y)*M._sizeT.y+M._initT.y;
+	T.z		= float(K.z)*M._sizeT.z+M._initT.z;
+}
+
+IC void CMotion::sample(u32 frame, float delta, CKey& K) const
+{
+	u32				count	=	get_count();
+	frame					%=	count;
+	if (test_flag(flKeysCompressed)){
+		const CKeyTrack*	R	=	(const CKeyTrack*)*_keysC;
+		u32			k1,k2;
+		float		t;
+		Fquaternion	Q1,Q2;
+		R->locate	(frame,delta,k1,k2,t);
+		R->value	(k1,&Q1.x);
+		R->value	(k2,&Q2.x);
+		K.Q.slerp	(Q1,Q2,clampr(t,0.f,1.f));
+
+		if (test_flag(flTKeyPresent)){
+			const CKeyTrack*	T	=	R->next();
+			Fvector	T1,T2;
+			T->locate	(frame,delta,k1,k2,t);
+			T->value	(k1,&T1.x);
+			T->value	(k2,&T2.x);
+			K.T.lerp	(T1,T2,t);
+		}else
+			K.T.set		(_initT);
+		return;
+	}
+
+	// rotation
+	if (test_flag(flRKeyAbsent)){
+		QR2Quat		(_keysR[0],K.Q);
+	}else{
+		Fquaternion	Q1,Q2;
+		QR2Quat		(_keysR[frame],Q1);
+		QR2Quat		(_keysR[(frame+1)%count],Q2);
+		K.Q.slerp	(Q1,Q2,clampr(delta,0.f,1.f));
+	}
+
+	// translate
+	if (test_flag(flTKeyPresent)){
+		Fvector		T1,T2;
+		QT2T		(_keysT[frame],*this,T1);
+		QT2T		(_keysT[(frame+1)%count],*this,T2);
+		K.T.lerp	(T1,T2,delta);
+	}else
+		K.T.set		(_initT);
+}
+
 class ENGINE_API motion_marks
 {
 public:
@@ -148,6 +273,17 @@ public:
 	u32					mem_usage			()		{ return P[0].mem_usage()*MAX_PARTS;}
 };
 
+struct					motions_value;
+
+// paged motion in the use order of motions_container
+struct					motion_keys_link
+{
+	motions_value*		value;
+	u16					m_idx;
+	motion_keys_link*	prev;
+	motion_keys_link*	next;
+};
+
 // shared motions
 struct ENGINE_API		motions_value
 {
@@ -161,12 +297,26 @@ struct ENGINE_API		motions_value
 
 	shared_str			m_id;
 
-
-	BOOL				load				(LPCSTR N, IReader *data, vecBones* bones);
+	// paged keys, see psAnimCache
+	IReader*			m_file;				// kept mapped while the motions are in use
+	IReader*			m_keys;				// OGF_S_MOTIONS of m_file, 0 - all the keys are loaded
+	xr_vector<MotionVec*>	m_key_bones;	// bone motions in the file order
+	xr_vector<u32>		m_key_offset;		// of the keys of every motion in m_keys
+	xr_vector<u32>		m_key_used;			// frame of the last use + 1, 0 - not loaded
+	xr_vector<motion_keys_link>	m_key_links;
+	u32					m_key_resident;		// bytes
+
+						motions_value		();
+						~motions_value		();
+	BOOL				load				(LPCSTR N, IReader *data, vecBones* bones, LPCSTR source);
+	void				load_keys			(IReader* MS, u16 m_idx, u32 dwLen);
+	IC void				touch				(u16 m_idx)		{ if (m_keys) touch_keys(m_idx); }
+	void				touch_keys			(u16 m_idx);
+	u32					key_size			(u16 m_idx);
 	MotionVec*			bone_motions		(shared_str bone_name);
 
 	u32					mem_usage			(){ 
-		u32 sz			=	sizeof(*this)+m_motion_map.size()*6+m_partition.mem_usage();
+		u32 sz			=	sizeof(*this)+m_motion_map.size()*6+m_partition.mem_usage()+(m_key_offset.size()+m_key_used.size())*sizeof(u32)+m_key_links.size()*sizeof(motion_keys_link);
         for (MotionDefVecIt it=m_mdefs.begin(); it!=m_mdefs.end(); it++)
 			sz			+=	it->mem_usage();
 		for (BoneMotionMapIt bm_it=m_motions.begin(); bm_it!=m_motions.end(); bm_it++)
@@ -180,16 +330,25 @@ class ENGINE_API		motions_container
 {
 	DEFINE_MAP			(shared_str,motions_value*,SharedMotionsMap,SharedMotionsMapIt);
 	SharedMotionsMap	container;
+	u32					m_key_resident;		// bytes of the paged keys
+	motion_keys_link	m_key_lru;			// resident paged motions, the least recently used first
+	xrCriticalSection	m_key_lock;
 public:
 						motions_container	();
 						~motions_container	();
 	bool				has					(shared_str key);
-	motions_value*		dock				(shared_str key, IReader *data, vecBones* bones);
+	motions_value*		dock				(shared_str key, IReader *data, vecBones* bones, LPCSTR source=0);
+	void				page_in				(motions_value* V, u16 m_idx);
+	void				page_out			(motions_value* V, u16 m_idx);
+	void				drop_keys			(motions_value* V);
 	void				dump				();
+	void				benchmark			();
 	void				clean				(bool force_destroy);
 };
 
 ENGINE_API extern		motions_container*	g_pMotionsContainer;
+extern					float				psAnimCompress;
+extern					int					psAnimCache;
 
 class ENGINE_API		shared_motions
 {
@@ -199,7 +358,7 @@ protected:
 	// ref-counting
 	void				destroy			()							{	if (0==p_) return;	p_->m_dwReference--; 	if (0==p_->m_dwReference)	p_=0;	}
 public:
-	void				create			(shared_str key, IReader *data, vecBones* bones){	motions_value* v = g_pMotionsContainer->dock(key,data,bones); if (0!=v) v->m_dwReference++; destroy(); p_ = v;	}
+	void				create			(shared_str key, IReader *data, vecBones* bones, LPCSTR source=0){	motions_value* v = g_pMotionsContainer->dock(key,data,bones,source); if (0!=v) v->m_dwReference++; destroy(); p_ = v;	}
 	void				create			(shared_motions const &rhs)	{	motions_value* v = rhs.p_; if (0!=v) v->m_dwReference++; destroy(); p_ = v;	}
 public:
 	// construction
@@ -219,6 +378,7 @@ public:
 	CPartition*			partition		()							{	VERIFY(p_); return &p_->m_partition;			}
     MotionDefVec*		motion_defs		()							{	VERIFY(p_); return &p_->m_mdefs;				}
     CMotionDef*			motion_def		(u16 idx)					{	VERIFY(p_); return &p_->m_mdefs[idx];			}
+	void				touch			(u16 idx)					{	VERIFY(p_); p_->touch(idx);						}
 
 	const shared_str	&id				() const					{	VERIFY(p_); return p_->m_id;					}
 
@@ -17,28 +17,53 @@ void CKinematics::CalculateBones			(BOOL bForceExact)
 	// skip all the computations - assume nothing changes in a small period of time :)
 	if		(Device.dwTimeGlobal == UCalc_Time)										return;	// early out for "fast" update
 	UCalc_mtlock	lock	;
+	if		(!CalculateBones_Prepare(bForceExact))									return;
+
+	// exact computation
+	// Calculate bones
+#ifdef DEBUG
+	Device.Statistic->Animation.Begin();
+#endif
+	CalculateBones_Hierarchy		();
+#ifdef DEBUG
+	Device.Statistic->Animation.End	();
+#endif
+	CalculateBones_Finish			();
+}
+
+BOOL CKinematics::CalculateBones_Prepare	(BOOL bForceExact)
+{
 	OnCalculateBones		();
-	if		(!bForceExact && (Device.dwTimeGlobal < (UCalc_Time + UCalc_Interval)))	return;	// early out for "slow" update
+	if		(!bForceExact && (Device.dwTimeGlobal < (UCalc_Time + UCalc_Interval)))	return FALSE;	// early out for "slow" update
 	if		(Update_Visibility)									Visibility_Update	();
 
-	_DBG_SINGLE_USE_MARKER;
 	// here we have either:
 	//	1:	timeout elapsed
 	//	2:	exact computation required
 	UCalc_Time			= Device.dwTimeGlobal;
+	return				TRUE;
+}
 
-	// exact computation
-	// Calculate bones
-#ifdef DEBUG
-	Device.Statistic->Animation.Begin();
-#endif
-
+void CKinematics::CalculateBones_Hierarchy	()
+{
+	_DBG_SINGLE_USE_MARKER;
 	Bone_Calculate					(bones->at(iRoot),&Fidentity);
 #ifdef DEBUG
 	check_kinematics				(this, dbg_name.c_str() );
-	Device.Statistic->Animation.End	();
 #endif
+}
 
+BOOL CKinematics::CalculateBones_MT		()
+{
+	for (u32 b=0; b<bones->size(); b++)	{
+		CBoneInstance&	I	= bone_instances[b];
+		if (I.Callback && !I.Callback_mt)	return FALSE;
+	}
+	return TRUE;
+}
+
+void CKinematics::CalculateBones_Finish	()
+{
 	// Calculate BOXes/Spheres if needed
 	UCalc_Visibox++; 
 	if (UCalc_Visibox>=psSkeletonUpdate) 
@@ -96,6 +121,49 @@ void CKinematics::CalculateBones			(BOOL bForceExact)
 	if (Update_Callback)	Update_Callback(this);
 }
 
+//////////////////////////////////////////////////////////////////////
+void CKinematicsBatch::add				(CKinematics* K)
+{
+	if (0==K)								return;
+	if (Device.dwTimeGlobal==K->UCalc_Time)	return;	// already calculated for this time
+	items.push_back		(K);
+}
+
+void	__stdcall	CKinematicsBatch::calculate_MT	(u32 begin, u32 end, u32 worker_id)
+{
+	for (u32 it=begin; it<end; it++)
+		items[it]->CalculateBones_Hierarchy	();
+}
+
+void CKinematicsBatch::calculate		()
+{
+	if (items.empty())	return;
+
+	UCalc_mtlock	lock	;
+
+	// tracks and visibility first: play callbacks go back to the game
+	u32		count		= 0;
+	for (u32 it=0; it<items.size(); it++)	{
+		CKinematics*	K	= items[it];
+		if (Device.dwTimeGlobal==K->UCalc_Time)	continue;	// the same model registered twice
+		if (!K->CalculateBones_Prepare(TRUE))	continue;
+		if (K->CalculateBones_MT())				items[count++]	= K;
+		else									serial.push_back(K);
+	}
+	items.resize		(count);
+
+	// hierarchies: keyframes, blending and bone chains
+	Device.Statistic->Animation.Begin	();
+	WorkerPool.parallel_for	(items.size(),1,CWorkerPool::range_callback(this,&CKinematicsBatch::calculate_MT));
+	for (u32 it=0; it<serial.size(); it++)	serial[it]->CalculateBones_Hierarchy	();
+	Device.Statistic->Animation.End		();
+
+	// boxes and update callbacks
+	for (u32 it=0; it<items.size(); it++)	items[it]->CalculateBones_Finish	();
+	for (u32 it=0; it<serial.size(); it++)	serial[it]->CalculateBones_Finish	();
+	clear				();
+}
+
 #ifdef DEBUG
 void check_kinematics(CKinematics* _k, LPCSTR s)
 {
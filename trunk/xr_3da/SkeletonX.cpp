@@ -213,6 +213,7 @@ void CSkeletonX::_Copy		(CSkeletonX *B)
 	cache_DiscardID			= B->cache_DiscardID;
 	cache_vCount			= B->cache_vCount;
 	cache_vOffset			= B->cache_vOffset;
+	cache_Frame				= B->cache_Frame;
 	RenderMode				= B->RenderMode;
 	RMS_boneid				= B->RMS_boneid;
 	RMS_bonecount			= B->RMS_bonecount;
@@ -264,30 +265,18 @@ void CSkeletonX::_Render_soft	(ref_geom& hGeom, u32 vCount, u32 iOffset, u32 pCo
 	u32 vOffset				= cache_vOffset;
 
 	_VertexStream&	_VS		= RCache.Vertex;
-	if (cache_DiscardID!=_VS.DiscardID() || vCount>=cache_vCount )
+	BOOL	bSkinned		= (cache_Frame==Device.dwFrame) && (cache_DiscardID==_VS.DiscardID()) && (vCount<=cache_vCount);
+	if (!bSkinned && (cache_DiscardID!=_VS.DiscardID() || vCount>=cache_vCount))
 	{
 		vertRender*	Dest	= (vertRender*)_VS.Lock(vCount,hGeom->vb_stride,vOffset);
 		cache_DiscardID		= _VS.DiscardID();
 		cache_vCount		= vCount;
 		cache_vOffset		= vOffset;
+		cache_Frame			= Device.dwFrame;
 		
 		Device.Statistic->RenderDUMP_SKIN.Begin	();
-		if (*Vertices1W)
-		{
-			PSGP.skin1W(
-				Dest,										// dest
-				*Vertices1W,								// source
-				vCount,										// count
-				Parent->bone_instances						// bones
-				);
-		} else {
-			PSGP.skin2W(
-				Dest,										// dest
-				*Vertices2W,								// source
-				vCount,										// count
-				Parent->bone_instances						// bones
-				);
-		}
+		_Skin_soft			(Dest,vCount);
+		Device.Statistic->RenderDUMP_SKIN_Verts	+= vCount;
 		Device.Statistic->RenderDUMP_SKIN.End	();
 		_VS.Unlock			(vCount,hGeom->vb_stride);
 	}
@@ -296,6 +285,168 @@ void CSkeletonX::_Render_soft	(ref_geom& hGeom, u32 vCount, u32 iOffset, u32 pCo
 	RCache.Render			(D3DPT_TRIANGLELIST,vOffset,0,vCount,iOffset,pCount);
 }
 
+// thread-safe: reads shared vertices and bone matrices, writes [D+begin..D+end) only
+void CSkeletonX::_Skin_range	(vertRender* D, u32 begin, u32 end)
+{
+	if (*Vertices1W)	PSGP.skin1W	(D+begin,(*Vertices1W)+begin,end-begin,Parent->bone_instances);
+	else				PSGP.skin2W	(D+begin,(*Vertices2W)+begin,end-begin,Parent->bone_instances);
+}
+
+struct	skin_task
+{
+	CSkeletonX*			V;
+	vertRender*			D;
+	void	__stdcall	run		(u32 begin, u32 end, u32 worker_id)	{ V->_Skin_range(D,begin,end);	}
+};
+void CSkeletonX::_Skin_soft		(vertRender* D, u32 vCount)
+{
+	// big meshes (crowd LODs are small) are worth spreading over workers on their own
+	const u32	grain	= 1024;
+	if (vCount<2*grain)	{ _Skin_range(D,0,vCount); return; }
+	skin_task			task	= { this, D };
+	WorkerPool.parallel_for		(vCount,grain,CWorkerPool::range_callback(&task,&skin_task::run));
+}
+
+//////////////////////////////////////////////////////////////////////
+void CSkeletonXBatch::add		(CSkeletonX* V)
+{
+	if (0==V)			return;
+
+	// visuals registered by a phase which never rendered may be gone by now
+	if (frame!=Device.dwFrame)	{ items.clear(); frame = Device.dwFrame; }
+
+	u32		vCount		= V->_SoftVertices();
+	if (0==vCount)		return;
+
+	// already skinned this frame
+	if ((V->cache_Frame==Device.dwFrame) && (V->cache_DiscardID==RCache.Vertex.DiscardID()) && (vCount<=V->cache_vCount))	return;
+
+	item	I			= { V, 0, vCount };
+	items.push_back		(I);
+}
+
+void	__stdcall	CSkeletonXBatch::skin_MT	(u32 begin, u32 end, u32 worker_id)
+{
+	for (u32 it=begin; it<end; it++)	{
+		piece&	P		= pieces[it];
+		item&	I		= items	[P.item];
+		I.V->_Skin_range(I.D,P.begin,P.end);
+	}
+}
+
+void CSkeletonXBatch::flush		()
+{
+	// queued in an earlier frame by a phase which never rendered, the visuals may be gone
+	if (frame!=Device.dwFrame)	items.clear	();
+	if (items.empty())	return;
+
+	Device.Statistic->RenderDUMP_SKIN.Begin	();
+	_VertexStream&	_VS	= RCache.Vertex;
+	u32		stride		= sizeof(vertRender);
+	u32		it			= 0;
+	while (it<items.size())
+	{
+		// gather items for one lock, a single oversized item goes alone
+		u32		first	= it;
+		u32		total	= 0;
+		for (; it<items.size(); it++)	{
+			if ((it!=first) && (total+items[it].vCount>lock_budget))	break;
+			total		+= items[it].vCount;
+		}
+
+		u32			vOffset;
+		vertRender*	D		= (vertRender*)_VS.Lock(total,stride,vOffset);
+		u32			discard	= _VS.DiscardID();
+		pieces.clear		();
+		for (u32 i=first; i<it; i++)
+		{
+			item&		I		= items[i];
+			CSkeletonX*	V		= I.V;
+			I.D					= D;
+			V->cache_DiscardID	= discard;
+			V->cache_vCount		= I.vCount;
+			V->cache_vOffset	= vOffset;
+			V->cache_Frame		= Device.dwFrame;
+			D					+= I.vCount;
+			vOffset				+= I.vCount;
+			for (u32 b=0; b<I.vCount; b+=piece_size)	{
+				piece	P		= { i, b, _min(b+piece_size,I.vCount) };
+				pieces.push_back(P);
+			}
+		}
+		WorkerPool.parallel_for	(pieces.size(),1,CWorkerPool::range_callback(this,&CSkeletonXBatch::skin_MT));
+		_VS.Unlock				(total,stride);
+		Device.Statistic->RenderDUMP_SKIN_Verts	+= total;
+	}
+	items.clear			();
+	Device.Statistic->RenderDUMP_SKIN.End	();
+}
+
+//////////////////////////////////////////////////////////////////////
+template <class T>
+struct	skin_bench_task
+{
+	typedef void __stdcall	kernel	(vertRender* D, T* S, u32 vCount, CBoneInstance* Bones);
+	kernel*				K;
+	vertRender*			D;
+	T*					S;
+	CBoneInstance*		B;
+	void	__stdcall	run		(u32 begin, u32 end, u32 worker_id)	{ K(D+begin,S+begin,end-begin,B);	}
+	float				measure	(u32 vCount, BOOL bMT)
+	{
+		CTimer			timer;
+		timer.Start		();
+		for (u32 pass=0; pass<8; pass++)	{
+			if (bMT)	WorkerPool.parallel_for	(vCount,1024,CWorkerPool::range_callback(this,&skin_bench_task<T>::run));
+			else		K						(D,S,vCount,B);
+		}
+		float	sec		= timer.GetElapsed_sec();
+		return	(sec>0) ? float(8*vCount)/(sec*1000000.f) : 0;
+	}
+};
+
+void CSkeletonXBatch::benchmark	(u32 vCount)
+{
+	const u32				bone_count	= 64;
+	CRandom					rnd			(0x5eed);
+	xr_vector<CBoneInstance>	bones	(bone_count);
+	for (u32 b=0; b<bone_count; b++)	{
+		Fmatrix&	M		= bones[b].mRenderTransform;
+		M.setHPB			(rnd.randF(PI_MUL_2),rnd.randF(PI_MUL_2),rnd.randF(PI_MUL_2));
+		M.translate_over	(rnd.randFs(1.f),rnd.randFs(1.f),rnd.randFs(1.f));
+	}
+
+	xr_vector<vertBoned1W>	v1	(vCount);
+	xr_vector<vertBoned2W>	v2	(vCount);
+	xr_vector<vertBoned4W>	v4	(vCount);
+	for (u32 it=0; it<vCount; it++)	{
+		Fvector		P,N;
+		P.random_point		(1.f);
+		N.random_dir		();
+		v1[it].P.set(P); v1[it].N.set(N); v1[it].u = v1[it].v = 0.5f;
+		v1[it].matrix		= rnd.randI(bone_count);
+		v2[it].P.set(P); v2[it].N.set(N); v2[it].u = v2[it].v = 0.5f;
+		v2[it].matrix0		= u16(rnd.randI(bone_count));
+		v2[it].matrix1		= u16(rnd.randI(bone_count));
+		v2[it].w			= rnd.randF();
+		v4[it].P.set(P); v4[it].N.set(N); v4[it].u = v4[it].v = 0.5f;
+		for (u32 b=0; b<4; b++)	v4[it].m[b]	= u16(rnd.randI(bone_count));
+		v4[it].w[0]			= 0.4f;	v4[it].w[1] = 0.3f;	v4[it].w[2] = 0.2f;
+	}
+
+	// 16b aligned destination, like the locked stream
+	vertRender*				dest	= (vertRender*)xr_malloc(vCount*sizeof(vertRender));
+	skin_bench_task<vertBoned1W>	t1	= { PSGP.skin1W, dest, &*v1.begin(), &*bones.begin() };
+	skin_bench_task<vertBoned2W>	t2	= { PSGP.skin2W, dest, &*v2.begin(), &*bones.begin() };
+	skin_bench_task<vertBoned4W>	t4	= { PSGP.skin4W, dest, &*v4.begin(), &*bones.begin() };
+
+	Msg		("* skinning benchmark: %d vertices, %d thread(s), Mverts/sec",vCount,WorkerPool.workers());
+	Msg		("- 1W: %7.2f serial, %7.2f parallel",t1.measure(vCount,FALSE),t1.measure(vCount,TRUE));
+	Msg		("- 2W: %7.2f serial, %7.2f parallel",t2.measure(vCount,FALSE),t2.measure(vCount,TRUE));
+	Msg		("- 4W: %7.2f serial, %7.2f parallel",t4.measure(vCount,FALSE),t4.measure(vCount,TRUE));
+	xr_free	(dest);
+}
+
 //////////////////////////////////////////////////////////////////////
 void CSkeletonX::_Load	(const char* N, IReader *data, u32& dwVertCount) 
 {	
@@ -35,6 +35,17 @@ struct vertBoned2W			// (1+3+3 + 1+3+3 + 2)*4 = 16*4 = 64 bytes
 	float	u,v;
 	void	get_pos( Fvector& p ) { p.set(P); }
 };
+struct vertBoned4W			// (2+3+3+3+3+3+2)*4 = 19*4 = 76 bytes
+{
+	u16		m		[4];
+	Fvector	P;
+	Fvector	N;
+	Fvector	T;
+	Fvector	B;
+	float	w		[3];	// 4th weight is 1-w[0]-w[1]-w[2]
+	float	u,v;
+	void	get_pos( Fvector& p ) { p.set(P); }
+};
 struct vertRender			// T&B are not skinned, because in R2 skinning occurs always in hardware
 {
 	Fvector	P;
@@ -46,6 +57,8 @@ struct vertRender			// T&B are not skinned, because in R2 skinning occurs always
 struct SEnumVerticesCallback;
 class ENGINE_API	CSkeletonX
 {
+	friend class			CSkeletonXBatch;
+	friend struct			skin_task;
 protected:
 	enum					{ vertRenderFVF = D3DFVF_XYZ | D3DFVF_NORMAL | D3DFVF_TEX1		};
 	enum					{ RM_SKINNING_SOFT, RM_SINGLE, RM_SKINNING_1B, RM_SKINNING_2B	};
@@ -64,6 +77,7 @@ protected:
 			u32				cache_DiscardID;
 			u32				cache_vCount;
 			u32				cache_vOffset;
+			u32				cache_Frame;		// skinned data is valid for the whole frame
 		};
 		u32					RMS_boneid;			// single-bone-rendering
 		u32					RMS_bonecount;		// skinning, maximal bone ID
@@ -71,6 +85,9 @@ protected:
 
 	void					_Copy				(CSkeletonX *V);
 	void					_Render_soft		(ref_geom& hGeom, 	u32 vCount,	u32 iOffset, u32 pCount);
+	void					_Skin_soft			(vertRender* D,		u32 vCount);
+	void					_Skin_range			(vertRender* D,		u32 begin,	u32 end);
+	virtual u32				_SoftVertices		()					{ return 0;	}	// vertices the next soft render will need
 	void					_Render				(ref_geom& hGeom, 	u32 vCount,	u32 iOffset, u32 pCount);
 	void					_Load				(const char* N,		IReader *data,	u32& dwVertCount);
 
@@ -99,4 +116,30 @@ public:
 	virtual void			FillVertices	(const Fmatrix& view, CSkeletonWallmark& wm, const Fvector& normal, float size, u16 bone_id)=0;
 };
 
+// Software skinning of many visuals at once: one stream lock, vertex ranges are spread over worker threads.
+// Visuals skinned here are not skinned again by their own render during the same frame
+// (unless the stream gets discarded in between).
+class ENGINE_API	CSkeletonXBatch
+{
+	enum					{ piece_size = 512, lock_budget = 8192 };	// vertices
+	struct	item			{ CSkeletonX* V; vertRender* D; u32 vCount;	};
+	struct	piece			{ u32 item; u32 begin; u32 end;				};
+
+	xr_vector<item>			items		;
+	xr_vector<piece>		pieces		;
+	u32						frame		;
+private:
+	void	__stdcall		skin_MT		(u32 begin, u32 end, u32 worker_id);
+public:
+							CSkeletonXBatch	()	{ frame = 0;	}
+
+	void					add			(CSkeletonX* V);
+	void					flush		();
+	BOOL					empty		()	{ return items.empty();	}
+	void					clear		()	{ items.clear();		}
+
+	// synthetic 1W/2W/4W throughput: bound kernels serial vs. spread over workers
+	static void				benchmark	(u32 vCount);
+};
+
 #endif // SkeletonXH
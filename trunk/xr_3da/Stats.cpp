@@ -52,6 +52,23 @@ CStats::CStats	()
 	pFont				= 0;
 	fMem_calls			= 0;
 	RenderDUMP_DT_Count = 0;
+	RenderDUMP_SKIN_Verts = 0;
+	RenderDUMP_DT_Pending = 0;
+	ScriptGC_heap		= 0;
+	ScriptGC_step		= 0;
+	ScriptGC_full		= 0;
+	ScriptGC_pause		= 0;
+	clRAY_static		= 0;
+	clRAY_cached		= 0;
+	clRAY_batch			= 0;
+	clRAY_batch_rays	= 0;
+	ph_pairs			= 0;
+	ph_proxies			= 0;
+	TextureStream_resident	= 0;
+	TextureStream_pending	= 0;
+	ph_islands			= 0;
+	ph_islands_sum		= 0;
+	ph_islands_max		= 0;
 	Device.seqRender.Add		(this,REG_PRIORITY_LOW-1000);
 }
 
@@ -80,6 +97,7 @@ void CStats::Show()
 		UpdateClient.FrameEnd		();	
 		Physics.FrameEnd			();	
 		ph_collision.FrameEnd		();
+		ph_broadphase.FrameEnd		();
 		ph_core.FrameEnd			();
 		Animation.FrameEnd			();	
 		AI_Think.FrameEnd			();
@@ -89,10 +107,13 @@ void CStats::Show()
 		AI_Vis.FrameEnd				();
 		AI_Vis_Query.FrameEnd		();
 		AI_Vis_RayTests.FrameEnd	();
+		ScriptGC.FrameEnd			();
 		
 		RenderTOTAL.FrameEnd		();
 		RenderCALC.FrameEnd			();
 		RenderCALC_HOM.FrameEnd		();
+		RenderCALC_Static.FrameEnd	();
+		TextureStream.FrameEnd		();
 		RenderDUMP.FrameEnd			();	
 		RenderDUMP_RT.FrameEnd		();
 		RenderDUMP_SKIN.FrameEnd	();	
@@ -128,6 +149,8 @@ void CStats::Show()
 		g_SpatialSpace->stat_remove.FrameEnd		();
 		g_SpatialSpacePhysic->stat_insert.FrameEnd	();
 		g_SpatialSpacePhysic->stat_remove.FrameEnd	();
+		g_SpatialSpace->stat_update.FrameEnd		();
+		g_SpatialSpacePhysic->stat_update.FrameEnd	();
 	}
 
 	// calc FPS & TPS
@@ -216,9 +239,12 @@ void CStats::Show()
 		F.OutNext	("uParticles:  Qstart[%d] Qactive[%d] Qdestroy[%d]",	Particles_starting,Particles_active,Particles_destroy);
 		F.OutNext	("spInsert:    o[%.2fms, %2.1f%%], p[%.2fms, %2.1f%%]",	g_SpatialSpace->stat_insert.result, PPP(g_SpatialSpace->stat_insert.result),	g_SpatialSpacePhysic->stat_insert.result, PPP(g_SpatialSpacePhysic->stat_insert.result));
 		F.OutNext	("spRemove:    o[%.2fms, %2.1f%%], p[%.2fms, %2.1f%%]",	g_SpatialSpace->stat_remove.result, PPP(g_SpatialSpace->stat_remove.result),	g_SpatialSpacePhysic->stat_remove.result, PPP(g_SpatialSpacePhysic->stat_remove.result));
+		F.OutNext	("spMove:      o[%.2fms, %d], p[%.2fms, %d]",	g_SpatialSpace->stat_update.result, g_SpatialSpace->stat_moved,	g_SpatialSpacePhysic->stat_update.result, g_SpatialSpacePhysic->stat_moved);
 		F.OutNext	("Physics:     %2.2fms, %2.1f%%",Physics.result,		PPP(Physics.result));	
 		F.OutNext	("  collider:  %2.2fms", ph_collision.result);	
+		F.OutNext	("  broadph:   %2.2fms, %d pairs, %d objects",ph_broadphase.result,ph_pairs,ph_proxies);
 		F.OutNext	("  solver:    %2.2fms, %d",ph_core.result,ph_core.count);	
+		F.OutNext	("  islands:   %d, %2.2fms, max %2.2fms",ph_islands,ph_islands_sum,ph_islands_max);
 		F.OutNext	("aiThink:     %2.2fms, %d",AI_Think.result,AI_Think.count);	
 		F.OutNext	("  aiRange:   %2.2fms, %d",AI_Range.result,AI_Range.count);
 		F.OutNext	("  aiPath:    %2.2fms, %d",AI_Path.result,AI_Path.count);
@@ -226,6 +252,7 @@ void CStats::Show()
 		F.OutNext	("aiVision:    %2.2fms, %d",AI_Vis.result,AI_Vis.count);
 		F.OutNext	("  Query:     %2.2fms",	AI_Vis_Query.result);
 		F.OutNext	("  RayCast:   %2.2fms",	AI_Vis_RayTests.result);
+		F.OutNext	("luaGC:       %2.2fms, %dK step, %dK heap, full(%d) %2.1fms",ScriptGC.result,ScriptGC_step,ScriptGC_heap,ScriptGC_full,ScriptGC_pause);
 		F.OutSkip	();
 								   
 #undef  PPP
@@ -233,14 +260,17 @@ void CStats::Show()
 		F.OutNext	("*** RENDER:  %2.2fms",RenderTOTAL.result);
 		F.OutNext	("R_CALC:      %2.2fms, %2.1f%%",RenderCALC.result,	PPP(RenderCALC.result));	
 		F.OutNext	("  HOM:       %2.2fms, %d",RenderCALC_HOM.result,	RenderCALC_HOM.count);
+		F.OutNext	("  Static:    %2.2fms, %d",RenderCALC_Static.result,RenderCALC_Static.count);
 		F.OutNext	("  Skeletons: %2.2fms, %d",Animation.result,		Animation.count);
+		F.OutNext	("  Textures:  %2.2fms, %dK, pending %d",TextureStream.result,TextureStream_resident,TextureStream_pending);
 		F.OutNext	("R_DUMP:      %2.2fms, %2.1f%%",RenderDUMP.result,	PPP(RenderDUMP.result));	
 		F.OutNext	("  Wait-L:    %2.2fms",RenderDUMP_Wait.result);	
 		F.OutNext	("  Wait-S:    %2.2fms",RenderDUMP_Wait_S.result);	
-		F.OutNext	("  Skinning:  %2.2fms",RenderDUMP_SKIN.result);	
+		F.OutNext	("  Skinning:  %2.2fms, %d verts, %2.1fMv/s",RenderDUMP_SKIN.result,RenderDUMP_SKIN_Verts,
+			(RenderDUMP_SKIN.result>0)?float(RenderDUMP_SKIN_Verts)/(RenderDUMP_SKIN.result*1000.f):0.f);	
 		F.OutNext	("  DT_Vis/Cnt:%2.2fms",RenderDUMP_DT_VIS.result,RenderDUMP_DT_Count);	
 		F.OutNext	("  DT_Render: %2.2fms",RenderDUMP_DT_Render.result);	
-		F.OutNext	("  DT_Cache:  %2.2fms",RenderDUMP_DT_Cache.result);	
+		F.OutNext	("  DT_Cache:  %2.2fms, pending(%d)",RenderDUMP_DT_Cache.result,RenderDUMP_DT_Pending);	
 		F.OutNext	("  Wallmarks: %2.2fms, %d/%d - %d",RenderDUMP_WM.result,RenderDUMP_WMS_Count,RenderDUMP_WMD_Count,RenderDUMP_WMT_Count);
 		F.OutNext	("  Glows:     %2.2fms",RenderDUMP_Glows.result);	
 		F.OutNext	("  Lights:    %2.2fms, %d",RenderDUMP_Lights.result,RenderDUMP_Lights.count);
@@ -256,6 +286,7 @@ void CStats::Show()
 		F.OutSkip	();
 		F.OutNext	("Input:       %2.2fms",Input.result);
 		F.OutNext	("clRAY:       %2.2fms, %d, %2.0fK",clRAY.result,		clRAY.count,r_ps);
+		F.OutNext	("  cached:    %d/%d, %2.0f%%, batch %d/%d",clRAY_cached,clRAY_static,clRAY_static?100.f*float(clRAY_cached)/float(clRAY_static):0.f,clRAY_batch,clRAY_batch_rays);
 		F.OutNext	("clBOX:       %2.2fms, %d, %2.0fK",clBOX.result,		clBOX.count,b_ps);
 		F.OutNext	("clFRUSTUM:   %2.2fms, %d",		clFRUSTUM.result,	clFRUSTUM.count	);
 		F.OutSkip	();
@@ -365,7 +396,12 @@ void CStats::Show()
 		UpdateClient.FrameStart		();	
 		Physics.FrameStart			();	
 		ph_collision.FrameStart		();
+		ph_broadphase.FrameStart	();
+		ph_pairs					= 0;
 		ph_core.FrameStart			();
+		ph_islands					= 0;
+		ph_islands_sum				= 0;
+		ph_islands_max				= 0;
 		Animation.FrameStart		();	
 		AI_Think.FrameStart			();
 		AI_Range.FrameStart			();
@@ -374,13 +410,17 @@ void CStats::Show()
 		AI_Vis.FrameStart			();
 		AI_Vis_Query.FrameStart		();
 		AI_Vis_RayTests.FrameStart	();
+		ScriptGC.FrameStart			();
 		
 		RenderTOTAL.FrameStart		();
 		RenderCALC.FrameStart		();
 		RenderCALC_HOM.FrameStart	();
+		RenderCALC_Static.FrameStart();
+		TextureStream.FrameStart	();
 		RenderDUMP.FrameStart		();	
 		RenderDUMP_RT.FrameStart	();
 		RenderDUMP_SKIN.FrameStart	();	
+		RenderDUMP_SKIN_Verts		= 0;
 		RenderDUMP_Wait.FrameStart	();	
 		RenderDUMP_Wait_S.FrameStart();	
 		RenderDUMP_HUD.FrameStart	();	
@@ -397,6 +437,10 @@ void CStats::Show()
 		Sound.FrameStart			();
 		Input.FrameStart			();
 		clRAY.FrameStart			();	
+		clRAY_static				= 0;
+		clRAY_cached				= 0;
+		clRAY_batch					= 0;
+		clRAY_batch_rays			= 0;
 		clBOX.FrameStart			();
 		clFRUSTUM.FrameStart		();
 		
@@ -414,6 +458,10 @@ void CStats::Show()
 
 		g_SpatialSpacePhysic->stat_insert.FrameStart();
 		g_SpatialSpacePhysic->stat_remove.FrameStart();
+		g_SpatialSpace->stat_update.FrameStart		();
+		g_SpatialSpacePhysic->stat_update.FrameStart();
+		g_SpatialSpace->stat_moved					= 0;
+		g_SpatialSpacePhysic->stat_moved			= 0;
 	}
 	dwSND_Played = dwSND_Allocated = 0;
 	Particles_starting = Particles_active = Particles_destroy = 0;
@@ -33,7 +33,13 @@ public:
 	u32			Particles_destroy;	// destroying
 	CStatTimer	Physics;			// movement+collision
 	CStatTimer	ph_collision;		// collision
+	CStatTimer	ph_broadphase;		// collision - pair search
+	u32			ph_pairs;			// broadphase pairs
+	u32			ph_proxies;			// broadphase objects
 	CStatTimer	ph_core;			// collision
+	u32			ph_islands;			// stepped islands
+	float		ph_islands_sum;		// (ms) solver time summed over islands
+	float		ph_islands_max;		// (ms) the costliest island
 	CStatTimer	AI_Think;			// thinking
 	CStatTimer	AI_Range;			// query: range
 	CStatTimer	AI_Path;			// query: path
@@ -41,17 +47,27 @@ public:
 	CStatTimer	AI_Vis;				// visibility detection - total
 	CStatTimer	AI_Vis_Query;		// visibility detection - portal traversal and frustum culling
 	CStatTimer	AI_Vis_RayTests;	// visibility detection - ray casting
+	CStatTimer	ScriptGC;			// lua garbage collection steps
+	u32			ScriptGC_heap;		// (Kb) lua heap after the step
+	u32			ScriptGC_step;		// (Kb) step size
+	u32			ScriptGC_full;		// full collections
+	float		ScriptGC_pause;		// (ms) the last full collection
 
 	CStatTimer	RenderTOTAL;		// 
 	CStatTimer	RenderTOTAL_Real;	
 	CStatTimer	RenderCALC;			// portal traversal, frustum culling, entities "renderable_Render"
 	CStatTimer	RenderCALC_HOM;		// HOM rendering
+	CStatTimer	RenderCALC_Static;	// static geometry traversal and scene graph merge
 	CStatTimer	Animation;			// skeleton calculation
+	CStatTimer	TextureStream;		// texture streaming: residency and surface replacement
+	u32			TextureStream_resident;// (Kb) of the streamed textures
+	u32			TextureStream_pending;// ...requests to the loader
 	CStatTimer	RenderDUMP;			// actual primitive rendering
 	CStatTimer	RenderDUMP_Wait;	// ...waiting something back (queries results, etc.)
 	CStatTimer	RenderDUMP_Wait_S;	// ...frame-limit sync
 	CStatTimer	RenderDUMP_RT;		// ...render-targets
 	CStatTimer	RenderDUMP_SKIN;	// ...skinning
+	u32			RenderDUMP_SKIN_Verts;// ...number of soft-skinned vertices
 	CStatTimer	RenderDUMP_HUD;		// ...hud rendering
 	CStatTimer	RenderDUMP_Glows;	// ...glows vis-testing,sorting,render
 	CStatTimer	RenderDUMP_Lights;	// ...d-lights building/rendering
@@ -63,6 +79,7 @@ public:
 	CStatTimer	RenderDUMP_DT_Render;// ...details rendering
 	CStatTimer	RenderDUMP_DT_Cache;// ...details slot cache access
 	u32			RenderDUMP_DT_Count;// ...number of DT-elements
+	u32			RenderDUMP_DT_Pending;// ...number of DT-slots still waiting for decompression
 	CStatTimer	RenderDUMP_Pcalc;	// ...projectors	building
 	CStatTimer	RenderDUMP_Scalc;	// ...shadows		building
 	CStatTimer	RenderDUMP_Srender;	// ...shadows		render
@@ -70,6 +87,10 @@ public:
 	CStatTimer	Sound;				// total time taken by sound subsystem (accurate only in single-threaded mode)
 	CStatTimer	Input;				// total time taken by input subsystem (accurate only in single-threaded mode)
 	CStatTimer	clRAY;				// total: ray-testing
+	u32			clRAY_static;		// single hit static queries of CObjectSpace
+	u32			clRAY_cached;		// ... served from the frame cache
+	u32			clRAY_batch;		// RayTestBatch calls
+	u32			clRAY_batch_rays;	// 
 	CStatTimer	clBOX;				// total: box query
 	CStatTimer	clFRUSTUM;			// total: frustum query
 	
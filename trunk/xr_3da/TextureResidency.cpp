@@ -0,0 +1,152 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+#include "TextureResidency.h"
+
+namespace	dds
+{
+	enum	{
+		magic			= 0x20534444,	// "DDS "
+		flag_pitch		= 0x00000008,
+		flag_mipmaps	= 0x00020000,
+		flag_linearsize	= 0x00080000,
+		pf_alpha		= 0x00000002,
+		pf_fourcc		= 0x00000004,
+		pf_rgb			= 0x00000040,
+		pf_luminance	= 0x00020000,
+		caps2_cubemap	= 0x00000200,
+		caps2_volume	= 0x00200000,
+	};
+	struct	header
+	{
+		u32		magic;
+		u32		size;
+		u32		flags;
+		u32		height;
+		u32		width;
+		u32		pitch;
+		u32		depth;
+		u32		mips;
+		u32		reserved1	[11];
+		u32		pf_size;
+		u32		pf_flags;
+		u32		pf_fourcc;
+		u32		pf_bits;
+		u32		pf_masks	[4];
+		u32		caps		[4];
+		u32		reserved2;
+	};
+};
+
+bool dds_layout::parse		(const void* data, u32 length)
+{
+	STATIC_CHECK			(sizeof(dds::header)==header_size,Wrong_DDS_header_size);
+	if (length<header_size)	return false;
+	const dds::header&	H	= *(const dds::header*)data;
+	if (H.magic!=dds::magic || H.size!=header_size-4)		return false;
+	if (H.caps[1]&(dds::caps2_cubemap|dds::caps2_volume))	return false;
+
+	u32		block			= 0;
+	bits					= 0;
+	if (H.pf_flags&dds::pf_fourcc)	{
+		switch (H.pf_fourcc)	{
+		case MAKEFOURCC('D','X','T','1'):	block = 8;	break;
+		case MAKEFOURCC('D','X','T','2'):
+		case MAKEFOURCC('D','X','T','3'):
+		case MAKEFOURCC('D','X','T','4'):
+		case MAKEFOURCC('D','X','T','5'):	block = 16;	break;
+		default:							return false;
+		}
+	} else if (H.pf_flags&(dds::pf_rgb|dds::pf_luminance|dds::pf_alpha))	{
+		bits				= H.pf_bits;
+		if (0==bits || (bits%8))							return false;
+	} else													return false;
+
+	width					= H.width;
+	height					= H.height;
+	mips					= ((H.flags&dds::flag_mipmaps) && H.mips) ? H.mips : 1;
+	if (0==width || 0==height || mips>max_mips)				return false;
+
+	u32		pos				= header_size;
+	for (u32 m=0; m<mips; ++m)
+	{
+		u32	w				= _max(width>>m,u32(1));
+		u32	h				= _max(height>>m,u32(1));
+		size[m]				= block ? ((w+3)/4)*((h+3)/4)*block : w*h*(bits/8);
+		offset[m]			= pos;
+		pos					+= size[m];
+	}
+	return	pos<=length;
+}
+
+void dds_layout::slice		(const void* data, u32 lod, void* dest) const
+{
+	VERIFY					(lod<mips);
+	dds::header		H		= *(const dds::header*)data;
+	H.width					= _max(width>>lod,u32(1));
+	H.height				= _max(height>>lod,u32(1));
+	H.mips					= mips-lod;
+	H.flags					|= dds::flag_mipmaps;
+	if (H.flags&dds::flag_linearsize)	H.pitch	= size[lod];
+	else if (H.flags&dds::flag_pitch)	H.pitch	= H.width*(bits/8);
+	CopyMemory				(dest,&H,header_size);
+	CopyMemory				((u8*)dest+header_size,(const u8*)data+offset[lod],resident_size(lod));
+}
+
+u32 dds_layout::lod_of		(u32 _width, u32 _height) const
+{
+	for (u32 lod=0; lod<mips; ++lod)
+		if (_max(width>>lod,u32(1))==_width && _max(height>>lod,u32(1))==_height)	return lod;
+	return	u32(-1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// the mip whose size is the closest to the screen one from above
+u32 CTextureResidency::requested_lod	(const dds_layout& L, float pixels)
+{
+	u32		lod				= 0;
+	while (lod+1<L.mips && float(L.dim(lod+1))>=pixels)	++lod;
+	return	lod;
+}
+
+u32 CTextureResidency::lowest_lod		(const dds_layout& L, u32 min_dim)
+{
+	u32		lod				= 0;
+	while (lod+1<L.mips && L.dim(lod+1)>=min_dim)		++lod;
+	return	lod;
+}
+
+u32 CTextureResidency::fit				(xr_vector<item>& items, u32 budget)
+{
+	u32		total			= 0;
+	m_heap.clear_not_free	();
+	for (u32 it=0; it<items.size(); ++it)
+	{
+		item&	I			= items[it];
+		u32		lod_max		= _max(I.lod_max,I.lod_min);
+		I.target			= _min(I.requested,I.resident);
+		I.target			= _min(_max(I.target,I.lod_min),lod_max);
+		total				+= I.layout->resident_size(I.target);
+		if (I.target<lod_max)	m_heap.push_back(mk_pair(I.priority/float(I.layout->dim(I.target)),it));
+	}
+	if (total<=budget)		return total;
+
+	// a dropped mip halves the texels - the texture becomes twice less oversampled
+	std::greater<std::pair<float,u32> >	pred;
+	std::make_heap			(m_heap.begin(),m_heap.end(),pred);
+	while (total>budget && !m_heap.empty())
+	{
+		std::pop_heap		(m_heap.begin(),m_heap.end(),pred);
+		std::pair<float,u32>	top	= m_heap.back();
+		m_heap.pop_back		();
+
+		item&	I			= items[top.second];
+		total				-= I.layout->size[I.target];
+		++I.target;
+		if (I.target<_max(I.lod_max,I.lod_min))	{
+			m_heap.push_back(mk_pair(top.first*2.f,top.second));
+			std::push_heap	(m_heap.begin(),m_heap.end(),pred);
+		}
+	}
+	return	total;
+}
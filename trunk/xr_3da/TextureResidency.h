@@ -0,0 +1,53 @@
+#ifndef TextureResidencyH
+#define TextureResidencyH
+#pragma once
+
+// Mip chain of a 2D DDS file. The mips are stored from the largest one on, so the tail of the
+// file starting at the needed mip, prefixed with the patched header, is a valid DDS itself.
+// Cube maps, volumes and the formats whose size can't be derived from the header are rejected.
+struct	dds_layout
+{
+	enum	{
+		max_mips		= 16,
+		header_size		= 128,			// magic + DDSURFACEDESC2
+	};
+	u32			width;
+	u32			height;
+	u32			mips;
+	u32			bits;					// per pixel, 0 - block compressed
+	u32			offset		[max_mips];	// of the mip in the file
+	u32			size		[max_mips];
+
+	bool		parse			(const void* data, u32 length);
+	IC u32		dim				(u32 lod) const		{ return _max(_max(width,height)>>lod,u32(1));		}
+	IC u32		resident_size	(u32 lod) const		{ return offset[mips-1]+size[mips-1]-offset[lod];	}	// mips from lod on
+	IC u32		slice_size		(u32 lod) const		{ return header_size+resident_size(lod);			}
+	void		slice			(const void* data, u32 lod, void* dest) const;
+	u32			lod_of			(u32 _width, u32 _height) const;								// u32(-1) - none
+};
+
+// Residency policy, no device involved. Every texture gets the lod requested by its screen-space
+// size, but keeps the better resident one until the memory is needed; while over the budget the
+// most oversampled textures (the least screen pixels per texel of the target mip) lose a mip each.
+class	CTextureResidency
+{
+public:
+	struct	item
+	{
+		const dds_layout*	layout;
+		u32					lod_min;	// the best one allowed
+		u32					lod_max;	// the worst one allowed
+		u32					resident;
+		u32					requested;
+		float				priority;	// screen pixels covered
+		u32					target;		// out
+	};
+private:
+	xr_vector<std::pair<float,u32> >	m_heap;
+public:
+	static	u32				requested_lod	(const dds_layout& L, float pixels);
+	static	u32				lowest_lod		(const dds_layout& L, u32 min_dim);
+			u32				fit				(xr_vector<item>& items, u32 budget);	// bytes resident at the targets
+};
+
+#endif
@@ -0,0 +1,287 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+#pragma warning(disable:4995)
+#include <d3dx9.h>
+#pragma warning(default:4995)
+
+#include "ResourceManager.h"
+
+bool	texture_find_dds		(LPCSTR name, string_path& fn);
+
+static const u32	max_in_flight	= 8;
+static const u32	upload_limit	= 4*1024*1024;	// bytes of surfaces created per frame
+static const u32	min_dim			= 64;			// the smallest mip streamed down to
+static const float	decay_rate		= 0.5f;			// of the screen-space size of unused textures, per second
+
+CTextureStreaming::CTextureStreaming	()
+{
+	m_resident				= 0;
+	m_in_flight				= 0;
+	m_exit					= FALSE;
+	m_thread				= FALSE;
+	m_work					= CreateEvent(NULL,FALSE,FALSE,NULL);
+	m_exited				= CreateEvent(NULL,TRUE,FALSE,NULL);
+}
+
+CTextureStreaming::~CTextureStreaming	()
+{
+	stop					();
+	CloseHandle				(m_work);
+	CloseHandle				(m_exited);
+}
+
+void CTextureStreaming::stop			()
+{
+	if (!m_thread)			return;
+	m_exit					= TRUE;
+	SetEvent				(m_work);
+	WaitForSingleObject		(m_exited,INFINITE);
+	m_thread				= FALSE;
+
+	for (xr_deque<request>::iterator it=m_queue.begin(); it!=m_queue.end(); ++it)
+		if (it->source)		FS.r_close(it->source);
+	for (u32 it=0; it<m_done.size(); ++it)		xr_free(m_done[it].data);
+	for (u32 it=0; it<m_complete.size(); ++it)	xr_free(m_complete[it].data);
+	m_queue.clear			();
+	m_done.clear			();
+	m_complete.clear		();
+	m_in_flight				= 0;
+}
+
+bool CTextureStreaming::resolve			(CTexture* T, string_path& fn)
+{
+	return					texture_find_dds(*T->cName,fn);
+}
+
+void CTextureStreaming::add				(CTexture* T)
+{
+	if (T->m_stream!=u32(-1))				return;
+	if (!T->flags.bLoaded || !T->pSurface)	return;		// tried again on the next use
+
+	u32		id;
+	if (m_free.empty())		{
+		id					= m_entries.size();
+		m_entries.push_back	(entry());
+		m_entries.back().stamp	= 0;
+	} else {
+		id					= m_free.back();
+		m_free.pop_back		();
+	}
+	entry&	E				= m_entries[id];
+	E.texture				= T;
+	E.lod_min				= 0;
+	E.resident				= 0;
+	E.pixels				= 0;
+	T->m_stream				= id;
+
+	bool	plain			= !T->flags.bUser && T->seqDATA.empty() && !T->pAVI && !T->pTheora && (D3DRTYPE_TEXTURE==T->pSurface->GetType());
+	if (!plain || !resolve(T,E.file))	{
+		E.state				= es_disabled;
+		return;
+	}
+	E.state					= es_probe;
+	enqueue					(id,u32(-1));
+}
+
+void CTextureStreaming::remove			(CTexture* T)
+{
+	u32		id				= T->m_stream;
+	T->m_stream				= u32(-1);
+	if (id>=m_entries.size() || m_entries[id].texture!=T)	return;
+	entry&	E				= m_entries[id];
+	E.texture				= NULL;
+	++E.stamp;
+	m_free.push_back		(id);
+}
+
+void CTextureStreaming::enqueue			(u32 id, u32 lod)
+{
+	const entry&	E		= m_entries[id];
+	request			R;
+	R.entry					= id;
+	R.stamp					= E.stamp;
+	R.lod					= lod;
+	strcpy_s				(R.file,E.file);
+	R.source				= FS.r_open(R.file);
+	R.data					= 0;
+	R.size					= 0;
+	R.result				= false;
+
+	m_lock.Enter			();
+	m_queue.push_back		(R);
+	m_lock.Leave			();
+	++m_in_flight;
+
+	if (!m_thread)			{
+		m_thread			= TRUE;
+		m_exit				= FALSE;
+		ResetEvent			(m_exited);
+		thread_spawn		(loader,"X-RAY texture streaming",0,this);
+	}
+	SetEvent				(m_work);
+}
+
+void CTextureStreaming::loader			(void* params)
+{
+	CTextureStreaming*	self	= (CTextureStreaming*)params;
+	while (!self->m_exit)
+	{
+		request		R;
+		self->m_lock.Enter	();
+		bool		idle	= self->m_queue.empty();
+		if (!idle)	{
+			R				= self->m_queue.front();
+			self->m_queue.pop_front	();
+		}
+		self->m_lock.Leave	();
+		if (idle)	{
+			WaitForSingleObject	(self->m_work,INFINITE);
+			continue;
+		}
+
+		self->load			(R);
+		self->m_lock.Enter	();
+		self->m_done.push_back	(R);
+		self->m_lock.Leave	();
+	}
+	SetEvent				(self->m_exited);
+}
+
+// loader thread: only the file is touched, the entry may be gone already
+void CTextureStreaming::load			(request& R)
+{
+	IReader*	F			= R.source;
+	R.source				= 0;
+	if (!F)					return;
+	if (R.layout.parse(F->pointer(),F->length()))
+	{
+		if (u32(-1)==R.lod)				R.result	= true;
+		else if (R.lod<R.layout.mips)	{
+			R.size			= R.layout.slice_size(R.lod);
+			R.data			= xr_malloc(R.size);
+			R.layout.slice	(F->pointer(),R.lod,R.data);
+			R.result		= true;
+		}
+	}
+	FS.r_close				(F);
+}
+
+// render thread: returns the bytes uploaded
+u32 CTextureStreaming::complete			(request& R)
+{
+	--m_in_flight;
+	u32		uploaded		= 0;
+	entry*	E				= 0;
+	if (R.entry<m_entries.size() && m_entries[R.entry].texture && m_entries[R.entry].stamp==R.stamp)
+		E					= &m_entries[R.entry];
+
+	if (E && u32(-1)==R.lod)
+	{
+		// the surface could be loaded with texture_lod applied, that is the best lod streamed back
+		CTexture*	T		= E->texture;
+		u32		lod			= R.result ? R.layout.lod_of(T->get_Width(),T->get_Height()) : u32(-1);
+		if (u32(-1)==lod)	E->state	= es_disabled;
+		else	{
+			E->layout		= R.layout;
+			E->lod_min		= lod;
+			E->resident		= lod;
+			E->state		= es_ready;
+		}
+	}
+	else if (E)
+	{
+		IDirect3DTexture9*	surface	= 0;
+		D3DXIMAGE_INFO		IMG;
+		if (R.result
+			&& SUCCEEDED(D3DXGetImageInfoFromFileInMemory(R.data,R.size,&IMG))
+			&& SUCCEEDED(D3DXCreateTextureFromFileInMemoryEx(
+				HW.pDevice,R.data,R.size,
+				D3DX_DEFAULT,D3DX_DEFAULT,
+				IMG.MipLevels,0,
+				IMG.Format,
+				D3DPOOL_MANAGED,
+				D3DX_DEFAULT,
+				D3DX_DEFAULT,
+				0,&IMG,0,
+				&surface)))
+		{
+			E->texture->surface_set			(surface);
+			_RELEASE						(surface);
+			E->texture->flags.MemoryUsage	= E->layout.resident_size(R.lod);
+			E->resident		= R.lod;
+			E->state		= es_ready;
+			uploaded		= R.size;
+		} else {
+			Msg				("! Can't stream texture '%s'",R.file);
+			E->state		= es_disabled;
+		}
+	}
+	xr_free					(R.data);
+	return					uploaded;
+}
+
+void CTextureStreaming::update			()
+{
+	if (m_entries.size()==m_free.size())	return;
+	Device.Statistic->TextureStream.Begin	();
+
+	// surfaces of the completed requests
+	m_lock.Enter			();
+	m_complete.insert		(m_complete.end(),m_done.begin(),m_done.end());
+	m_done.clear_not_free	();
+	m_lock.Leave			();
+	u32		uploaded		= 0;
+	u32		done			= 0;
+	for (; done<m_complete.size() && uploaded<upload_limit; ++done)
+		uploaded			+= complete(m_complete[done]);
+	m_complete.erase		(m_complete.begin(),m_complete.begin()+done);
+
+	// screen-space use of the frame: radius/distance to the pixels across
+	float	proj			= float(Device.dwHeight)/tanf(deg2rad(Device.fFOV)*0.5f)*psTextureStreamScale;
+	float	decay			= _max(0.f,1.f-Device.fTimeDelta*decay_rate);
+	m_items.clear_not_free			();
+	m_items_entry.clear_not_free	();
+	for (u32 id=0; id<m_entries.size(); ++id)
+	{
+		entry&	E			= m_entries[id];
+		if (!E.texture || (es_ready!=E.state && es_load!=E.state))	continue;
+		CTexture*	T		= E.texture;
+		float	pixels		= (T->m_stream_frame==Device.dwFrame) ? proj*T->m_stream_size : 0.f;
+		E.pixels			= _max(pixels,E.pixels*decay);
+
+		CTextureResidency::item	I;
+		I.layout			= &E.layout;
+		I.lod_min			= E.lod_min;
+		I.lod_max			= CTextureResidency::lowest_lod(E.layout,min_dim);
+		I.resident			= E.resident;
+		I.requested			= psTextureStreamBudget ? CTextureResidency::requested_lod(E.layout,E.pixels) : E.lod_min;
+		I.priority			= E.pixels;
+		m_items.push_back		(I);
+		m_items_entry.push_back	(id);
+	}
+	u32		budget			= psTextureStreamBudget ? u32(psTextureStreamBudget)<<20 : u32(-1);
+	m_resident				= m_policy.fit(m_items,budget);
+
+	// downgrades first - they free the memory, then the most undersampled textures
+	m_candidates.clear_not_free	();
+	for (u32 it=0; it<m_items.size(); ++it)
+	{
+		const CTextureResidency::item&	I	= m_items[it];
+		if (I.target==I.resident || es_ready!=m_entries[m_items_entry[it]].state)	continue;
+		float	urgency		= (I.target>I.resident) ? flt_max : I.priority/float(I.layout->dim(I.resident));
+		m_candidates.push_back	(mk_pair(urgency,it));
+	}
+	std::sort				(m_candidates.begin(),m_candidates.end(),std::greater<std::pair<float,u32> >());
+	for (u32 it=0; it<m_candidates.size() && m_in_flight<max_in_flight; ++it)
+	{
+		u32		item		= m_candidates[it].second;
+		u32		id			= m_items_entry[item];
+		m_entries[id].state	= es_load;
+		enqueue				(id,m_items[item].target);
+	}
+
+	Device.Statistic->TextureStream_resident	= m_resident/1024;
+	Device.Statistic->TextureStream_pending		= m_in_flight;
+	Device.Statistic->TextureStream.End		();
+}
@@ -0,0 +1,81 @@
+#ifndef TextureStreamingH
+#define TextureStreamingH
+#pragma once
+
+#include "TextureResidency.h"
+
+class ENGINE_API CTexture;
+
+// Keeps the mip chains of the textures used by the scene graph within texture_stream_budget (Mb).
+// A texture is registered on its first use in the main view and its file is probed by the loader
+// thread; from then on the loader reads the file from the mip the policy chose and the surface is
+// replaced on the render thread at the end of the frame. The lod the texture was loaded with
+// (texture_lod) is the best one streamed back. Only plain 2D DDS textures take part, the budget
+// does not cover the others.
+class CTextureStreaming
+{
+private:
+	enum	{
+		es_probe,						// the layout is being read
+		es_ready,
+		es_load,						// a mip chain is being read
+		es_disabled,					// not streamable
+	};
+	struct	entry
+	{
+		CTexture*			texture;	// NULL - free
+		u32					stamp;		// bumped on remove, the requests of the previous owner are dropped
+		u32					state;
+		string_path			file;
+		dds_layout			layout;
+		u32					lod_min;
+		u32					resident;
+		float				pixels;		// screen-space size of the use, decays
+	};
+	struct	request
+	{
+		u32					entry;
+		u32					stamp;
+		u32					lod;		// u32(-1) - probe
+		string_path			file;
+		IReader*			source;		// opened on the render thread, the file list of FS is not locked
+		dds_layout			layout;
+		void*				data;		// DDS from the lod
+		u32					size;
+		bool				result;
+	};
+private:
+	xr_vector<entry>				m_entries;
+	xr_vector<u32>					m_free;
+	xr_vector<CTextureResidency::item>	m_items;
+	xr_vector<u32>					m_items_entry;
+	xr_vector<std::pair<float,u32> >	m_candidates;
+	CTextureResidency				m_policy;
+	u32								m_resident;
+	u32								m_in_flight;
+
+	// loader
+	xr_deque<request>				m_queue;		// guarded
+	xr_vector<request>				m_done;			// guarded
+	xr_vector<request>				m_complete;		// render thread
+	xrCriticalSection				m_lock;
+	HANDLE							m_work;
+	HANDLE							m_exited;
+	volatile BOOL					m_exit;
+	BOOL							m_thread;
+private:
+	static	void					loader			(void* params);
+			void					load			(request& R);
+			void					enqueue			(u32 id, u32 lod);
+			u32						complete		(request& R);
+			bool					resolve			(CTexture* T, string_path& fn);
+			void					stop			();
+public:
+									CTextureStreaming	();
+									~CTextureStreaming	();
+			void					add				(CTexture* T);
+			void					remove			(CTexture* T);
+			void					update			();
+};
+
+#endif
@@ -13,3 +13,5 @@ Flags32		psDeviceFlags		= {rsFullscreen|rsDetails|mtPhysics|mtSound|mtNetwork|rs
 
 // textures 
 int			psTextureLOD		= 0;
+int			psTextureStreamBudget	= 256;
+float		psTextureStreamScale	= 1.f;
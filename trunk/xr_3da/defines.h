@@ -12,6 +12,8 @@
 
 // textures
 ENGINE_API extern	int		psTextureLOD		;
+ENGINE_API extern	int		psTextureStreamBudget	;	// Mb, 0 - no streaming
+ENGINE_API extern	float	psTextureStreamScale	;	// texels wanted per screen pixel
 
 // psDeviceFlags
 enum {
@@ -95,6 +95,8 @@ void CRenderDevice::End		(void)
 		}
 	}
 
+	Resources->m_textures_streaming.update			();
+
 	g_bRendering		= FALSE;
 	// end scene
 	RCache.OnFrameEnd	();
@@ -127,7 +127,16 @@ void InitSettings	()
 {
 	string_path					fname; 
 	FS.update_path				(fname,"$game_config$","system.ltx");
-	pSettings					= xr_new<CInifile>	(fname,TRUE);
+	if (strstr(Core.Params,"-no_ltx_cache"))
+		pSettings				= xr_new<CInifile>	(fname,TRUE);
+	else {
+		// resolved includes and inheritance, rebuilt when any of the source files changes
+		string_path				cache_name;
+		if (!FS.path_exist("$ltx_cache$"))
+			FS.append_path		("$ltx_cache$",FS.get_path("$app_data_root$")->m_Path,"ltx_cache\\",TRUE);
+		FS.update_path			(cache_name,"$ltx_cache$","system.ltx.bin");
+		pSettings				= CInifile::Create_cached(fname,cache_name);
+	}
 	CHECK_OR_EXIT				(!pSettings->sections().empty(),make_string("Cannot find file %s.\nReinstalling application may fix this problem.",fname));
 
 	FS.update_path				(fname,"$game_config$","game.ltx");
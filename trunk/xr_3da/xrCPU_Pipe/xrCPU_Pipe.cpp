@@ -16,10 +16,12 @@ BOOL APIENTRY DllMain( HANDLE hModule,
 
 extern xrSkin1W			xrSkin1W_x86;
 extern xrSkin1W			xrSkin1W_3DNow;
-// extern xrSkin1W		xrSkin1W_SSE;
+extern xrSkin1W			xrSkin1W_SSE;
 extern xrSkin2W			xrSkin2W_x86;
 extern xrSkin2W			xrSkin2W_SSE;
 extern xrSkin2W			xrSkin2W_3DNow;
+extern xrSkin4W			xrSkin4W_x86;
+extern xrSkin4W			xrSkin4W_SSE;
 //extern xrBoneLerp		xrBoneLerp_x86;
 //extern xrBoneLerp		xrBoneLerp_3DNow;
 extern xrM44_Mul		xrM44_Mul_x86;
@@ -42,6 +44,7 @@ extern "C" {
 		// generic
 		T->skin1W	= xrSkin1W_x86;
 		T->skin2W	= xrSkin2W_x86;
+		T->skin4W	= xrSkin4W_x86;
 		// T->blerp	= xrBoneLerp_x86;
 		T->m44_mul	= xrM44_Mul_x86;
 		T->transfer = xrTransfer_x86;
@@ -52,7 +55,9 @@ extern "C" {
 		// SSE
 		if (dwFeatures & _CPU_FEATURE_SSE) {
 			T->memCopy	= xrMemCopy_MMXSSE3DNow;
-			//T->skin2W	= xrSkin2W_SSE;
+			T->skin1W	= xrSkin1W_SSE;
+			T->skin2W	= xrSkin2W_SSE;
+			T->skin4W	= xrSkin4W_SSE;
 		}
  
 		// 3dnow!
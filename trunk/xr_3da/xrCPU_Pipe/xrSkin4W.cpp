@@ -0,0 +1,35 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+#ifdef _EDITOR
+#include "skeletonX.h"
+#include "skeletoncustom.h"
+#else
+#include "..\skeletonX.h"
+#include "..\skeletoncustom.h"
+#endif
+
+void __stdcall xrSkin4W_x86(vertRender*		D,
+							vertBoned4W*	S,
+							u32				vCount,
+							CBoneInstance*	Bones)
+{
+	vertBoned4W*	E	= S+vCount;
+	Fvector			P,N;
+
+	for (; S!=E; S++, D++)
+	{
+		float	w	[4]	= { S->w[0], S->w[1], S->w[2], 1.f-S->w[0]-S->w[1]-S->w[2] };
+		D->P.set		(0,0,0);
+		D->N.set		(0,0,0);
+		for (u32 b=0; b<4; b++)	{
+			Fmatrix& M	= Bones[S->m[b]].mRenderTransform;
+			M.transform_tiny	(P,S->P);
+			M.transform_dir		(N,S->N);
+			D->P.mad			(P,w[b]);
+			D->N.mad			(N,w[b]);
+		}
+		D->u			= S->u;
+		D->v			= S->v;
+	}
+}
@@ -0,0 +1,37 @@
+#include "stdafx.h"
+#pragma hdrstop
+
+#ifdef _EDITOR
+#include "skeletonX.h"
+#include "skeletoncustom.h"
+#else
+#include "..\skeletonX.h"
+#include "..\skeletoncustom.h"
+#endif
+
+#include "xrSkin_SSE.h"
+
+void __stdcall xrSkin4W_SSE(vertRender*		D,
+							vertBoned4W*	S,
+							u32				vCount,
+							CBoneInstance*	Bones)
+{
+	BOOL			stream	= !(size_t(D)&15);
+	vertBoned4W*	E		= S+vCount;
+	skin_matrix_SSE	M;
+
+	for (; S!=E; S++, D++)
+	{
+		// M = M0*w0 + M1*w1 + M2*w2 + M3*(1-w0-w1-w2)
+		__m128	w0				= _mm_set1_ps	(S->w[0]);
+		__m128	w1				= _mm_set1_ps	(S->w[1]);
+		__m128	w2				= _mm_set1_ps	(S->w[2]);
+		__m128	w3				= _mm_sub_ps	(_mm_set1_ps(1.f),_mm_add_ps(_mm_add_ps(w0,w1),w2));
+		skin_scale_SSE			(M,Bones[S->m[0]].mRenderTransform,w0);
+		skin_blend_SSE			(M,Bones[S->m[1]].mRenderTransform,w1);
+		skin_blend_SSE			(M,Bones[S->m[2]].mRenderTransform,w2);
+		skin_blend_SSE			(M,Bones[S->m[3]].mRenderTransform,w3);
+		skin_vertex_SSE			(D,M,S->P,S->N,&S->u,stream);
+	}
+	if (stream)		_mm_sfence	();
+}
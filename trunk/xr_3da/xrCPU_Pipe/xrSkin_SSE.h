@@ -0,0 +1,60 @@
+#pragma once
+
+// Shared SSE helpers for skinning kernels
+// Bone matrix rows are kept in registers:	P' = x*r0 + y*r1 + z*r2 + r3	(Fmatrix::transform_tiny)
+//											N' = x*r0 + y*r1 + z*r2			(Fmatrix::transform_dir)
+// Weighted bones are blended into one matrix first, which gives the same result as lerp-ing
+// the per-bone transformed vertices, but with a single transform per vertex.
+struct	skin_matrix_SSE
+{
+	__m128	r0,r1,r2,r3;
+};
+
+ICF	void	skin_load_SSE	(skin_matrix_SSE& M, const Fmatrix& S)
+{
+	M.r0	= _mm_loadu_ps	(&S._11);
+	M.r1	= _mm_loadu_ps	(&S._21);
+	M.r2	= _mm_loadu_ps	(&S._31);
+	M.r3	= _mm_loadu_ps	(&S._41);
+}
+
+// M = S*w
+ICF	void	skin_scale_SSE	(skin_matrix_SSE& M, const Fmatrix& S, __m128 w)
+{
+	M.r0	= _mm_mul_ps	(_mm_loadu_ps(&S._11),w);
+	M.r1	= _mm_mul_ps	(_mm_loadu_ps(&S._21),w);
+	M.r2	= _mm_mul_ps	(_mm_loadu_ps(&S._31),w);
+	M.r3	= _mm_mul_ps	(_mm_loadu_ps(&S._41),w);
+}
+
+// M += S*w
+ICF	void	skin_blend_SSE	(skin_matrix_SSE& M, const Fmatrix& S, __m128 w)
+{
+	M.r0	= _mm_add_ps	(M.r0,_mm_mul_ps(_mm_loadu_ps(&S._11),w));
+	M.r1	= _mm_add_ps	(M.r1,_mm_mul_ps(_mm_loadu_ps(&S._21),w));
+	M.r2	= _mm_add_ps	(M.r2,_mm_mul_ps(_mm_loadu_ps(&S._31),w));
+	M.r3	= _mm_add_ps	(M.r3,_mm_mul_ps(_mm_loadu_ps(&S._41),w));
+}
+
+// NOTE: P and N are read as 4 floats, source vertex layouts always have data after them
+// D is written as two 16b halves: (P.xyz,N.x) and (N.yz,u,v), streamed when 16b aligned
+ICF	void	skin_vertex_SSE	(vertRender* D, const skin_matrix_SSE& M, const Fvector& P, const Fvector& N, const float* uv, BOOL stream)
+{
+	__m128	v		= _mm_loadu_ps	(&P.x);
+	__m128	p		= _mm_add_ps	(
+		_mm_add_ps	(_mm_mul_ps(_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,0)),M.r0),_mm_mul_ps(_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,1,1)),M.r1)),
+		_mm_add_ps	(_mm_mul_ps(_mm_shuffle_ps(v,v,_MM_SHUFFLE(2,2,2,2)),M.r2),M.r3)
+		);
+	v				= _mm_loadu_ps	(&N.x);
+	__m128	n		= _mm_add_ps	(
+		_mm_add_ps	(_mm_mul_ps(_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,0)),M.r0),_mm_mul_ps(_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,1,1)),M.r1)),
+		_mm_mul_ps	(_mm_shuffle_ps(v,v,_MM_SHUFFLE(2,2,2,2)),M.r2)
+		);
+	__m128	tc		= _mm_loadl_pi	(_mm_setzero_ps(),(const __m64*)uv);
+	__m128	t		= _mm_shuffle_ps(p,n,_MM_SHUFFLE(0,0,2,2));			// p.z p.z n.x n.x
+	__m128	lo		= _mm_shuffle_ps(p,t,_MM_SHUFFLE(2,0,1,0));			// p.x p.y p.z n.x
+	__m128	hi		= _mm_shuffle_ps(n,tc,_MM_SHUFFLE(1,0,2,1));		// n.y n.z u   v
+	float*	dst		= (float*)D;
+	if (stream)		{ _mm_stream_ps(dst,lo); _mm_stream_ps(dst+4,hi);	}
+	else			{ _mm_storeu_ps(dst,lo); _mm_storeu_ps(dst+4,hi);	}
+}
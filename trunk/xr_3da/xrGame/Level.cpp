@@ -41,6 +41,8 @@
 #include "game_cl_base_weapon_usage_statistic.h"
 #include "clsid_game.h"
 #include "MainMenu.h"
+#include "net_update_delta.h"
+#include "saved_game_writer.h"
 #include "..\XR_IOConsole.h"
 
 #include <functional>
@@ -88,6 +90,11 @@ CLevel::CLevel():IPureClient	(Device.GetTimerGlobal())
 
 	m_pBulletManager			= xr_new<CBulletManager>();
 
+	m_update_baselines			= xr_new<CNetUpdateBaselines>();
+	m_update_ack_seq			= 0;
+	m_update_ack_parts			= 0;
+	m_update_ack_pending		= FALSE;
+
 	if(!g_dedicated_server)
 		m_map_manager				= xr_new<CMapManager>();
 	else
@@ -253,6 +260,7 @@ CLevel::~CLevel()
 //	xr_delete					(m_pFogOfWar);
 	//destroy bullet manager
 	xr_delete					(m_pBulletManager);
+	xr_delete					(m_update_baselines);
 	//-----------------------------------------------------------
 	xr_delete					(pStatGraphR);
 	xr_delete					(pStatGraphS);
@@ -353,8 +361,10 @@ void CLevel::cl_Process_Event				(u16 dest, u16 type, NET_Packet& P)
 	}
 	if (type != GE_DESTROY_REJECT)
 	{
-		if (type == GE_DESTROY)
+		if (type == GE_DESTROY)	{
 			Game().OnDestroy(GO);
+			m_update_baselines->forget	(dest);
+		}
 		GO->OnEvent		(P,type);
 	}
 	else { // handle GE_DESTROY_REJECT here
@@ -377,6 +387,7 @@ void CLevel::cl_Process_Event				(u16 dest, u16 type, NET_Packet& P)
 		}
 
 		GO->OnEvent		(P,GE_OWNERSHIP_REJECT);
+		m_update_baselines->forget	(id);
 		if (ok)
 		{
 			Game().OnDestroy(GD);
@@ -451,6 +462,8 @@ void CLevel::OnFrame	()
 
 	m_feel_deny.update					();
 
+	saved_game_writer().update			();
+
 	if (GameID()!=GAME_SINGLE)			psDeviceFlags.set(rsDisableObjectsAsCrows,true);
 	else								psDeviceFlags.set(rsDisableObjectsAsCrows,false);
 
@@ -590,9 +603,15 @@ void CLevel::OnFrame	()
 }
 
 int		psLUA_GCSTEP					= 10			;
+float	psLUA_GCBUDGET					= 1.f			;	// ms
 void	CLevel::script_gc				()
 {
-	lua_gc	(ai().script_engine().lua(), LUA_GCSTEP, psLUA_GCSTEP);
+	ai().script_engine().gc_step	(psLUA_GCSTEP, psLUA_GCBUDGET);
+}
+
+void	CLevel::script_gc_full			()
+{
+	ai().script_engine().collect_all_garbage	();
 }
 
 #ifdef DEBUG_PRECISE_PATH
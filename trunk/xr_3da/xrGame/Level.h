@@ -30,6 +30,7 @@ class	CAutosaveManager;
 class	CPHCommander;
 class	CLevelDebug;
 class	CLevelSoundManager;
+class	CNetUpdateBaselines;
 
 #ifdef DEBUG
 	class	CDebugRenderer;
@@ -103,6 +104,13 @@ protected:
 	u32							m_dwRPC;	//ReceivedPacketsCount
 	u32							m_dwRPS;	//ReceivedPacketsSize
 	//---------------------------------------------
+	CNetUpdateBaselines			*m_update_baselines;	// payloads M_UPDATE_DELTA may reference
+	u16							m_update_ack_seq;
+	u32							m_update_ack_parts;
+	BOOL						m_update_ack_pending;
+	xr_vector<u16>				m_update_lost;			// entities a delta couldn't be decoded for, the server resends them in full
+	void						net_Import_Delta		(NET_Packet* P);
+	//---------------------------------------------
 	
 public:
 #ifdef DEBUG
@@ -282,6 +290,7 @@ public:
 	IC CDebugRenderer				&debug_renderer				();
 #endif
 	void	__stdcall				script_gc					();			// GC-cycle
+	void							script_gc_full				();			// full GC, while loading
 
 	IC CPHCommander					&ph_commander				();
 	IC CPHCommander					&ph_commander_scripts		();
@@ -183,6 +183,37 @@ void CBulletManager::AddBullet(const Fvector& position,
 	m_Lock.Leave	();
 }
 
+void CBulletManager::_kinematics::resize(u32 size)
+{
+	pos_x.resize		(size);	pos_y.resize	(size);	pos_z.resize	(size);
+	dir_x.resize		(size);	dir_y.resize	(size);	dir_z.resize	(size);
+	speed.resize		(size);
+	fly_dist.resize		(size);
+	range.resize		(size);
+	steps.resize		(size);
+	state.resize		(size);
+}
+
+void CBulletManager::GatherBullet(u32 k)
+{
+	SBullet&		bullet		= m_Bullets[k];
+	_kinematics&	K			= m_Kinematics;
+	K.pos_x[k]		= bullet.pos.x;	K.pos_y[k]	= bullet.pos.y;	K.pos_z[k]	= bullet.pos.z;
+	K.dir_x[k]		= bullet.dir.x;	K.dir_y[k]	= bullet.dir.y;	K.dir_z[k]	= bullet.dir.z;
+	K.speed[k]		= bullet.speed;
+	K.fly_dist[k]	= bullet.fly_dist;
+}
+
+void CBulletManager::ScatterBullet(u32 k)
+{
+	SBullet&		bullet		= m_Bullets[k];
+	_kinematics&	K			= m_Kinematics;
+	bullet.pos.set	(K.pos_x[k],K.pos_y[k],K.pos_z[k]);
+	bullet.dir.set	(K.dir_x[k],K.dir_y[k],K.dir_z[k]);
+	bullet.speed	= K.speed[k];
+	bullet.fly_dist	= K.fly_dist[k];
+}
+
 void CBulletManager::UpdateWorkload()
 {
 	m_Lock.Enter		()	;
@@ -191,9 +222,15 @@ void CBulletManager::UpdateWorkload()
 	m_dwTimeRemainder	=	delta_time%m_dwStepTime;
 	
 	rq_storage.r_clear			();
-	rq_spatial.clear_not_free	();
 
-	for(int k=m_Bullets.size()-1; k>=0; k--){
+	m_StepTimeSec		=	float(m_dwStepTime)/1000.f;
+	m_StepSingle		=	(GameID() == GAME_SINGLE);
+	m_StepLevelBox		=	Level().ObjectSpace.GetBoundingVolume();
+
+	u32	count			=	m_Bullets.size();
+	u32	max_steps		=	0;
+	m_Kinematics.resize	(count);
+	for(u32 k=0; k<count; k++){
 		SBullet& bullet = m_Bullets[k];
 		//         1 
 		//(       )
@@ -206,37 +243,78 @@ void CBulletManager::UpdateWorkload()
 		if(frames_pass == 0)						cur_step_num = 1;
 		else if (frames_pass == 1 && step_num>0)	cur_step_num -= 1;
 
-		// calculate bullet
-		for(u32 i=0; i<cur_step_num; i++){
-			if(!CalcBullet(rq_storage,rq_spatial,&bullet, m_dwStepTime)){
-				collide::rq_result res;
-				RegisterEvent(EVENT_REMOVE, FALSE, &bullet, Fvector().set(0, 0, 0), res, (u16)k);
-//				if (bullet.flags.allow_sendhit && GameID() != GAME_SINGLE)
-//					Game().m_WeaponUsageStatistic->OnBullet_Remove(&bullet);
-//				m_Bullets[k] = m_Bullets.back();
-//				m_Bullets.pop_back();
-				break;
-			}
+		GatherBullet					(k);
+		m_Kinematics.steps[k]			= cur_step_num;
+		m_Kinematics.state[k]			= bsFlying;
+		max_steps						= _max(max_steps,cur_step_num);
+	}
+
+	// step-major: all the bullets do a step, their rays are tested in one batch and only the ones
+	// which may hit something are traced with the callbacks, then the flight is integrated over SoA
+	for(u32 step=0; step<max_steps; step++){
+		m_StepBullets.clear_not_free	();
+		m_StepRays.clear_not_free		();
+		for(int k=count-1; k>=0; k--){
+			if (m_Kinematics.state[k]==bsRemove || m_Kinematics.steps[k]<=step)	continue;
+			float range					= m_Kinematics.speed[k]*m_StepTimeSec;
+			float max_range				= m_Bullets[k].max_dist - m_Kinematics.fly_dist[k];
+			if(range>max_range) 
+				range = max_range;
+			m_Kinematics.range[k]		= range;
+			m_StepBullets.push_back		(u32(k));
+		//   , .. 
+		//RayQuery()    - 
+		//   
+			m_StepRays.push_back		(collide::ray_defs(
+				Fvector().set(m_Kinematics.pos_x[k],m_Kinematics.pos_y[k],m_Kinematics.pos_z[k]),
+				Fvector().set(m_Kinematics.dir_x[k],m_Kinematics.dir_y[k],m_Kinematics.dir_z[k]),
+				range, CDB::OPT_CULL, collide::rqtBoth));
+		}
+		if (m_StepBullets.empty())		break;
+
+		m_StepTouched.resize			(m_StepBullets.size());
+		Level().ObjectSpace.RayTestBatch(&*m_StepRays.begin(),m_StepRays.size(),&*m_StepTouched.begin(),NULL);
+
+		for(u32 i=0; i<m_StepBullets.size(); i++){
+			u32 k						= m_StepBullets[i];
+			m_Kinematics.state[k]		= bsFlying;
+			if (!m_StepTouched[i])		continue;
+
+			SBullet& bullet				= m_Bullets[k];
+			ScatterBullet				(k);
+			m_Kinematics.range[k]		= TraceBullet(rq_storage,&bullet,m_Kinematics.range[k]);
+			GatherBullet				(k);
+			if (bullet.flags.ricochet_was)
+				m_Kinematics.state[k]	= bsRicochet;
+		}
+
+		MoveBullets						();
+	}
+
+	// back to SBullet, the ones done are removed from the back so the indices stay valid
+	for(int k=count-1; k>=0; k--){
+		SBullet& bullet					= m_Bullets[k];
+		ScatterBullet					(k);
+		if (m_Kinematics.steps[k]){
+			bullet.flags.ricochet_was	= (m_Kinematics.state[k]==bsRicochet);
+			bullet.flags.skipped_frame	= (Device.dwFrame >= bullet.frame_num);
+		}
+		if (m_Kinematics.state[k]==bsRemove){
+			collide::rq_result res;
+			RegisterEvent(EVENT_REMOVE, FALSE, &bullet, Fvector().set(0, 0, 0), res, (u16)k);
+//			if (bullet.flags.allow_sendhit && GameID() != GAME_SINGLE)
+//				Game().m_WeaponUsageStatistic->OnBullet_Remove(&bullet);
+//			m_Bullets[k] = m_Bullets.back();
+//			m_Bullets.pop_back();
 		}
 	}
 	m_Lock.Leave		();
 }
 
-bool CBulletManager::CalcBullet (collide::rq_results & rq_storage, xr_vector<ISpatial*>& rq_spatial, SBullet* bullet, u32 delta_time)
+float CBulletManager::TraceBullet (collide::rq_results & rq_storage, SBullet* bullet, float range)
 {
 	VERIFY					(bullet);
 
-	float delta_time_sec	= float(delta_time)/1000.f;
-	float range				= bullet->speed*delta_time_sec;
-	
-	float max_range					= bullet->max_dist - bullet->fly_dist;
-	if(range>max_range) 
-		range = max_range;
-
-	//   , .. 
-	//RayQuery()    - 
-	//   
-	Fvector cur_dir					= bullet->dir;
 	bullet_test_callback_data		bullet_data;
 	bullet_data.pBullet				= bullet;
 	bullet_data.bStopTracing		= true;
@@ -252,59 +330,66 @@ bool CBulletManager::CalcBullet (collide::rq_results & rq_storage, xr_vector<ISp
 	{
 		range						= (rq_storage.r_begin()+rq_storage.r_count()-1)->range;
 	}
-	range							= _max				(EPS_L,range);
-
-	bullet->flags.skipped_frame = (Device.dwFrame >= bullet->frame_num);
+	return							range;
+}
 
-	if(!bullet->flags.ricochet_was)	{
-		//  
-		bullet->pos.mad(bullet->pos, cur_dir, range);
-		bullet->fly_dist += range;
+void CBulletManager::MoveBullets()
+{
+	_kinematics&	K				= m_Kinematics;
+	float			dt				= m_StepTimeSec;
+	const Fbox&		level_box		= m_StepLevelBox;
+	for(u32 i=0; i<m_StepBullets.size(); i++){
+		u32 k						= m_StepBullets[i];
+		float range					= _max(EPS_L,K.range[k]);
+		if (K.state[k]!=bsRicochet){
+			const Fvector& cur_dir	= m_StepRays[i].dir;
+			//  
+			K.pos_x[k]				+= cur_dir.x*range;
+			K.pos_y[k]				+= cur_dir.y*range;
+			K.pos_z[k]				+= cur_dir.z*range;
+			K.fly_dist[k]			+= range;
+
+			if(K.fly_dist[k]>=m_Bullets[k].max_dist){
+				K.state[k]			= bsRemove;
+				continue;
+			}
+			if(!((K.pos_x[k]>=level_box.x1) && 
+				 (K.pos_x[k]<=level_box.x2) && 
+				 (K.pos_y[k]>=level_box.y1) && 
+//				 (K.pos_y[k]<=level_box.y2) && 
+				 (K.pos_z[k]>=level_box.z1) && 
+				 (K.pos_z[k]<=level_box.z2))	){
+				K.state[k]			= bsRemove;
+				continue;
+			}
 
-		if(bullet->fly_dist>=bullet->max_dist)
-			return false;
+			//     
+			//  
+			float speed				= K.speed[k];
+			float vx				= K.dir_x[k]*speed;
+			float vy				= K.dir_y[k]*speed;
+			float vz				= K.dir_z[k]*speed;
+
+			float ar				= m_StepSingle ? -m_fAirResistanceK*dt : -m_Bullets[k].air_resistance*speed/m_Bullets[k].max_speed*dt;
+			vx						+= vx*ar;
+			vy						+= vy*ar;
+			vz						+= vz*ar;
+			vy						-= m_fGravityConst*dt;
+
+			speed					= _sqrt(vx*vx + vy*vy + vz*vz);
+			VERIFY(_valid(speed));
+			VERIFY(!fis_zero(speed));
+			// normalize(),	    2  magnitude()
+#pragma todo("   speed==0")
+			K.speed[k]				= speed;
+			K.dir_x[k]				= vx/speed;
+			K.dir_y[k]				= vy/speed;
+			K.dir_z[k]				= vz/speed;
+		}
 
-		Fbox level_box = Level().ObjectSpace.GetBoundingVolume();
-		
-/*		if(!level_box.contains(bullet->pos))
-			return false;
-*/
-		if(!((bullet->pos.x>=level_box.x1) && 
-			 (bullet->pos.x<=level_box.x2) && 
-			 (bullet->pos.y>=level_box.y1) && 
-//			 (bullet->pos.y<=level_box.y2) && 
-			 (bullet->pos.z>=level_box.z1) && 
-			 (bullet->pos.z<=level_box.z2))	)
-			 return false;
-
-		//     
-		//  
-		bullet->dir.mul(bullet->speed);
-
-		Fvector air_resistance = bullet->dir;
-		if (GameID() == GAME_SINGLE)
-			air_resistance.mul(-m_fAirResistanceK*delta_time_sec);
-		else
-			air_resistance.mul(-bullet->air_resistance*(bullet->speed)/(bullet->max_speed)*delta_time_sec);
-///		Msg("Speed - %f; ar - %f, %f", bullet->dir.magnitude(), air_resistance.magnitude(), air_resistance.magnitude()/bullet->dir.magnitude()*100);
-
-		bullet->dir.add(air_resistance);
-		bullet->dir.y -= m_fGravityConst*delta_time_sec;
-
-		bullet->speed = bullet->dir.magnitude();
-		VERIFY(_valid(bullet->speed));
-		VERIFY(!fis_zero(bullet->speed));
-		// normalize(),	    2  magnitude()
-#pragma todo("   bullet->speed==0")
-		bullet->dir.x /= bullet->speed;
-		bullet->dir.y /= bullet->speed;
-		bullet->dir.z /= bullet->speed;
+		if(K.speed[k]<m_fMinBulletSpeed)
+			K.state[k]				= bsRemove;
 	}
-
-	if(bullet->speed<m_fMinBulletSpeed)
-		return false;
-
-	return true;
 }
 
 #ifdef DEBUG
@@ -80,7 +80,6 @@ class CBulletManager
 {
 private:
 	collide::rq_results		rq_storage;
-	xr_vector<ISpatial*>	rq_spatial;
 	collide::rq_results		m_rq_results;
 
 private:
@@ -116,6 +115,31 @@ protected:
 	BulletVec				m_BulletsRendered	;	// copy for rendering
 	xr_vector<_event>		m_Events			;	
 
+	// kinematic state of m_Bullets in SoA, the bullets are stepped with it by UpdateWorkload
+	// SBullet is in sync only for the ray tracing (callbacks and events take it) and after the update
+	struct	_kinematics		{
+		xr_vector<float>	pos_x,pos_y,pos_z;
+		xr_vector<float>	dir_x,dir_y,dir_z;
+		xr_vector<float>	speed;
+		xr_vector<float>	fly_dist;
+		xr_vector<float>	range;					// traced in the current step
+		xr_vector<u32>		steps;					// left in the update
+		xr_vector<u8>		state;
+		void				resize				(u32 size);
+	};
+	enum	{
+		bsFlying			= u8(0),
+		bsRicochet,									// the step ended with ricochet
+		bsRemove,
+	};
+	_kinematics				m_Kinematics		;
+	xr_vector<u32>			m_StepBullets		;	// stepped at the current step
+	xr_vector<collide::ray_defs>	m_StepRays	;
+	xr_vector<u8>			m_StepTouched		;
+	float					m_StepTimeSec		;
+	bool					m_StepSingle		;
+	Fbox					m_StepLevelBox		;
+
 	// ,       
 	u32						m_dwTimeRemainder;
 
@@ -170,8 +194,13 @@ protected:
 	//       
 	// ,      
 	//       
-	// true    
-	bool					CalcBullet			(collide::rq_results & rq_storage, xr_vector<ISpatial*>& rq_spatial, SBullet* bullet, u32 delta_time);
+	//ray part of the step: returns the range flown, hits and ricochets the bullet
+	float					TraceBullet			(collide::rq_results & rq_storage, SBullet* bullet, float range);
+	//SBullet <-> m_Kinematics
+	void					GatherBullet		(u32 k);
+	void					ScatterBullet		(u32 k);
+	//movement part of the step for m_StepBullets (a few flops per bullet, not worth the worker threads)
+	void					MoveBullets			();
 	void 		__stdcall	UpdateWorkload		();
 public:
 							CBulletManager		();
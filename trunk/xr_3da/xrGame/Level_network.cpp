@@ -49,6 +49,9 @@ void CLevel::remove_objects	()
 	if (OnClient())
 		ClearAllObjects			();
 
+	m_update_baselines->clear	();
+	m_update_lost.clear			();
+
 	BulletManager().Clear		();
 	ph_commander().clear		();
 	ph_commander_scripts().clear();
@@ -171,6 +174,19 @@ void CLevel::ClientSend()
 	};
 	if (OnClient()) 
 	{
+		if (m_update_ack_pending)
+		{
+			P.w_begin			(M_UPDATE_ACK);
+			P.w_u16				(m_update_ack_seq);
+			P.w_u32				(m_update_ack_parts);
+			u32 lost			= _min(m_update_lost.size(),u32(255));
+			P.w_u8				(u8(lost));
+			for (u32 it=0; it<lost; ++it)
+				P.w_u16			(m_update_lost[it]);
+			m_update_lost.erase	(m_update_lost.begin(),m_update_lost.begin()+lost);
+			Send				(P, net_flags(FALSE));
+			m_update_ack_pending= !m_update_lost.empty();
+		}
 		Flush_Send_Buffer();
 		return;
 	}
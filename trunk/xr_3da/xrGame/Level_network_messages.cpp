@@ -13,6 +13,53 @@
 #include "saved_game_wrapper.h"
 #include "level_graph.h"
 #include "clsid_game.h"
+#include "net_update_delta.h"
+
+void CLevel::net_Import_Delta(NET_Packet* P)
+{
+	u16				seq		= P->r_u16();
+	u8				part	= P->r_u8();
+	u8				encoded	[net_update_delta::max_encoded];
+	u8				payload	[net_update_delta::max_payload];
+	NET_Packet		tmpP;
+	bool			lost	= false;
+	while (!P->r_eof())
+	{
+		u16			ID		= P->r_u16();
+		u8			base	= P->r_u8();
+		u8			size	= P->r_u8();
+		u32			psize	= size;
+		if (0==base)	P->r	(payload,size);
+		else
+		{
+			P->r				(encoded,size);
+			const CNetUpdateBaselines::slot*	B	= m_update_baselines->find(ID,u16(seq-base));
+			if (0==B || !net_update_delta::decode(B->data,B->size,encoded,size,payload))	{
+				// baseline is lost: the part is not acknowledged and the server drops the baseline
+				lost			= true;
+				m_update_lost.push_back	(ID);
+				continue;
+			}
+			psize				= B->size;
+		}
+		if (0==psize)			continue;
+		m_update_baselines->store	(ID,seq,payload,psize);
+
+		CObject*	O		= Objects.net_Find(u32(ID));
+		if (0==O)				continue;
+		tmpP.construct			(payload,psize);
+		tmpP.r_pos				= 0;
+		tmpP.timeReceive		= P->timeReceive;
+		O->net_Import			(tmpP);
+	}
+
+	// acknowledge received parts of the newest update
+	if (!lost)	{
+		if (seq==m_update_ack_seq)				m_update_ack_parts	|= 1<<part;
+		else if (s16(seq-m_update_ack_seq)>0)	{ m_update_ack_seq = seq; m_update_ack_parts = 1<<part; }
+	}
+	m_update_ack_pending	= TRUE;
+}
 
 void CLevel::ClientReceive()
 {
@@ -91,8 +138,10 @@ void CLevel::ClientReceive()
 			};	//        break, ..          M_UPDATE,
 				//    M_UPDATE_OBJECTS
 		case M_UPDATE_OBJECTS:
+		case M_UPDATE_DELTA:
 			{
-				Objects.net_Import		(P);
+				if (M_UPDATE_DELTA==m_type)	net_Import_Delta	(P);
+				else						Objects.net_Import	(P);
 
 				if (OnClient()) UpdateDeltaUpd(timeServer());
 				IClientStatistic pStat = Level().GetStatistic();
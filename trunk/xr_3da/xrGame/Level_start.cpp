@@ -267,6 +267,10 @@ bool CLevel::net_start6()
 	BulletManager().Clear		();
 	BulletManager().Load		();
 
+	// collect the garbage of the level scripts setup under the loading screen, not on the first frames
+	if (!g_dedicated_server)
+		script_gc_full			();
+
 	pApp->LoadEnd				();
 
 	if(net_start_result_total)
@@ -0,0 +1,178 @@
+#include "stdafx.h"
+#include "PHObject.h"
+#include "PHBroadphase.h"
+#include "PHCollideValidator.h"
+
+static const u32 no_rank	= u32(-1);
+
+CPHBroadphase::CPHBroadphase()
+{
+	m_pass					= 1;
+	m_count					= 0;
+}
+
+void CPHBroadphase::update(CPHObject* O)
+{
+	u32		id				= O->m_bp_proxy;
+	if (id>=m_proxies.size() || m_proxies[id].object!=O)
+	{
+		if (m_free.empty())	{
+			id					= m_proxies.size();
+			m_proxies.push_back	(proxy());
+		} else {
+			id					= m_free.back();
+			m_free.pop_back		();
+		}
+		proxy&	P			= m_proxies[id];
+		P.object			= O;
+		P.rank				= no_rank;
+		P.pass				= 0;
+		m_order.push_back	(id);
+		O->m_bp_proxy		= id;
+		++m_count;
+	}
+
+	// union of the box CollideDynamics queries with and the box the object is found by
+	const Fsphere&	S		= O->spatial.sphere;
+	Fvector	ext;			ext.set(_max(O->AABB.x,S.R),_max(O->AABB.y,S.R),_max(O->AABB.z,S.R));
+	proxy&	P				= m_proxies[id];
+	P.min.sub				(S.P,ext);
+	P.max.add				(S.P,ext);
+}
+
+void CPHBroadphase::remove(CPHObject* O)
+{
+	u32		id				= O->m_bp_proxy;
+	O->m_bp_proxy			= u32(-1);
+	if (id>=m_proxies.size() || m_proxies[id].object!=O)	return;
+	m_proxies[id].object	= NULL;
+	m_removed.push_back		(id);
+	--m_count;
+}
+
+void CPHBroadphase::rank(CPHObject* O)
+{
+	u32		id				= O->m_bp_proxy;
+	if (id>=m_proxies.size() || m_proxies[id].object!=O)	return;
+	proxy&	P				= m_proxies[id];
+	P.rank					= m_ranked.size();
+	P.pass					= m_pass;
+	P.first_pair			= 0;
+	P.pair_count			= 0;
+	m_ranked.push_back		(id);
+}
+
+IC void CPHBroadphase::add_pair(u32 a, u32 b)
+{
+	if (m_proxies[a].rank>m_proxies[b].rank)	std::swap(a,b);		// the owner is the active one colliding first
+	proxy&	A				= m_proxies[a];
+	proxy&	B				= m_proxies[b];
+	if (A.min.y>B.max.y || B.min.y>A.max.y)		return;
+	if (A.min.z>B.max.z || B.min.z>A.max.z)		return;
+	// the owner queries even if its collision is disabled, but it is not found by the others
+	if (!(B.object->spatial.type&STYPE_PHYSIC) || !B.object->spatial.node_ptr)	return;
+	if (!CPHCollideValidator::DoCollide(*A.object,*B.object))					return;
+
+	pair	p;
+	p.rank					= A.rank;
+	p.second				= b;
+	m_pairs.push_back		(p);
+}
+
+struct pair_pred
+{
+	IC bool	operator()		(const CPHBroadphase::pair& a, const CPHBroadphase::pair& b) const
+	{
+		if (a.rank!=b.rank)	return a.rank<b.rank;
+		return	a.second<b.second;
+	}
+};
+
+void CPHBroadphase::find_pairs()
+{
+	m_pairs.clear_not_free	();
+
+	// drop removed proxies and restore the order
+	u32		count			= 0;
+	for (u32 it=0; it<m_order.size(); ++it)
+	{
+		u32		id			= m_order[it];
+		if (!m_proxies[id].object)	continue;
+		float	x			= m_proxies[id].min.x;
+		u32		j			= count;
+		for (; j>0 && m_proxies[m_order[j-1]].min.x>x; --j)
+			m_order[j]		= m_order[j-1];
+		m_order[j]			= id;
+		++count;
+	}
+	m_order.resize			(count);
+	m_free.insert			(m_free.end(),m_removed.begin(),m_removed.end());
+	m_removed.clear_not_free();
+
+	// sweep: an active proxy is tested against all the open ones, an inactive - against the active ones only
+	m_open_all.clear_not_free	();
+	m_open_active.clear_not_free();
+	for (u32 it=0; it<m_order.size(); ++it)
+	{
+		u32		id			= m_order[it];
+		proxy&	P			= m_proxies[id];
+		bool	active		= P.rank!=no_rank;
+		xr_vector<u32>&	open	= active ? m_open_all : m_open_active;
+		for (u32 o=0; o<open.size(); )
+		{
+			u32		other	= open[o];
+			if (m_proxies[other].max.x<P.min.x)	{
+				open[o]		= open.back();
+				open.pop_back();
+				continue;
+			}
+			add_pair		(id,other);
+			++o;
+		}
+		m_open_all.push_back		(id);
+		if (active)	m_open_active.push_back	(id);
+	}
+
+	// group by the owner
+	std::sort				(m_pairs.begin(),m_pairs.end(),pair_pred());
+	for (u32 it=0; it<m_pairs.size(); )
+	{
+		proxy&	P			= m_proxies[m_ranked[m_pairs[it].rank]];
+		P.first_pair		= it;
+		for (; it<m_pairs.size() && m_pairs[it].rank==P.rank; ++it)	;
+		P.pair_count		= it-P.first_pair;
+	}
+}
+
+void CPHBroadphase::finish()
+{
+	for (u32 it=0; it<m_ranked.size(); ++it)
+		m_proxies[m_ranked[it]].rank	= no_rank;
+	m_ranked.clear_not_free	();
+	++m_pass;
+}
+
+bool CPHBroadphase::pairs(const CPHObject* O, const pair*& B, const pair*& E) const
+{
+	u32		id				= O->m_bp_proxy;
+	if (id>=m_proxies.size())	return false;
+	const proxy&	P		= m_proxies[id];
+	if (P.object!=O || P.pass!=m_pass)	return false;
+	B						= m_pairs.empty() ? 0 : &m_pairs.front()+P.first_pair;
+	E						= B+P.pair_count;
+	return	true;
+}
+
+void CPHBroadphase::clear()
+{
+	m_proxies.clear			();
+	m_free.clear			();
+	m_removed.clear			();
+	m_order.clear			();
+	m_ranked.clear			();
+	m_open_all.clear		();
+	m_open_active.clear		();
+	m_pairs.clear			();
+	m_count					= 0;
+	++m_pass;
+}
@@ -0,0 +1,55 @@
+#ifndef PH_BROADPHASE_H
+#define PH_BROADPHASE_H
+
+class CPHObject;
+
+// Sweep-and-prune over the bounds of all the registered physics objects.
+// Proxies are kept sorted by min x between steps (insertion sort - the order is coherent), so
+// a pass is a single sweep. The pass produces candidate pairs having at least one active object,
+// each pair once, owned by the active object colliding it (by the earlier in the world list if both
+// are active) - this is the order CPHObject::CollideDynamics visited them through the spatial queries.
+class CPHBroadphase
+{
+public:
+	struct pair
+	{
+		u32					rank;			// of the owner in the pass
+		u32					second;			// proxy
+	};
+private:
+	struct proxy
+	{
+		CPHObject*			object;			// NULL - removed
+		Fvector				min;
+		Fvector				max;
+		u32					rank;			// in the pass, u32(-1) - inactive
+		u32					pass;			// pairs are valid if == m_pass
+		u32					first_pair;
+		u32					pair_count;
+	};
+	xr_vector<proxy>		m_proxies;
+	xr_vector<u32>			m_free;
+	xr_vector<u32>			m_removed;		// reused after the pass to keep the pairs valid
+	xr_vector<u32>			m_order;		// proxies sorted by min x
+	xr_vector<u32>			m_ranked;
+	xr_vector<u32>			m_open_all;
+	xr_vector<u32>			m_open_active;
+	xr_vector<pair>			m_pairs;
+	u32						m_pass;
+	u32						m_count;
+	IC	void				add_pair		(u32 a, u32 b);
+public:
+							CPHBroadphase	();
+	void					update			(CPHObject* O);				// register or move
+	void					remove			(CPHObject* O);
+	void					rank			(CPHObject* O);				// active objects in the order of collision
+	void					find_pairs		();
+	void					finish			();							// pairs are not valid after
+	bool					pairs			(const CPHObject* O, const pair*& B, const pair*& E) const;
+	IC	CPHObject*			object			(u32 proxy) const			{ return m_proxies[proxy].object; }
+	IC	u32					proxies_count	() const					{ return m_count; }
+	IC	u32					pairs_count		() const					{ return m_pairs.size(); }
+	void					clear			();
+};
+
+#endif
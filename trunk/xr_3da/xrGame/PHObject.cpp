@@ -16,9 +16,15 @@ CPHObject::CPHObject	()	: ISpatial(g_SpatialSpacePhysic)
 	spatial.type	|=	STYPE_PHYSIC;
 	m_island.Init	();
 	m_check_count	=0;
+	m_bp_proxy		=u32(-1);
 	CPHCollideValidator::InitObject	(*this);
 }
 
+CPHObject::~CPHObject	()
+{
+	if(ph_world)	ph_world->Broadphase().remove(this);
+}
+
 void CPHObject::activate()
 {
 	R_ASSERT2(dSpacedGeom(),"trying to activate destroyed or not created object!");
@@ -71,6 +77,7 @@ void CPHObject::spatial_move()
 {
 	get_spatial_params();
 	ISpatial::spatial_move();
+	if(ph_world)	ph_world->Broadphase().update(this);
 	m_flags.set(st_dirty,TRUE);
 }
 
@@ -119,6 +126,18 @@ void CPHObject::Collide()
 }
 void	CPHObject::		CollideDynamics					()
 {
+	// during the world step the candidates come from the broadphase pass
+	const CPHBroadphase::pair	*P,*E;
+	const CPHBroadphase&		broadphase=ph_world->Broadphase();
+	if(broadphase.pairs(this,P,E))
+	{
+		for(;P!=E;++P)	{
+			CPHObject* obj2=broadphase.object(P->second);
+			if(!obj2 || !obj2->m_flags.test(st_dirty))		continue;
+			NearCallback(this,obj2,dSpacedGeom(),obj2->dSpacedGeom());
+		}
+		return;
+	}
 	g_SpatialSpacePhysic->q_box				(ph_world->r_spatial,0,STYPE_PHYSIC,spatial.sphere.P,AABB);
 	qResultVec& result=ph_world->r_spatial	;
 	qResultIt i=result.begin(),e=result.end();
@@ -195,9 +214,16 @@ void CPHObject::spatial_register()
 {
 	get_spatial_params();
 	ISpatial::spatial_register();
+	if(ph_world)	ph_world->Broadphase().update(this);
 	m_flags.set(st_dirty,TRUE);
 }
 
+void CPHObject::spatial_unregister()
+{
+	ISpatial::spatial_unregister();
+	if(ph_world)	ph_world->Broadphase().remove(this);
+}
+
 void CPHObject::collision_disable()
 {
 	ISpatial::spatial_unregister();
@@ -19,6 +19,7 @@ class CPHObject :
 #ifdef DEBUG
 	friend void DBG_DrawPHObject(CPHObject* obj);
 #endif
+	friend class CPHBroadphase;
 	DECLARE_PHLIST_ITEM(CPHObject)
 
 			Flags8	m_flags;
@@ -36,6 +37,7 @@ class CPHObject :
 			CLBits				m_collide_bits;
 			u8					m_check_count;
 			_flags<CLClassBits>	m_collide_class_bits;
+			u32					m_bp_proxy;
 
 public:
 			enum ECastType
@@ -52,6 +54,7 @@ protected:
 	virtual		dGeomID			dSpacedGeom						()								=0;
 	virtual		void			get_spatial_params				()								=0;
 	virtual		void			spatial_register				()								;
+	virtual		void			spatial_unregister				()								;
 				void			SetRayMotions					()								{m_flags.set(fl_ray_motions,TRUE);}
 				void			UnsetRayMotions					()								{m_flags.set(fl_ray_motions,FALSE);}
 
@@ -95,6 +98,7 @@ public:
 
 
 							CPHObject						()										;
+	virtual					~CPHObject						()										;
 			void			activate						()										;
 		IC	bool			is_active						()										{return !!m_flags.test(st_activated)/*b_activated*/;}
 			void			deactivate						()										;
@@ -105,6 +109,7 @@ public:
 			void			collision_enable				()										;
 virtual		void			ClearRecentlyDeactivated		()										{;}		
 virtual		void			Collide							()										;
+virtual		bool			CollidesDynamics				()										{return true;}
 virtual		void			near_callback					(CPHObject* obj)						{;}
 virtual		void			RMotionsQuery					(qResultVec	&res)						{;}
 virtual		CPHMoveStorage*	MoveStorage						()										{return NULL;}
@@ -10,6 +10,7 @@ class CPHSplitedShell:
 	virtual		void		SetMaxAABBRadius	(float size){m_max_AABBradius=size;}
 protected:
 	virtual		void		Collide				()										;
+	virtual		bool		CollidesDynamics	()										{return false;}
 	virtual		void		get_spatial_params	()										;
 	virtual		void		DisableObject		()										;
 private:
@@ -138,6 +138,7 @@ void CPHWorld::Create()
 void CPHWorld::Destroy()
 {
 	r_spatial.clear();
+	m_broadphase.clear();
 	xr_delete(m_commander);
 	Mesh.Destroy();
 #ifdef PH_PLAIN
@@ -218,6 +219,19 @@ void CPHWorld::Step()
 	++m_steps_num;
 	Device.Statistic->ph_collision.Begin	();
 
+	// candidate pairs of the active objects in one pass, objects activated during the collision query themselves
+	bool	broadphase	=!!ph_broadphase;
+	if(broadphase)
+	{
+		Device.Statistic->ph_broadphase.Begin	();
+		for(i_object=m_objects.begin();m_objects.end() != i_object;++i_object)
+			if((*i_object)->CollidesDynamics())	m_broadphase.rank((*i_object));
+		m_broadphase.find_pairs();
+		Device.Statistic->ph_broadphase.End	();
+		Device.Statistic->ph_pairs			+=m_broadphase.pairs_count();
+		Device.Statistic->ph_proxies		=m_broadphase.proxies_count();
+	}
+
 	for(i_object=m_objects.begin();m_objects.end() != i_object;)
 	{
 		CPHObject* obj=(*i_object);
@@ -225,6 +239,7 @@ void CPHWorld::Step()
 
 		++i_object;
 	}
+	if(broadphase)	m_broadphase.finish();
 	Device.Statistic->ph_collision.End	();
 
 #ifdef DEBUG
@@ -258,6 +273,7 @@ void CPHWorld::Step()
 //////////////////////////////////////////////////////////////////////
 	m_commander						->update();
 //////////////////////////////////////////////////////////////////////
+	m_islands.clear_not_free		();
 	for(i_object=m_objects.begin();m_objects.end() != i_object;)
 	{	
 		CPHObject* obj=(*i_object);
@@ -273,12 +289,27 @@ void CPHWorld::Step()
 			}
 		}
 #endif
-
-		obj->IslandStep(fixed_step);
+		if(obj->Island().IsActive())	m_islands.push_back(&obj->Island());
 	}
 
+	// merged islands share no bodies and joints, so they are stepped independently
+	m_islands_cycles.resize			(m_islands.size());
+	if(ph_islands_mt && m_islands.size()>1)
+		WorkerPool.parallel_for		(m_islands.size(),1,CWorkerPool::range_callback(this,&CPHWorld::IslandsStep_MT));
+	else
+		IslandsStep_MT				(0,m_islands.size(),0);
+
 	Device.Statistic->ph_core.End		();
 
+	float	ms_per_cycle			= 1000.f/float(CPU::qpc_freq);
+	Device.Statistic->ph_islands	+= m_islands.size();
+	for(u32 it=0; it<m_islands_cycles.size(); ++it)
+	{
+		float	ms					= float(m_islands_cycles[it])*ms_per_cycle;
+		Device.Statistic->ph_islands_sum	+= ms;
+		Device.Statistic->ph_islands_max	= _max(Device.Statistic->ph_islands_max,ms);
+	}
+
 
 	for(i_object=m_objects.begin();m_objects.end() != i_object;)
 	{
@@ -312,6 +343,19 @@ void CPHWorld::Step()
 
 }
 
+void CPHWorld::IslandsStep_MT(u32 begin, u32 end, u32 worker_id)
+{
+	for(u32 it=begin; it<end; ++it)
+	{
+		// the solver shuffles constraints with dRandInt, its seed is per thread - set it by the
+		// step and the island order so the result does not depend on the thread stepping the island
+		dRandSetSeed				(u32(m_steps_num)*2654435761u+it);
+		u64	start					= CPU::QPC();
+		m_islands[it]				->Step(fixed_step);
+		m_islands_cycles[it]		= CPU::QPC()-start;
+	}
+}
+
 void CPHWorld::StepTouch()
 {
 	PH_OBJECT_I			i_object;
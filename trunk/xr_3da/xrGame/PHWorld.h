@@ -1,6 +1,7 @@
 #ifndef PH_WORLD_H
 #define PH_WORLD_H
 #include "Physics.h"
+#include "PHBroadphase.h"
 
 // refs
 struct	SGameMtlPair;
@@ -9,6 +10,7 @@ class	CPHCondition;
 class	CPHAction;
 struct	SPHNetState;
 class	CPHSynchronize;
+class	CPHIsland;
 typedef  xr_vector<std::pair<CPHSynchronize*,SPHNetState> > V_PH_WORLD_STATE;
 class CPHMesh {
 	dGeomID Geom;
@@ -47,6 +49,10 @@ class CPHWorld	: public pureFrame
 	PH_UPDATE_OBJECT_STORAGE	m_freezed_update_objects									;
 	dGeomID						m_motion_ray;
 	CPHCommander				*m_commander;
+	xr_vector<CPHIsland*>		m_islands													;	// active islands of the step
+	xr_vector<u64>				m_islands_cycles											;
+	CPHBroadphase				m_broadphase												;
+	void		__stdcall		IslandsStep_MT					(u32 begin, u32 end, u32 worker_id);
 public:
 	xr_vector<ISpatial*>		r_spatial;
 public:
@@ -73,6 +79,7 @@ IC	float						Gravity							()							{return m_gravity;}
 	void						RemoveObject					(PH_OBJECT_I i)				;
 	void						RemoveUpdateObject				(PH_UPDATE_OBJECT_I i)		;
 	dGeomID						GetMeshGeom						()							{return Mesh.GetGeom();}
+IC	CPHBroadphase&				Broadphase						()							{return m_broadphase;}
 IC	dGeomID						GetMotionRayGeom				()							{return m_motion_ray;}
 	void			static		SetStep							(dReal s)					;
 	void						Destroy							()							;
@@ -60,6 +60,8 @@ float		phRigidBreakWeaponFactor								= 1.f;
 Fbox		phBoundaries											= {1000.f,1000.f,-1000.f,-1000.f};
 float		ph_tri_query_ex_aabb_rate								= 1.3f;
 int			ph_tri_clear_disable_count								= 10;
+int			ph_islands_mt											= 1;
+int			ph_broadphase											= 1;
 dWorldID	phWorld;
 
 /////////////////////////////////////
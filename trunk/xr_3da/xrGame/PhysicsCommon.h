@@ -30,6 +30,8 @@ extern	float		phBreakCommonFactor								;
 extern	float		phRigidBreakWeaponFactor						;
 extern	float		ph_tri_query_ex_aabb_rate						;
 extern	int			ph_tri_clear_disable_count						;
+extern	int			ph_islands_mt									;
+extern	int			ph_broadphase									;
 
 struct SGameMtl;
 #define ERP_S(k_p,k_d,s)		((s*(k_p)) / (((s)*(k_p)) + (k_d)))
@@ -330,7 +330,7 @@ void CAI_Stalker::OnHUDDraw				(CCustomHUD *hud)
 		float								fuzzy = 0.f;
 		xr_vector<feel_visible_Item>::iterator I=feel_visible.begin(),E=feel_visible.end();
 		for (; I!=E; I++)
-			if (I->O->ID() == memory().enemy().selected()->ID()) {
+			if (I->valid() && (I->O->ID() == memory().enemy().selected()->ID())) {
 				fuzzy						= I->fuzzy;
 				break;
 			}
@@ -999,7 +999,7 @@ void draw_visiblity_rays	(CCustomMonster *self, const CObject *object, collide::
 		VISIBLE_ITEMS::iterator	I = self->feel_visible.begin();
 		VISIBLE_ITEMS::iterator	E = self->feel_visible.end();
 		for ( ; I!=E; ++I) {
-			if ((*I).O == object) {
+			if (((*I).O == object) && (*I).valid()) {
 				item		= &*I;
 				break;
 			}
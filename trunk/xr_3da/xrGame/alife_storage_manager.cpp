@@ -21,6 +21,7 @@
 #include "saved_game_wrapper.h"
 #include "string_table.h"
 #include "../igame_persistent.h"
+#include "saved_game_writer.h"
 
 using namespace ALife;
 
@@ -28,6 +29,9 @@ extern string_path g_last_saved_game;
 
 CALifeStorageManager::~CALifeStorageManager	()
 {
+	// the level may be already gone, no notification
+	saved_game_writer().on_complete	(CSavedGameWriter::COMPLETE_CALLBACK());
+	saved_game_writer().wait	();
 }
 
 void CALifeStorageManager::save	(LPCSTR save_name, bool update_name)
@@ -46,39 +50,17 @@ void CALifeStorageManager::save	(LPCSTR save_name, bool update_name)
 		}
 	}
 
-	u32							source_count;
-	u32							dest_count;
-	void						*dest_data;
-	{
-		CMemoryWriter			stream;
-		header().save			(stream);
-		time_manager().save		(stream);
-		spawns().save			(stream);
-		objects().save			(stream);
-		registry().save			(stream);
-
-		source_count			= stream.tell();
-		void					*source_data = stream.pointer();
-		dest_count				= rtc_csize(source_count);
-		dest_data				= xr_malloc(dest_count);
-		dest_count				= rtc_compress(dest_data,dest_count,source_data,source_count);
-	}
+	// only the snapshot is taken here, compression and writing go on in background
+	CMemoryWriter				*stream = xr_new<CMemoryWriter>();
+	header().save				(*stream);
+	time_manager().save			(*stream);
+	spawns().save				(*stream);
+	objects().save				(*stream);
+	registry().save				(*stream);
 
 	string_path					temp;
 	FS.update_path				(temp,"$game_saves$",m_save_name);
-	IWriter						*writer = FS.w_open(temp);
-	writer->w_u32				(u32(-1));
-	writer->w_u32				(ALIFE_VERSION);
-	
-	writer->w_u32				(source_count);
-	writer->w					(dest_data,dest_count);
-	xr_free						(dest_data);
-	FS.w_close					(writer);
-#ifdef DEBUG
-	Msg							("* Game %s is successfully saved to file '%s' (%d bytes compressed to %d)",m_save_name,temp,source_count,dest_count + 4);
-#else // DEBUG
-	Msg							("* Game %s is successfully saved to file '%s'",m_save_name,temp);
-#endif // DEBUG
+	saved_game_writer().save	(m_save_name,temp,stream);
 
 	if (!update_name)
 		strcpy					(m_save_name,save);
@@ -121,6 +103,7 @@ bool CALifeStorageManager::load	(LPCSTR save_name)
 {
 	CTimer						timer;
 	timer.Start					();
+	saved_game_writer().wait	();
 	string256					save;
 	strcpy						(save,m_save_name);
 	if (!save_name) {
@@ -151,7 +134,13 @@ bool CALifeStorageManager::load	(LPCSTR save_name)
 
 	u32							source_count = stream->r_u32();
 	void						*source_data = xr_malloc(source_count);
-	rtc_decompress				(source_data,source_count,stream->pointer(),stream->length() - 3*sizeof(u32));
+	u32							compressed_count = stream->length() - 3*sizeof(u32);
+	if (rtcc_test(stream->pointer(),compressed_count)) {
+		VERIFY					(rtcc_size(stream->pointer()) == source_count);
+		rtcc_decompress			(source_data,source_count,stream->pointer(),compressed_count);
+	}
+	else
+		rtc_decompress			(source_data,source_count,stream->pointer(),compressed_count);
 	FS.r_close					(stream);
 	load						(source_data, source_count, file_name);
 	xr_free						(source_data);
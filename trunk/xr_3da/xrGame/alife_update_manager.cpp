@@ -22,6 +22,7 @@
 #include "restriction_space.h"
 #include "profiler.h"
 #include "mt_config.h"
+#include "saved_game_writer.h"
 
 using namespace ALife;
 
@@ -290,6 +291,7 @@ void CALifeUpdateManager::reload		(LPCSTR section)
 
 bool CALifeUpdateManager::load_game		(LPCSTR game_name, bool no_assert)
 {
+	saved_game_writer().wait	();
 	{
 		string_path				temp,file_name;
 		strconcat				(sizeof(temp),temp,game_name,SAVE_EXTENSION);
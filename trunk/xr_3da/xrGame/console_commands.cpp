@@ -65,6 +65,7 @@ ENGINE_API
 extern	float	psHUD_FOV;
 extern	float	psSqueezeVelocity;
 extern	int		psLUA_GCSTEP;
+extern	float	psLUA_GCBUDGET;
 
 extern	int		x_m_x;
 extern	int		x_m_z;
@@ -398,6 +399,26 @@ bool valid_file_name(LPCSTR file_name)
 
 #include "UIGameCustom.h"
 #include "HUDManager.h"
+#include "saved_game_writer.h"
+
+static void show_game_saved(LPCSTR save_name, bool result)
+{
+	if (!result || !g_pGameLevel || !HUD().GetUI())
+		return;
+
+	string_path					S;
+	strcpy_s					(S,save_name);
+	LPSTR						extension = strext(S);
+	if (extension && !xr_strcmp(extension,SAVE_EXTENSION))
+		*extension				= 0;
+
+	SDrawStaticStruct* _s		= HUD().GetUI()->UIGame()->AddCustomStatic("game_saved", true);
+	_s->m_endTime				= Device.fTimeGlobal+3.0f;// 3sec
+	string_path					save_name_text;
+	strconcat					(sizeof(save_name_text),save_name_text,*CStringTable().translate("st_game_saved"),": ", S);
+	_s->wnd()->SetText			(save_name_text);
+}
+
 class CCC_ALifeSave : public IConsole_Command {
 public:
 	CCC_ALifeSave(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = true; };
@@ -450,11 +471,11 @@ public:
 #ifdef DEBUG
 		Msg						("Game save overhead  : %f milliseconds",timer.GetElapsed_sec()*1000.f);
 #endif
-		SDrawStaticStruct* _s		= HUD().GetUI()->UIGame()->AddCustomStatic("game_saved", true);
-		_s->m_endTime				= Device.fTimeGlobal+3.0f;// 3sec
-		string_path					save_name;
-		strconcat					(sizeof(save_name),save_name,*CStringTable().translate("st_game_saved"),": ", S);
-		_s->wnd()->SetText			(save_name);
+		// the file is written in background, report when it is there
+		if (saved_game_writer().busy())
+			saved_game_writer().on_complete	(CSavedGameWriter::COMPLETE_CALLBACK(&show_game_saved));
+		else
+			show_game_saved		(S,true);
 
 		strcat					(S,".dds");
 		FS.update_path			(S1,"$game_saves$",S);
@@ -627,6 +648,8 @@ public:
 };
 
 
+extern BOOL g_script_bytecode_cache;
+
 #ifndef MASTER_GOLD
 class CCC_Script : public IConsole_Command {
 public:
@@ -679,6 +702,41 @@ public:
 		}
 	}
 };
+
+class CCC_ScriptCacheBuild : public IConsole_Command {
+public:
+	CCC_ScriptCacheBuild(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = true; };
+	virtual void Execute(LPCSTR args) {
+		if (!g_script_bytecode_cache) {
+			Log			("! script bytecode cache is off");
+			return;
+		}
+
+		CTimer			timer;
+		timer.Start		();
+		FS_FileSet		files;
+		FS.file_list	(files,"$game_scripts$",FS_ListFiles,"*.script");
+		u32				count = 0;
+		FS_FileSetIt	I = files.begin();
+		FS_FileSetIt	E = files.end();
+		for ( ; I != E; ++I) {
+			string_path	name_space, file_name;
+			strcpy_s	(name_space,(*I).name.c_str());
+			if (LPSTR extension = strext(name_space))
+				*extension	= 0;
+			FS.update_path	(file_name,"$game_scripts$",(*I).name.c_str());
+			if (ai().script_engine().cache_file(file_name,name_space))
+				++count;
+			else
+				Msg		("! cannot compile script %s",file_name);
+		}
+		Msg				("* %d of %d scripts are compiled into the bytecode cache (%.3fs)",count,files.size(),timer.GetElapsed_sec());
+	}
+	virtual void	Info	(TInfo& I)		
+	{
+		strcpy(I,"compile all the scripts into the bytecode cache"); 
+	}
+};
 #endif // MASTER_GOLD
 
 #ifdef DEBUG
@@ -1421,6 +1479,7 @@ void CCC_RegisterCommands()
 
 #ifdef DEBUG
 	CMD4(CCC_Integer,			"lua_gcstep",			&psLUA_GCSTEP,	1, 1000);
+	CMD4(CCC_Float,				"lua_gcbudget",			&psLUA_GCBUDGET,	0.1f, 10.f);
 	CMD3(CCC_Mask,				"ai_debug",				&psAI_Flags,	aiDebug);
 	CMD3(CCC_Mask,				"ai_dbg_brain",			&psAI_Flags,	aiBrain);
 	CMD3(CCC_Mask,				"ai_dbg_motion",		&psAI_Flags,	aiMotion);
@@ -1496,6 +1555,8 @@ void CCC_RegisterCommands()
 	CMD4(CCC_FloatBlock,		"ph_break_common_factor",		&phBreakCommonFactor		,			0.f		,1000000000.f	);
 	CMD4(CCC_FloatBlock,		"ph_rigid_break_weapon_factor",	&phRigidBreakWeaponFactor	,			0.f		,1000000000.f	);
 	CMD4(CCC_Integer,			"ph_tri_clear_disable_count",	&ph_tri_clear_disable_count	,			0,		255				);
+	CMD4(CCC_Integer,			"ph_islands_mt",				&ph_islands_mt				,			0,		1				);
+	CMD4(CCC_Integer,			"ph_broadphase",				&ph_broadphase				,			0,		1				);
 	CMD4(CCC_FloatBlock,		"ph_tri_query_ex_aabb_rate",	&ph_tri_query_ex_aabb_rate	,			1.01f	,3.f			);
 #endif // DEBUG
 
@@ -1506,10 +1567,12 @@ void CCC_RegisterCommands()
 	CMD3(CCC_Mask,			"g_unlimitedammo",	&psActorFlags,	AF_UNLIMITEDAMMO);
 	CMD1(CCC_Script,		"run_script");
 	CMD1(CCC_ScriptCommand,	"run_string");
+	CMD1(CCC_ScriptCacheBuild,	"script_cache_build");
 	CMD1(CCC_TimeFactor,	"time_factor");		
 #endif // MASTER_GOLD
 
 	CMD3(CCC_Mask,		"g_autopickup",			&psActorFlags,	AF_AUTOPICKUP);
+	CMD4(CCC_Integer,	"script_bytecode_cache",	&g_script_bytecode_cache,	0,	1);
 
 
 #ifdef DEBUG
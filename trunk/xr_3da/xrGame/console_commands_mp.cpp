@@ -169,7 +169,34 @@ public:
 	virtual void	Info	(TInfo& I){strcpy(I,"clear server net statistic"); }
 };
 
+class CCC_Net_SV_UpdateStats : public IConsole_Command {
+public:
+						CCC_Net_SV_UpdateStats	(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = true; };
+	virtual void		Execute					(LPCSTR args) 
+	{
+		if (!OnServer())	return;
+		Level().Server->DumpUpdateStats(0==xr_strcmp(args,"reset"));
+	}
+	virtual void	Info	(TInfo& I){strcpy(I,"entity update traffic per client and per class, [reset]"); }
+};
+
 #ifdef DEBUG
+class CCC_Net_SV_UpdateBench : public IConsole_Command {
+public:
+						CCC_Net_SV_UpdateBench	(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = true; };
+	virtual void		Execute					(LPCSTR args) 
+	{
+		if (!OnServer())	return;
+		u32		clients		= 64;
+		u32		ticks		= 100;
+		sscanf				(args,"%d %d",&clients,&ticks);
+		clamp				(clients,1u,1024u);
+		clamp				(ticks,1u,10000u);
+		Level().Server->BenchmarkUpdates(clients,ticks);
+	}
+	virtual void	Info	(TInfo& I){strcpy(I,"entity update tick cost against synthetic clients, [max_clients] [ticks]"); }
+};
+
 class CCC_Dbg_NumObjects : public IConsole_Command {
 public:
 						CCC_Dbg_NumObjects	(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = true; };
@@ -1265,6 +1292,7 @@ void register_mp_console_commands()
 #ifdef DEBUG
 	CMD3(CCC_Mask,		"net_dump_size",		&psNET_Flags,		NETFLAG_DBG_DUMPSIZE	);
 	CMD1(CCC_Dbg_NumObjects,"net_dbg_objects"				);
+	CMD1(CCC_Net_SV_UpdateBench,"net_sv_update_bench"		);
 #endif // DEBUG
 	CMD3(CCC_GSCDKey,	"cdkey",				gsCDKey,			sizeof(gsCDKey)			);
 	CMD4(CCC_Integer,	"g_eventdelay",			&g_dwEventDelay,	0,	1000);
@@ -1316,6 +1344,13 @@ void register_mp_console_commands()
 	CMD4(CCC_Integer,		"net_dbg_dump_update_write",	&g_Dump_Update_Write, 0, 1);
 	CMD4(CCC_Integer,		"net_dbg_dump_update_read",	&g_Dump_Update_Read, 0, 1);
 
+	CMD4(CCC_Integer,		"sv_update_interest",			&g_sv_update_interest, 0, 1);
+	CMD4(CCC_Integer,		"sv_update_delta",				&g_sv_update_delta, 0, 1);
+	CMD4(CCC_Float,			"sv_update_near",				&g_sv_update_near, 5.f, 500.f);
+	CMD4(CCC_Float,			"sv_update_min_rate",			&g_sv_update_min_rate, 0.01f, 1.f);
+	CMD4(CCC_Integer,		"sv_update_budget",				&g_sv_update_budget, 0, 65536);
+	CMD1(CCC_Net_SV_UpdateStats,	"net_sv_update_stats");
+
 	CMD1(CCC_ReturnToBase,	"sv_return_to_base");
 	CMD1(CCC_GetServerAddress,"get_server_address");		
 
@@ -0,0 +1,81 @@
+#include "stdafx.h"
+#include "net_update_delta.h"
+
+u32		net_update_delta::encode	(const u8* base, const u8* data, u32 size, u8* dst)
+{
+	VERIFY				(size<=max_payload);
+	u8*		it			= dst;
+	for (u32 b=0; b<size; b+=8)
+	{
+		u8*		mask	= it++;
+		*mask			= 0;
+		u32		e		= _min(b+8,size);
+		for (u32 i=b; i<e; i++)	{
+			if (base[i]==data[i])	continue;
+			*mask		|= u8(1<<(i-b));
+			*it++		= data[i];
+		}
+	}
+	return				u32(it-dst);
+}
+
+bool	net_update_delta::decode	(const u8* base, u32 size, const u8* src, u32 src_size, u8* dst)
+{
+	const u8*	it		= src;
+	const u8*	end		= src+src_size;
+	for (u32 b=0; b<size; b+=8)
+	{
+		if (it>=end)	return false;
+		u8		mask	= *it++;
+		u32		e		= _min(b+8,size);
+		for (u32 i=b; i<e; i++)	{
+			if (mask&(1<<(i-b)))	{
+				if (it>=end)	return false;
+				dst[i]	= *it++;
+			} else
+				dst[i]	= base[i];
+		}
+	}
+	return				it==end;
+}
+
+//////////////////////////////////////////////////////////////////////
+const CNetUpdateBaselines::slot*	CNetUpdateBaselines::find	(u16 id, u16 seq)
+{
+	ENTITIES_IT		I	= entities.find(id);
+	if (I==entities.end())	return	0;
+	entity*			E	= I->second;
+	for (u32 it=0; it<net_update_delta::window; it++)
+		if (E->slots[it].size && E->slots[it].seq==seq)	return &E->slots[it];
+	return			0;
+}
+
+void	CNetUpdateBaselines::store	(u16 id, u16 seq, const u8* data, u32 size)
+{
+	VERIFY			(size && size<=net_update_delta::max_payload);
+	entity*&		E	= entities[id];
+	if (0==E)		{
+		E				= xr_new<entity>();
+		ZeroMemory		(E,sizeof(entity));
+	}
+	slot&			S	= E->slots[E->next];
+	E->next				= (E->next+1)%net_update_delta::window;
+	S.seq				= seq;
+	S.size				= u8(size);
+	CopyMemory			(S.data,data,size);
+}
+
+void	CNetUpdateBaselines::forget	(u16 id)
+{
+	ENTITIES_IT		I	= entities.find(id);
+	if (I==entities.end())	return;
+	xr_delete		(I->second);
+	entities.erase	(I);
+}
+
+void	CNetUpdateBaselines::clear	()
+{
+	for (ENTITIES_IT I=entities.begin(); I!=entities.end(); I++)
+		xr_delete		(I->second);
+	entities.clear		();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Entity update payloads (UPDATE_Write output) go to remote clients either in full, or as a delta
+// against a baseline - a payload of the same entity from an earlier update the client acknowledged.
+// Delta layout: one mask byte per 8 payload bytes (bit set - byte changed), then the changed bytes.
+namespace net_update_delta
+{
+	enum	{ window		= 8		};	// a delta never references a baseline older than this many updates
+	enum	{ max_payload	= 255	};	// payload size goes as u8
+	enum	{ max_encoded	= max_payload + (max_payload+7)/8	};
+	enum	{ max_parts		= 32	};	// packets per client update, acknowledged as a bit mask
+	enum	{ entry_header	= sizeof(u16)+sizeof(u8)+sizeof(u8)	};	// id, base, size
+	enum	{ part_header	= sizeof(u16)+sizeof(u16)+sizeof(u8)	};	// message, seq, part
+
+	u32		encode			(const u8* base, const u8* data, u32 size, u8* dst);							// returns encoded size
+	bool	decode			(const u8* base, u32 size, const u8* src, u32 src_size, u8* dst);				// dst gets 'size' bytes
+};
+
+// Client side: the last received payloads of every entity
+class CNetUpdateBaselines
+{
+public:
+	struct slot
+	{
+		u16				seq;
+		u8				size;
+		u8				data	[net_update_delta::max_payload];
+	};
+private:
+	struct entity
+	{
+		slot			slots	[net_update_delta::window];
+		u32				next;
+	};
+	DEFINE_MAP			(u16,entity*,ENTITIES,ENTITIES_IT);
+	ENTITIES			entities;
+public:
+						~CNetUpdateBaselines	()	{ clear(); }
+	const slot*			find					(u16 id, u16 seq);
+	void				store					(u16 id, u16 seq, const u8* data, u32 size);
+	void				forget					(u16 id);
+	void				clear					();
+};
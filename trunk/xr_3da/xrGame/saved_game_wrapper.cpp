@@ -14,6 +14,7 @@
 #include "ai_space.h"
 #include "game_graph.h"
 #include "alife_simulator_header.h"
+#include "saved_game_writer.h"
 
 extern LPCSTR alife_section;
 
@@ -27,6 +28,7 @@ LPCSTR CSavedGameWrapper::saved_game_full_name	(LPCSTR saved_game_name, string_p
 
 bool CSavedGameWrapper::saved_game_exist		(LPCSTR saved_game_name)
 {
+	saved_game_writer().wait	();
 	string_path					file_name;
 	return						(!!FS.exist(saved_game_full_name(saved_game_name,file_name)));
 }
@@ -47,6 +49,7 @@ bool CSavedGameWrapper::valid_saved_game		(IReader &stream)
 
 bool CSavedGameWrapper::valid_saved_game		(LPCSTR saved_game_name)
 {
+	saved_game_writer().wait	();
 	string_path					file_name;
 	if (!FS.exist(saved_game_full_name(saved_game_name,file_name)))
 		return					(false);
@@ -57,8 +60,43 @@ bool CSavedGameWrapper::valid_saved_game		(LPCSTR saved_game_name)
 	return						(result);
 }
 
+// only the chunk headers, the time and the actor are unpacked from the chunked container
+void CSavedGameWrapper::unpack_summary		(u8 *data, u32 data_size, const void *source, u32 source_size)
+{
+	u32							chunk_header = 2*sizeof(u32);
+	for (u32 position = 0; position + chunk_header <= data_size; ) {
+		rtcc_decompress			(data,data_size,source,source_size,position,chunk_header);
+		u32						id = *(u32*)(data + position) & ~CFS_CompressMark;
+		u32						size = *(u32*)(data + position + sizeof(u32));
+		position				+= chunk_header;
+
+		switch (id) {
+			case GAME_TIME_CHUNK_DATA : {
+				rtcc_decompress	(data,data_size,source,source_size,position,size);
+				break;
+			}
+			case OBJECT_CHUNK_DATA : {
+				// object count, then the spawn and the update packets of the actor
+				u32				offset = position;
+				rtcc_decompress	(data,data_size,source,source_size,offset,sizeof(u32));
+				offset			+= sizeof(u32);
+				for (u32 i=0; i<2; ++i) {
+					rtcc_decompress(data,data_size,source,source_size,offset,sizeof(u16));
+					u32			packet_size = *(u16*)(data + offset);
+					offset		+= sizeof(u16);
+					rtcc_decompress(data,data_size,source,source_size,offset,packet_size);
+					offset		+= packet_size;
+				}
+				break;
+			}
+		}
+		position				+= size;
+	}
+}
+
 CSavedGameWrapper::CSavedGameWrapper		(LPCSTR saved_game_name)
 {
+	saved_game_writer().wait	();
 	string_path					file_name;
 	saved_game_full_name		(saved_game_name,file_name);
 	R_ASSERT3					(FS.exist(file_name),"There is no saved game ",file_name);
@@ -75,7 +113,11 @@ CSavedGameWrapper::CSavedGameWrapper		(LPCSTR saved_game_name)
 
 	u32							source_count = stream->r_u32();
 	void						*source_data = xr_malloc(source_count);
-	rtc_decompress				(source_data,source_count,stream->pointer(),stream->length() - 3*sizeof(u32));
+	u32							compressed_count = stream->length() - 3*sizeof(u32);
+	if (rtcc_test(stream->pointer(),compressed_count))
+		unpack_summary			((u8*)source_data,source_count,stream->pointer(),compressed_count);
+	else
+		rtc_decompress			(source_data,source_count,stream->pointer(),compressed_count);
 	FS.r_close					(stream);
 
 	IReader						reader(source_data,source_count);
@@ -22,6 +22,9 @@ private:
 	_LEVEL_ID	m_level_id;
 	float		m_actor_health;
 
+private:
+	static	void			unpack_summary		(u8 *data, u32 data_size, const void *source, u32 source_size);
+
 public:
 							CSavedGameWrapper	(LPCSTR saved_game_name);
 	static	LPCSTR			saved_game_full_name(LPCSTR saved_game_name, string_path& result);
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: saved_game_writer.cpp
+//	Description : compresses and writes saved games on a background thread
+////////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+#include "saved_game_writer.h"
+#include "alife_space.h"
+
+CSavedGameWriter &saved_game_writer	()
+{
+	static CSavedGameWriter		writer;
+	return						(writer);
+}
+
+CSavedGameWriter::CSavedGameWriter	()
+{
+	m_stream					= 0;
+	m_writer					= 0;
+	m_source_count				= 0;
+	m_dest_count				= 0;
+	m_busy						= FALSE;
+	m_done						= CreateEvent(NULL,TRUE,FALSE,NULL);
+}
+
+CSavedGameWriter::~CSavedGameWriter	()
+{
+	VERIFY						(!m_busy);
+	CloseHandle					(m_done);
+}
+
+void CSavedGameWriter::save			(LPCSTR save_name, LPCSTR file_name, CMemoryWriter *stream)
+{
+	wait						();
+
+	strcpy_s					(m_save_name,save_name);
+	strcpy_s					(m_file_name,file_name);
+	strconcat					(sizeof(m_temp_name),m_temp_name,file_name,".tmp");
+	m_stream					= stream;
+	m_writer					= FS.w_open(m_temp_name);
+	m_source_count				= stream->size();
+	m_dest_count				= 0;
+
+	m_busy						= TRUE;
+	ResetEvent					(m_done);
+	thread_spawn				(worker,"X-RAY save game writer",0,this);
+}
+
+void CSavedGameWriter::worker		(void *params)
+{
+	CSavedGameWriter			*self = (CSavedGameWriter*)params;
+	self->compress_and_write	();
+	SetEvent					(self->m_done);
+}
+
+// background thread: nothing here touches the file system registry
+void CSavedGameWriter::compress_and_write	()
+{
+	u32							source_count = m_source_count;
+	u32							dest_count = rtcc_csize(source_count);
+	void						*dest_data = xr_malloc(dest_count);
+	dest_count					= rtcc_compress(dest_data,dest_count,m_stream->pointer(),source_count);
+	m_stream->free				();
+
+	if (m_writer->valid()) {
+		m_writer->w_u32			(u32(-1));
+		m_writer->w_u32			(ALIFE_VERSION);
+		m_writer->w_u32			(source_count);
+		m_writer->w				(dest_data,dest_count);
+	}
+	xr_free						(dest_data);
+	m_dest_count				= dest_count;
+}
+
+// game thread: the temporary file replaces the saved game
+void CSavedGameWriter::finish		()
+{
+	VERIFY						(m_busy);
+	xr_delete					(m_stream);
+
+	bool						result = m_writer->valid();
+	FS.w_close					(m_writer);
+	if (result) {
+		FS.file_rename			(m_temp_name,m_file_name,true);
+#ifdef DEBUG
+		Msg						("* Game %s is successfully saved to file '%s' (%d bytes compressed to %d)",m_save_name,m_file_name,m_source_count,m_dest_count + 4);
+#else // DEBUG
+		Msg						("* Game %s is successfully saved to file '%s'",m_save_name,m_file_name);
+#endif // DEBUG
+	}
+	else
+		Msg						("! Cannot save game %s to file '%s'",m_save_name,m_file_name);
+
+	m_busy						= FALSE;
+
+	if (m_callback) {
+		COMPLETE_CALLBACK		callback = m_callback;
+		m_callback.clear		();
+		callback				(m_save_name,result);
+	}
+}
+
+void CSavedGameWriter::update		()
+{
+	if (m_busy && (WAIT_OBJECT_0 == WaitForSingleObject(m_done,0)))
+		finish					();
+}
+
+void CSavedGameWriter::wait			()
+{
+	if (!m_busy)
+		return;
+
+	WaitForSingleObject			(m_done,INFINITE);
+	finish						();
+}
+
+void CSavedGameWriter::on_complete	(const COMPLETE_CALLBACK &callback)
+{
+	m_callback					= callback;
+}
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: saved_game_writer.h
+//	Description : compresses and writes saved games on a background thread
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// The game thread only serializes the simulator into memory and hands the stream over.
+// The file is written under a temporary name and replaces the saved game when complete,
+// so an interrupted save never damages the previous one.
+class CSavedGameWriter {
+public:
+	typedef fastdelegate::FastDelegate2<LPCSTR,bool>	COMPLETE_CALLBACK;		// save name, success
+
+private:
+	CMemoryWriter		*m_stream;
+	IWriter				*m_writer;
+	string_path			m_save_name;
+	string_path			m_file_name;
+	string_path			m_temp_name;
+	u32					m_source_count;
+	u32					m_dest_count;
+	HANDLE				m_done;
+	volatile BOOL		m_busy;
+	COMPLETE_CALLBACK	m_callback;
+
+private:
+	static	void		worker					(void *params);
+			void		compress_and_write		();
+			void		finish					();
+
+public:
+						CSavedGameWriter		();
+						~CSavedGameWriter		();
+			void		save					(LPCSTR save_name, LPCSTR file_name, CMemoryWriter *stream);
+			void		update					();
+			void		wait					();
+	IC		bool		busy					() const	{ return !!m_busy; }
+			void		on_complete				(const COMPLETE_CALLBACK &callback);
+};
+
+extern CSavedGameWriter &saved_game_writer		();
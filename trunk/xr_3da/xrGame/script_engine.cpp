@@ -29,6 +29,9 @@ CScriptEngine::CScriptEngine			()
 {
 	m_stack_level			= 0;
 	m_reload_modules		= false;
+	m_gc_heap				= 0;
+	m_gc_heap_collected		= 0;
+	m_gc_alloc_rate			= 0.f;
 	m_last_no_file_length	= 0;
 	*m_last_no_file			= 0;
 
@@ -186,6 +189,7 @@ void CScriptEngine::init				()
 
 #ifdef XRGAME_EXPORTS
 	load_common_scripts					();
+	dump_load_stats						();
 #endif
 	m_stack_level						= lua_gettop(lua());
 }
@@ -362,6 +366,60 @@ void CScriptEngine::add_no_file		(LPCSTR file_name, u32 string_length)
 
 void CScriptEngine::collect_all_garbage	()
 {
+	CTimer					T;
+	T.Start					();
 	lua_gc					(lua(),LUA_GCCOLLECT,0);
 	lua_gc					(lua(),LUA_GCCOLLECT,0);
+
+	m_gc_heap				= lua_gc(lua(),LUA_GCCOUNT,0);
+	m_gc_heap_collected		= m_gc_heap;
+	m_gc_alloc_rate			= 0.f;
+
+#ifndef XRSE_FACTORY_EXPORTS
+	Device.Statistic->ScriptGC_full		++;
+	Device.Statistic->ScriptGC_pause	= T.GetElapsed_sec()*1000.f;
+	Device.Statistic->ScriptGC_heap		= m_gc_heap;
+#endif
+}
+
+// Incremental collection paced by the allocation rate: every frame the collector is stepped at least
+// as far as the scripts allocated since the previous frame (with some reserve to catch up), but no
+// longer than the time budget. The budget is doubled while the heap is more than twice as large as
+// right after the last full collection, so the debt never grows to a noticeable full cycle.
+void CScriptEngine::gc_step				(u32 quantum, float budget_ms)
+{
+#ifndef XRSE_FACTORY_EXPORTS
+	Device.Statistic->ScriptGC.Begin	();
+#endif
+
+	u32						heap = lua_gc(lua(),LUA_GCCOUNT,0);
+	if (heap>m_gc_heap)
+		m_gc_alloc_rate		= .9f*m_gc_alloc_rate + .1f*float(heap - m_gc_heap);
+	else
+		m_gc_alloc_rate		= .9f*m_gc_alloc_rate;
+
+	if (m_gc_heap_collected && (heap > 2*m_gc_heap_collected))
+		budget_ms			*= 2.f;
+
+	u32						target = _max(quantum,iFloor(m_gc_alloc_rate*1.25f));
+	u32						stepped = 0;
+	CTimer					T;
+	T.Start					();
+	while (stepped<target) {
+		if (lua_gc(lua(),LUA_GCSTEP,quantum)) {
+			// cycle finished
+			m_gc_heap_collected	= lua_gc(lua(),LUA_GCCOUNT,0);
+			break;
+		}
+		stepped				+= quantum;
+		if (T.GetElapsed_sec()*1000.f >= budget_ms)
+			break;
+	}
+	m_gc_heap				= lua_gc(lua(),LUA_GCCOUNT,0);
+
+#ifndef XRSE_FACTORY_EXPORTS
+	Device.Statistic->ScriptGC_step		= stepped;
+	Device.Statistic->ScriptGC_heap		= m_gc_heap;
+	Device.Statistic->ScriptGC.End		();
+#endif
 }
@@ -48,6 +48,11 @@ protected:
 	int							m_stack_level;
 	shared_str					m_class_registrators;
 
+private:
+	u32							m_gc_heap;					// (Kb) after the last step
+	u32							m_gc_heap_collected;		// (Kb) after the last full collection
+	float						m_gc_alloc_rate;			// (Kb) per step, smoothed
+
 protected:
 #ifdef USE_DEBUGGER
 	CScriptDebugger				*m_scriptDebugger;
@@ -92,6 +97,7 @@ public:
 			CScriptDebugger		*debugger					();
 #endif
 			void				collect_all_garbage			();
+			void				gc_step						(u32 quantum, float budget_ms);
 
 	DECLARE_SCRIPT_REGISTER_FUNCTION
 };
@@ -53,6 +53,10 @@ LPCSTR	file_header = 0;
 #	include "script_debugger.h"
 #endif
 
+#ifndef NO_XRGAME_SCRIPT_ENGINE
+#	define USE_BYTECODE_CACHE
+#endif
+
 #ifndef PURE_ALLOC
 #	ifndef USE_MEMORY_MONITOR
 #		define USE_DL_ALLOCATOR
@@ -88,9 +92,41 @@ u32 game_lua_memory_usage	()
 }
 #endif // USE_DL_ALLOCATOR
 
+#ifdef USE_BYTECODE_CACHE
+// compiled scripts are kept in $app_data_root$\scripts_cache\ and are used while the source
+// (with the namespace header) and the chunk name have the same CRC
+BOOL	g_script_bytecode_cache		= TRUE;
+#define	BYTECODE_CACHE_VERSION		u32(1)
+
+static int __cdecl lua_dump_writer	(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	((CMemoryWriter*)ud)->w	(p,u32(sz));
+	return					(0);
+}
+
+static LPCSTR bytecode_cache_name	(LPCSTR caScriptName, string_path &result)
+{
+	if (!FS.path_exist("$script_cache$"))
+		FS.append_path		("$script_cache$",FS.get_path("$app_data_root$")->m_Path,"scripts_cache\\",TRUE);
+
+	LPCSTR					name = strrchr(caScriptName,'\\');
+	name					= name ? name + 1 : caScriptName;
+	if ('@' == *name)
+		++name;
+
+	string_path				temp;
+	strconcat				(sizeof(temp),temp,name,".luac");
+	FS.update_path			(result,"$script_cache$",temp);
+	return					(result);
+}
+#endif // USE_BYTECODE_CACHE
+
 CScriptStorage::CScriptStorage		()
 {
 	m_current_thread		= 0;
+	m_loaded_sources		= 0;
+	m_loaded_cached			= 0;
+	m_load_time				= 0.f;
 
 #ifdef DEBUG
 	m_stack_is_ready		= false;
@@ -110,6 +146,10 @@ void CScriptStorage::reinit	()
 	if (m_virtual_machine)
 		lua_close			(m_virtual_machine);
 
+	m_loaded_sources		= 0;
+	m_loaded_cached			= 0;
+	m_load_time				= 0.f;
+
 #ifndef USE_DL_ALLOCATOR
 	m_virtual_machine		= lua_newstate(lua_alloc_xr, NULL);
 #else // USE_DL_ALLOCATOR
@@ -306,7 +346,64 @@ bool CScriptStorage::parse_namespace(LPCSTR caNamespaceName, LPSTR b, LPSTR c)
 	return			(true);
 }
 
-bool CScriptStorage::load_buffer	(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, LPCSTR caNameSpaceName)
+int CScriptStorage::load_chunk	(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, bool use_cache)
+{
+	CTimer				timer;
+	timer.Start			();
+	int					l_iErrorCode;
+
+#ifdef USE_BYTECODE_CACHE
+	if (use_cache && g_script_bytecode_cache) {
+		u32				crc = crc32(caBuffer,u32(tSize));
+		u32				name_crc = crc32(caScriptName,xr_strlen(caScriptName));
+		string_path		file_name;
+		bytecode_cache_name	(caScriptName,file_name);
+
+		if (FS.exist(file_name)) {
+			IReader		*reader = FS.r_open(file_name);
+			bool		valid = 
+				(reader->length() > 4*sizeof(u32))		&&
+				(reader->r_u32() == BYTECODE_CACHE_VERSION)	&&
+				(reader->r_u32() == crc)				&&
+				(reader->r_u32() == u32(tSize))			&&
+				(reader->r_u32() == name_crc);
+			l_iErrorCode= valid ? luaL_loadbuffer(L,(LPCSTR)reader->pointer(),reader->elapsed(),caScriptName) : LUA_ERRSYNTAX;
+			FS.r_close	(reader);
+
+			if (valid && !l_iErrorCode) {
+				++m_loaded_cached;
+				m_load_time	+= timer.GetElapsed_sec();
+				return	(0);
+			}
+
+			// stale or from another VM build
+			if (valid)
+				lua_pop	(L,1);
+		}
+
+		l_iErrorCode	= luaL_loadbuffer(L,caBuffer,tSize,caScriptName);
+		if (!l_iErrorCode) {
+			CMemoryWriter	stream;
+			stream.w_u32	(BYTECODE_CACHE_VERSION);
+			stream.w_u32	(crc);
+			stream.w_u32	(u32(tSize));
+			stream.w_u32	(name_crc);
+			lua_dump		(L,lua_dump_writer,&stream);
+			stream.save_to	(file_name);
+		}
+		++m_loaded_sources;
+		m_load_time		+= timer.GetElapsed_sec();
+		return			(l_iErrorCode);
+	}
+#endif // USE_BYTECODE_CACHE
+
+	l_iErrorCode		= luaL_loadbuffer(L,caBuffer,tSize,caScriptName);
+	++m_loaded_sources;
+	m_load_time			+= timer.GetElapsed_sec();
+	return				(l_iErrorCode);
+}
+
+bool CScriptStorage::load_buffer	(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, LPCSTR caNameSpaceName, bool use_cache)
 {
 	int					l_iErrorCode;
 	if (caNameSpaceName && xr_strcmp("_G",caNameSpaceName)) {
@@ -323,7 +420,7 @@ bool CScriptStorage::load_buffer	(lua_State *L, LPCSTR caBuffer, size_t tSize, L
 		CopyMemory	(script + str_len,caBuffer,u32(tSize));
 //		try 
 		{
-			l_iErrorCode= luaL_loadbuffer(L,script,tSize + str_len,caScriptName);
+			l_iErrorCode= load_chunk(L,script,tSize + str_len,caScriptName,use_cache);
 		}
 //		catch(...) {
 //			l_iErrorCode= LUA_ERRSYNTAX;
@@ -333,7 +430,7 @@ bool CScriptStorage::load_buffer	(lua_State *L, LPCSTR caBuffer, size_t tSize, L
 	else {
 //		try
 		{
-			l_iErrorCode= luaL_loadbuffer(L,caBuffer,tSize,caScriptName);
+			l_iErrorCode= load_chunk(L,caBuffer,tSize,caScriptName,use_cache);
 		}
 //		catch(...) {
 //			l_iErrorCode= LUA_ERRSYNTAX;
@@ -360,7 +457,7 @@ bool CScriptStorage::do_file	(LPCSTR caScriptName, LPCSTR caNameSpaceName)
 	}
 	strconcat		(sizeof(l_caLuaFileName),l_caLuaFileName,"@",caScriptName);
 	
-	if (!load_buffer(lua(),static_cast<LPCSTR>(l_tpFileReader->pointer()),(size_t)l_tpFileReader->length(),l_caLuaFileName,caNameSpaceName)) {
+	if (!load_buffer(lua(),static_cast<LPCSTR>(l_tpFileReader->pointer()),(size_t)l_tpFileReader->length(),l_caLuaFileName,caNameSpaceName,true)) {
 //		VERIFY		(lua_gettop(lua()) >= 4);
 //		lua_pop		(lua(),4);
 //		VERIFY		(lua_gettop(lua()) == start - 3);
@@ -402,6 +499,31 @@ bool CScriptStorage::do_file	(LPCSTR caScriptName, LPCSTR caNameSpaceName)
 	return			(true);
 }
 
+// compiles the script into the bytecode cache without running it
+bool CScriptStorage::cache_file	(LPCSTR caScriptName, LPCSTR caNamespaceName)
+{
+	int				start = lua_gettop(lua());
+	IReader			*l_tpFileReader = FS.r_open(caScriptName);
+	if (!l_tpFileReader)
+		return		(false);
+
+	string_path		l_caLuaFileName;
+	strconcat		(sizeof(l_caLuaFileName),l_caLuaFileName,"@",caScriptName);
+	bool			result = load_buffer(lua(),static_cast<LPCSTR>(l_tpFileReader->pointer()),(size_t)l_tpFileReader->length(),l_caLuaFileName,caNamespaceName,true);
+	FS.r_close		(l_tpFileReader);
+	lua_settop		(lua(),start);
+	return			(result);
+}
+
+void CScriptStorage::dump_load_stats	()
+{
+#ifdef USE_BYTECODE_CACHE
+	Msg				("* scripts : %d compiled, %d from bytecode cache (%s), %.3fs",m_loaded_sources,m_loaded_cached,g_script_bytecode_cache ? "on" : "off",m_load_time);
+#else // USE_BYTECODE_CACHE
+	Msg				("* scripts : %d compiled, %.3fs",m_loaded_sources,m_load_time);
+#endif // USE_BYTECODE_CACHE
+}
+
 bool CScriptStorage::load_file_into_namespace(LPCSTR caScriptName, LPCSTR caNamespaceName)
 {
 	int				start = lua_gettop(lua());
@@ -38,11 +38,17 @@ protected:
 	CMemoryWriter				m_output;
 #endif // DEBUG
 
+protected:
+	u32							m_loaded_sources	;
+	u32							m_loaded_cached		;
+	float						m_load_time			;
+
 protected:
 	static	int					vscript_log					(ScriptStorage::ELuaMessageType tLuaMessageType, LPCSTR caFormat, va_list marker);
 			bool				parse_namespace				(LPCSTR caNamespaceName, LPSTR b, LPSTR c);
 			bool				do_file						(LPCSTR	caScriptName, LPCSTR caNameSpaceName);
 			void				reinit						();
+			int					load_chunk					(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, bool use_cache);
 
 public:
 #ifdef DEBUG
@@ -55,7 +61,9 @@ public:
 	IC		lua_State			*lua						();
 	IC		void				current_thread				(CScriptThread *thread);
 	IC		CScriptThread		*current_thread				() const;
-			bool				load_buffer					(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, LPCSTR caNameSpaceName = 0);
+			bool				load_buffer					(lua_State *L, LPCSTR caBuffer, size_t tSize, LPCSTR caScriptName, LPCSTR caNameSpaceName = 0, bool use_cache = false);
+			bool				cache_file					(LPCSTR	caScriptName, LPCSTR caNamespaceName);
+			void				dump_load_stats				();
 			bool				load_file_into_namespace	(LPCSTR	caScriptName, LPCSTR caNamespaceName);
 			bool				namespace_loaded			(LPCSTR	caName, bool remove_from_stack = true);
 			bool				object						(LPCSTR	caIdentifier, int type);
@@ -84,6 +84,7 @@ void _detail::callback		(CBoneInstance *B)
 #undef TEMPLATE_SPECIALIZATION
 #undef _detail
 
+// callbacks only read the stalker state, bones may be calculated on worker threads
 void CStalkerAnimationManager::assign_bone_callbacks	()
 {
 	CKinematics						*kinematics = smart_cast<CKinematicsAnimated*>(m_visual);
@@ -92,11 +93,11 @@ void CStalkerAnimationManager::assign_bone_callbacks	()
 	LPCSTR							section = *object().cNameSect();
 	
 	int								head_bone = kinematics->LL_BoneID(pSettings->r_string(section,"bone_head"));
-	kinematics->LL_GetBoneInstance	(u16(head_bone)).set_callback(bctCustom,&head::callback,&object());
+	kinematics->LL_GetBoneInstance	(u16(head_bone)).set_callback(bctCustom,&head::callback,&object(),FALSE,TRUE);
 
 	int								shoulder_bone = kinematics->LL_BoneID(pSettings->r_string(section,"bone_shoulder"));
-	kinematics->LL_GetBoneInstance	(u16(shoulder_bone)).set_callback(bctCustom,&shoulder::callback,&object());
+	kinematics->LL_GetBoneInstance	(u16(shoulder_bone)).set_callback(bctCustom,&shoulder::callback,&object(),FALSE,TRUE);
 
 	int								spin_bone = kinematics->LL_BoneID(pSettings->r_string(section,"bone_spin"));
-	kinematics->LL_GetBoneInstance	(u16(spin_bone)).set_callback(bctCustom,&spine::callback,&object());
+	kinematics->LL_GetBoneInstance	(u16(spin_bone)).set_callback(bctCustom,&spine::callback,&object(),FALSE,TRUE);
 }
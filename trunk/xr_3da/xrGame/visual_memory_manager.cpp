@@ -457,7 +457,7 @@ void CVisualMemoryManager::check_visibles	() const
 		xr_vector<Feel::Vision::feel_visible_Item>::iterator	i = m_object->feel_visible.begin();
 		xr_vector<Feel::Vision::feel_visible_Item>::iterator	e = m_object->feel_visible.end();
 		for (; i!=e; ++i)
-			if (i->O->ID() == (*I).m_object->ID()) {
+			if (i->valid() && (i->O->ID() == (*I).m_object->ID())) {
 				VERIFY						(i->fuzzy > 0.f);
 				break;
 			}
@@ -67,6 +67,9 @@ enum {
 	M_REMOTE_CONTROL_CMD,
 	M_BATTLEYE,
 	M_MAP_SYNC,
+	//-----------------------------------------------------
+	M_UPDATE_DELTA,				// SV: entity updates, full or delta against an acknowledged baseline
+	M_UPDATE_ACK,				// CL: received parts of the last M_UPDATE_DELTA, then the entities whose delta had no baseline
 
 	MSG_FORCEDWORD				= u32(-1)
 };
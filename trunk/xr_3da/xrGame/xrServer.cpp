@@ -38,6 +38,7 @@ void	xrClientData::Clear()
 	m_ping_warn.m_maxPingWarnings			= 0;
 	m_ping_warn.m_dwLastMaxPingWarningTime	= 0;
 	m_admin_rights.m_has_admin_rights		= FALSE;
+	net_Updates.clear						();
 };
 
 xrClientData::~xrClientData()
@@ -48,7 +49,7 @@ xrClientData::~xrClientData()
 
 xrServer::xrServer():IPureServer(Device.GetTimerGlobal(), g_dedicated_server)
 {
-	m_iCurUpdatePacket = 0;
+	m_update_parts = 0;
 	m_aUpdatePackets.push_back(NET_Packet());
 	m_aDelayedPackets.clear();
 }
@@ -289,10 +290,7 @@ void xrServer::Update	()
 
 void xrServer::SendUpdatesToAll()
 {
-	m_iCurUpdatePacket = 0;
-	NET_Packet* pCurUpdatePacket = &(m_aUpdatePackets[0]);
-	pCurUpdatePacket->B.count = 0;
-	u32	 position;
+	bool bFrameReady = false;
 
 	for (u32 client=0; client<net_Players.size(); ++client)
 	{// for each client
@@ -320,15 +318,11 @@ void xrServer::SendUpdatesToAll()
 			continue;
 		}
 
+		SendTo							(Client->ID,Packet,net_flags(FALSE,TRUE));
 
-		if (m_aUpdatePackets[0].B.count != 0) //not a first client in update cycle
+		// Entities: written once, filtered and delta-compressed per client
+		if (!bFrameReady)
 		{
-			m_aUpdatePackets[0].w_seek(0, Packet.B.data, Packet.B.count);			
-		}
-		else
-		{
-			m_aUpdatePackets[0].w(Packet.B.data, Packet.B.count);				
-
 			if (g_Dump_Update_Write) 
 			{
 				if (Client->ps)
@@ -336,75 +330,11 @@ void xrServer::SendUpdatesToAll()
 				else
 					Msg("---- UPDATE_Write to %s --- ", *(Client->name));
 			}
-			
-	
-
-			NET_Packet						tmpPacket;			
-
-			xrS_entities::iterator I	= entities.begin();
-			xrS_entities::iterator E	= entities.end();
-			for (; I!=E; ++I)
-			{//all entities
-				CSE_Abstract&	Test = *(I->second);
-
-				if (0==Test.owner)								continue;
-				if (!Test.net_Ready)							continue;
-				if (Test.s_flags.is(M_SPAWN_OBJECT_PHANTOM))	continue;	// Surely: phantom
-				if (!Test.Net_Relevant() )						continue;
-
-				tmpPacket.B.count					= 0;
-				// write specific data
-				{
-					tmpPacket.w_u16					(Test.ID);
-					tmpPacket.w_chunk_open8			(position);
-					Test.UPDATE_Write				(tmpPacket);
-					u32 ObjectSize					= u32(tmpPacket.w_tell()-position)-sizeof(u8);
-					tmpPacket.w_chunk_close8		(position);
-
-					if (ObjectSize == 0)						continue;					
-#ifdef DEBUG
-					if (g_Dump_Update_Write) Msg("* %s : %d", Test.name(), ObjectSize);
-#endif
-
-					if (pCurUpdatePacket->B.count + tmpPacket.B.count >= NET_PacketSizeLimit)
-					{
-						m_iCurUpdatePacket++;
-
-						if (m_aUpdatePackets.size() == m_iCurUpdatePacket) m_aUpdatePackets.push_back(NET_Packet());
-
-						PacketType = M_UPDATE_OBJECTS;
-						pCurUpdatePacket = &(m_aUpdatePackets[m_iCurUpdatePacket]);
-						pCurUpdatePacket->w_begin(PacketType);						
-					}
-					pCurUpdatePacket->w(tmpPacket.B.data, tmpPacket.B.count);
-				}//all entities
-			}
+			BuildUpdateFrame			();
+			bFrameReady					= true;
+			if (g_Dump_Update_Write) Msg("----------------------- ");
 		}
-
-		//.#ifdef DEBUG
-		if (g_Dump_Update_Write) Msg("----------------------- ");
-		//.#endif			
-		for (u32 p =0; p<=m_iCurUpdatePacket; p++)
-		{
-			NET_Packet& ToSend = m_aUpdatePackets[p];
-			if (ToSend.B.count>2)
-			{
-				//.#ifdef DEBUG
-				if (g_Dump_Update_Write && Client->ps != NULL) 
-				{
-					Msg ("- Server Update[%d] to Client[%s]  : %d", 
-						*((u16*)ToSend.B.data), 
-						Client->ps->getName(), 
-						ToSend.B.count);
-				}
-//.#endif
-
-				
-				SendTo			(Client->ID,ToSend,net_flags(FALSE,TRUE));
-			}
-		}
-
-
+		SendUpdateFrame					(Client);
 	};	// for each client
 #ifdef DEBUG
 	g_sv_SendUpdate = 0;
@@ -538,6 +468,17 @@ u32 xrServer::OnMessage	(NET_Packet& P, ClientID sender)			// Non-Zero means bro
 				SendTo	(SV_Client->ID, P, net_flags(TRUE, TRUE));
 			VERIFY					(verify_entities());
 		}break;
+	case M_UPDATE_ACK:
+		{
+			xrClientData* CL		= ID_to_client	(sender);
+			if (!CL)				break;
+			u16 seq					= P.r_u16();
+			u32 parts				= P.r_u32();
+			CL->net_Updates.ack		(seq,parts);
+			u8 lost					= P.r_u8();
+			for (u8 it=0; it<lost; ++it)
+				CL->net_Updates.lost(P.r_u16());
+		}break;
 	case M_MOVE_PLAYERS_RESPOND:
 		{
 			xrClientData* CL		= ID_to_client	(sender);
@@ -754,6 +695,11 @@ void			xrServer::entity_Destroy	(CSE_Abstract *&P)
 	entities.erase				(P->ID);
 	m_tID_Generator.vfFreeID	(P->ID,Device.TimerAsync());
 
+	csPlayers.Enter				();
+	for (u32 client=0; client<net_Players.size(); ++client)
+		((xrClientData*)net_Players[client])->net_Updates.forget	(P->ID);
+	csPlayers.Leave				();
+
 	if(P->owner && P->owner->owner==P)
 		P->owner->owner		= NULL;
 
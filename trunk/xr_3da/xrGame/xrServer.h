@@ -11,6 +11,7 @@
 #include "game_sv_base.h"
 #include "id_generator.h"
 #include "battleye.h"
+#include "xrServer_updates.h"
 
 #ifdef DEBUG
 //. #define SLOW_VERIFY_ENTITIES
@@ -33,6 +34,7 @@ public:
 	
 	BOOL					net_PassUpdates;
 	u32						net_LastMoveUpdateTime;
+	xrClientUpdates			net_Updates;
 	
 	game_PlayerState*		ps;
 	struct{
@@ -64,9 +66,20 @@ private:
 	xrS_entities				entities;
 	xr_multiset<svs_respawn>	q_respawn;
 
-	u16							m_iCurUpdatePacket;
 	xr_vector<NET_Packet>		m_aUpdatePackets;
 
+	ref_update_slab				m_update_slab;			// of the current update
+	xr_vector<ref_update_slab>	m_update_slabs;			// pool, slabs still referenced by the sent history are busy
+	xr_vector<xrUpdateCandidate>	m_update_candidates;
+	xr_vector<xrUpdateSlice>	m_update_slices;		// gather list of the client being written
+	xr_vector<u8>				m_update_scratch;		// its deltas
+	u32							m_update_parts;
+	xrUpdateClassStatsMap		m_update_class_stats;
+	void						BuildUpdateFrame		();
+	u16							WriteUpdateFrame		(xrClientUpdates& U, xrClientData* Owner, CSE_Abstract* View);
+	void						AssembleUpdatePart		(u16 seq, u32 part, NET_Packet& P);
+	void						SendUpdateFrame			(xrClientData* Client);
+
 	struct DelayedPacket
 	{
 		ClientID		SenderID;
@@ -186,6 +199,8 @@ public:
 
 	xrClientData*			ID_to_client		(ClientID ID, bool ScanAll = false ) { return (xrClientData*)(IPureServer::ID_to_client( ID, ScanAll)); }
 	CSE_Abstract*			ID_to_entity		(u16 ID);
+	void					DumpUpdateStats		(bool reset);
+	void					BenchmarkUpdates	(u32 max_clients, u32 ticks);
 
 	// main
 	virtual EConnect		Connect				(shared_str& session_name);
@@ -72,4 +72,9 @@ void xrServer::SLS_Clear		()
 		}
 		R_ASSERT						(found);
 	}
+
+	csPlayers.Enter						();
+	for (u32 client=0; client<net_Players.size(); ++client)
+		((xrClientData*)net_Players[client])->net_Updates.reset	();
+	csPlayers.Leave						();
 }
@@ -0,0 +1,357 @@
+#include "stdafx.h"
+#include "xrServer.h"
+#include "xrServer_Objects.h"
+#include "xrMessages.h"
+
+int		g_sv_update_interest	= 1;
+int		g_sv_update_delta		= 1;
+float	g_sv_update_near		= 30.f;
+float	g_sv_update_min_rate	= 1.f/16.f;
+int		g_sv_update_budget		= 4096;
+
+extern	int		g_Dump_Update_Write;
+
+//////////////////////////////////////////////////////////////////////
+void xrClientUpdates::clear		()
+{
+	reset				();
+	seq					= 1;
+	stat.clear			();
+}
+
+// the ids get reused by the next entities, so the sent history goes too: a late ack of it
+// would turn a payload of the old entity into a baseline of the new one
+void xrClientUpdates::reset		()
+{
+	entities.clear		();
+	for (u32 it=0; it<net_update_delta::window; it++)	{
+		frames[it].seq	= 0;
+		frames[it].slab	= NULL;
+		frames[it].items.clear	();
+	}
+}
+
+// the id may be reused by a new entity, the sent history must not give it the old payloads
+void xrClientUpdates::forget		(u16 id)
+{
+	entities.erase		(id);
+	for (u32 it=0; it<net_update_delta::window; it++)	{
+		sent_frame&		F	= frames[it];
+		if (!F.slab)	continue;
+		u32				count	= 0;
+		for (u32 i=0; i<F.items.size(); i++)
+			if (F.slab->items[F.items[i].item].id!=id)	F.items[count++]	= F.items[i];
+		F.items.resize	(count);
+	}
+}
+
+// the next update of the entity goes in full
+void xrClientUpdates::lost		(u16 id)
+{
+	ENTITIES_IT			it	= entities.find(id);
+	if (it!=entities.end())		it->second.base_size	= 0;
+}
+
+// the client got 'parts' of the update 'ack_seq' - sent payloads become baselines
+void xrClientUpdates::ack		(u16 ack_seq, u32 parts)
+{
+	sent_frame&			F	= frames[ack_seq%net_update_delta::window];
+	if (F.seq!=ack_seq)	return;		// too old
+	if (!F.slab)		return;
+
+	xr_vector<sent_item>::const_iterator	I = F.items.begin();
+	xr_vector<sent_item>::const_iterator	E = F.items.end();
+	for (; I!=E; ++I)
+	{
+		if (0==(parts&(1<<I->part)))	continue;
+		const xrUpdateSlab::item&	item	= F.slab->items[I->item];
+		ENTITIES_IT		it	= entities.find(item.id);
+		if (it==entities.end())			continue;
+		entity&			S	= it->second;
+		if (S.base_size && (s16(ack_seq-S.base_seq)<=0))	continue;
+		S.base_seq			= ack_seq;
+		S.base_size			= item.size;
+		CopyMemory			(S.base,F.slab->payload(item),item.size);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void xrServer::BuildUpdateFrame	()
+{
+	// the previous slabs stay alive while the clients may still acknowledge them
+	m_update_slab					= NULL;
+	xrUpdateSlab*	slab			= 0;
+	for (u32 it=0; it<m_update_slabs.size(); it++)
+		if (1==m_update_slabs[it]->dwReference)	{ slab = m_update_slabs[it]._get(); break; }
+	if (0==slab)	{
+		slab						= xr_new<xrUpdateSlab>();
+		m_update_slabs.push_back	(slab);
+	}
+	m_update_slab					= slab;
+	slab->clear						();
+
+	NET_Packet						tmpPacket;
+	u32								position;
+	xrS_entities::iterator I		= entities.begin();
+	xrS_entities::iterator E		= entities.end();
+	for (; I!=E; ++I)
+	{//all entities
+		CSE_Abstract&	Test = *(I->second);
+
+		if (0==Test.owner)								continue;
+		if (!Test.net_Ready)							continue;
+		if (Test.s_flags.is(M_SPAWN_OBJECT_PHANTOM))	continue;	// Surely: phantom
+		if (!Test.Net_Relevant() )						continue;
+
+		tmpPacket.B.count				= 0;
+		tmpPacket.w_u16					(Test.ID);
+		tmpPacket.w_u8					(0);			// base: full payload
+		tmpPacket.w_chunk_open8			(position);
+		Test.UPDATE_Write				(tmpPacket);
+		u32 ObjectSize					= u32(tmpPacket.w_tell()-position)-sizeof(u8);
+		tmpPacket.w_chunk_close8		(position);
+
+		if (ObjectSize == 0)			continue;
+#ifdef DEBUG
+		if (g_Dump_Update_Write)		Msg("* %s : %d", Test.name(), ObjectSize);
+#endif
+
+		// attached entities are as relevant as their holder
+		CSE_Abstract*	Root			= &Test;
+		if (0xffff!=Test.ID_Parent)	{
+			CSE_Abstract*	Parent		= ID_to_entity(Test.ID_Parent);
+			if (Parent)		Root		= Parent;
+		}
+
+		xrUpdateSlab::item				item;
+		item.E							= &Test;
+		item.id							= Test.ID;
+		item.size						= u8(ObjectSize);
+		item.offset						= slab->data.size();
+		item.position					= Root->o_Position;
+		slab->items.push_back			(item);
+		slab->data.insert				(slab->data.end(),tmpPacket.B.data,tmpPacket.B.data+tmpPacket.B.count);
+	}
+}
+
+// fills the gather list (m_update_slices, m_update_parts) of the next update of the client
+u16 xrServer::WriteUpdateFrame	(xrClientUpdates& U, xrClientData* Owner, CSE_Abstract* View)
+{
+	xrUpdateSlab&					slab	= *m_update_slab;
+	u16								seq	= U.seq++;
+	xrClientUpdates::sent_frame&	F	= U.frames[seq%net_update_delta::window];
+	F.seq							= seq;
+	F.slab							= m_update_slab;
+	F.items.clear					();
+	U.stat.updates					++;
+
+	// relevancy: near entities and the own ones every update, the rest less often by distance
+	bool			interest		= g_sv_update_interest && View;
+	m_update_candidates.clear		();
+	for (u32 it=0; it<slab.items.size(); it++)
+	{
+		xrUpdateSlab::item&			I	= slab.items[it];
+		xrClientUpdates::ENTITIES_IT	S_it	= U.entities.find(I.id);
+		if (S_it==U.entities.end())	{
+			xrClientUpdates::entity	S;
+			S.priority				= 0;
+			S.base_seq				= 0;
+			S.base_size				= 0;
+			S_it					= U.entities.insert(mk_pair(I.id,S)).first;
+		}
+		xrClientUpdates::entity&	S	= S_it->second;
+
+		float		rate			= 1.f;
+		if (interest && (0==Owner || I.E->owner!=Owner))	{
+			float	dist			= View->o_Position.distance_to(I.position);
+			if (dist>g_sv_update_near)	rate	= _max(g_sv_update_near/dist,g_sv_update_min_rate);
+		}
+		S.priority					+= rate;
+		if (S.priority<1.f)			continue;
+
+		xrUpdateCandidate			C	= { S.priority, it, &S };
+		m_update_candidates.push_back(C);
+	}
+	u32			budget				= (interest && g_sv_update_budget) ? u32(g_sv_update_budget) : u32(-1);
+	if (u32(-1)!=budget)			std::sort(m_update_candidates.begin(),m_update_candidates.end());
+
+	// gather: full payloads are slices of the slab, deltas go to the scratch
+	u8			encoded				[net_update_delta::max_encoded];
+	u32			written				= 0;
+	u32			part				= 0;
+	u32			part_size			= net_update_delta::part_header;
+	m_update_slices.clear			();
+	m_update_scratch.clear			();
+	for (u32 it=0; it<m_update_candidates.size(); it++)
+	{
+		xrUpdateCandidate&			C	= m_update_candidates[it];
+		xrUpdateSlab::item&			I	= slab.items[C.item];
+		xrClientUpdates::entity&	S	= *C.state;
+		if (written>=budget)		{ U.stat.deferred++; continue; }
+
+		u32			wsize			= I.size;
+		u8			base			= 0;
+		if (g_sv_update_delta && (S.base_size==I.size) && (u16(seq-S.base_seq)<net_update_delta::window))
+		{
+			u32		dsize			= net_update_delta::encode(S.base,slab.payload(I),I.size,encoded);
+			if (dsize<I.size)		{
+				wsize				= dsize;
+				base				= u8(seq-S.base_seq);
+			}
+		}
+		u32			esize			= net_update_delta::entry_header+wsize;
+
+		if (part_size+esize >= NET_PacketSizeLimit)
+		{
+			if (part+1 == net_update_delta::max_parts)	{ U.stat.deferred++; continue; }
+			part					++;
+			part_size				= net_update_delta::part_header;
+		}
+
+		xrUpdateSlice				slice;
+		slice.size					= u16(esize);
+		slice.part					= u8(part);
+		if (base)
+		{
+			slice.offset			= m_update_scratch.size();
+			slice.scratch			= TRUE;
+			m_update_scratch.resize	(slice.offset+esize);
+			u8*		dst				= &m_update_scratch[slice.offset];
+			*(u16*)dst				= I.id;
+			dst[2]					= base;
+			dst[3]					= u8(wsize);
+			CopyMemory				(dst+net_update_delta::entry_header,encoded,wsize);
+			m_update_slices.push_back	(slice);
+		}
+		else
+		{
+			slice.offset			= I.offset;
+			slice.scratch			= FALSE;
+			xrUpdateSlice*	last	= m_update_slices.empty() ? 0 : &m_update_slices.back();
+			if (last && !last->scratch && (last->part==slice.part) && (last->offset+last->size==slice.offset))
+				last->size			= u16(last->size+esize);		// neighbour entries of the slab go as one
+			else
+				m_update_slices.push_back	(slice);
+		}
+		part_size					+= esize;
+		written						+= esize;
+		S.priority					= 0;
+
+		// history for acknowledges
+		xrClientUpdates::sent_item	H	= { C.item, part };
+		F.items.push_back			(H);
+
+		// statistics
+		U.stat.sent					++;
+		U.stat.deltas				+= base ? 1 : 0;
+		U.stat.raw_bytes			+= I.size;
+		U.stat.wire_bytes			+= wsize;
+		xrUpdateClassStats&			CS	= m_update_class_stats[I.E->s_name];
+		CS.sent						++;
+		CS.raw_bytes				+= I.size;
+		CS.wire_bytes				+= wsize;
+	}
+	m_update_parts					= part+1;
+	return							seq;
+}
+
+void xrServer::AssembleUpdatePart	(u16 seq, u32 part, NET_Packet& P)
+{
+	P.w_begin						(M_UPDATE_DELTA);
+	P.w_u16							(seq);
+	P.w_u8							(u8(part));
+	xr_vector<xrUpdateSlice>::const_iterator	I = m_update_slices.begin();
+	xr_vector<xrUpdateSlice>::const_iterator	E = m_update_slices.end();
+	for (; I!=E; ++I)
+	{
+		if (I->part!=part)			continue;
+		const u8*	src				= I->scratch ? &m_update_scratch[I->offset] : &m_update_slab->data[I->offset];
+		P.w							(src,I->size);
+	}
+}
+
+void xrServer::SendUpdateFrame	(xrClientData* Client)
+{
+	u16			seq					= WriteUpdateFrame(Client->net_Updates,Client,Client->owner);
+	NET_Packet&	ToSend				= m_aUpdatePackets[0];
+	for (u32 p=0; p<m_update_parts; p++)
+	{
+		AssembleUpdatePart			(seq,p,ToSend);
+		if (ToSend.B.count<=net_update_delta::part_header)	continue;
+		if (g_Dump_Update_Write && Client->ps != NULL)
+			Msg ("- Server Update[%d:%d] to Client[%s]  : %d", seq, p, Client->ps->getName(), ToSend.B.count);
+		SendTo						(Client->ID,ToSend,net_flags(FALSE,TRUE));
+	}
+}
+
+void xrServer::DumpUpdateStats	(bool reset)
+{
+	Msg		("* entity updates, per client:");
+	for (u32 client=0; client<net_Players.size(); ++client)
+	{
+		xrClientData*				Client	= (xrClientData*) net_Players[client];
+		xrClientUpdates::stats&		S		= Client->net_Updates.stat;
+		Msg		("- %-20s: %6d upd, %7d ent (%7d delta, %6d deferred), %9d/%9d bytes (%3.0f%%)",
+			Client->ps ? Client->ps->getName() : *Client->name,
+			S.updates,S.sent,S.deltas,S.deferred,S.wire_bytes,S.raw_bytes,
+			S.raw_bytes ? 100.f*float(S.wire_bytes)/float(S.raw_bytes) : 100.f);
+		if (reset)	S.clear	();
+	}
+	Msg		("* entity updates, per class:");
+	for (xrUpdateClassStatsMapIt I=m_update_class_stats.begin(); I!=m_update_class_stats.end(); ++I)
+	{
+		xrUpdateClassStats&			S		= I->second;
+		Msg		("- %-32s: %7d ent, %9d/%9d bytes (%3.0f%%)",
+			*I->first,S.sent,S.wire_bytes,S.raw_bytes,
+			S.raw_bytes ? 100.f*float(S.wire_bytes)/float(S.raw_bytes) : 100.f);
+	}
+	if (reset)	m_update_class_stats.clear	();
+}
+
+// tick cost against the number of clients: synthetic clients look from the entities around
+// and acknowledge everything at once, nothing goes to the network
+void xrServer::BenchmarkUpdates	(u32 max_clients, u32 ticks)
+{
+	BuildUpdateFrame				();
+	xr_vector<CSE_Abstract*>		views;
+	for (u32 it=0; it<m_update_slab->items.size(); it++)
+		views.push_back				(m_update_slab->items[it].E);
+	if (views.empty())				{ Msg("! no entities to update"); return; }
+
+	xrUpdateClassStatsMap			class_stats	= m_update_class_stats;
+	NET_Packet						P;
+	CTimer							timer;
+	Msg		("* entity updates benchmark, %d entities, %d ticks:",views.size(),ticks);
+	for (u32 clients=1; clients<=max_clients; clients*=2)
+	{
+		xr_vector<xrClientUpdates>	synthetic	(clients);
+		for (u32 c=0; c<clients; c++)	synthetic[c].clear	();
+
+		float	t_build				= 0;
+		float	t_write				= 0;
+		u32		bytes				= 0;
+		for (u32 tick=0; tick<ticks; tick++)
+		{
+			timer.Start				();
+			BuildUpdateFrame		();
+			t_build					+= timer.GetElapsed_sec();
+
+			timer.Start				();
+			for (u32 c=0; c<clients; c++)
+			{
+				u16		seq			= WriteUpdateFrame(synthetic[c],0,views[c%views.size()]);
+				for (u32 p=0; p<m_update_parts; p++)
+				{
+					AssembleUpdatePart	(seq,p,P);
+					bytes			+= P.B.count;
+				}
+				synthetic[c].ack	(seq,(m_update_parts<32) ? (1<<m_update_parts)-1 : u32(-1));
+			}
+			t_write					+= timer.GetElapsed_sec();
+		}
+		float	k					= 1000.f/float(ticks);
+		Msg		("- %4d clients: %7.3f ms/tick (build %6.3f, write %7.3f, %6.3f per client), %7d bytes/tick",
+			clients,(t_build+t_write)*k,t_build*k,t_write*k,t_write*k/float(clients),bytes/ticks);
+	}
+	m_update_class_stats			= class_stats;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "net_update_delta.h"
+
+class CSE_Abstract;
+
+extern	int		g_sv_update_interest;		// relevancy/priority filtering
+extern	int		g_sv_update_delta;			// delta compression
+extern	float	g_sv_update_near;			// (m) closer entities go every update
+extern	float	g_sv_update_min_rate;		// rate of the farthest entities
+extern	int		g_sv_update_budget;			// (bytes) per client per update, 0 - unlimited
+
+// Entity payloads of one server update, written once for all the clients.
+// Entries are stored framed as the full ones go to the wire (id, base 0, size, payload), so a
+// client packet is a gather list of slab slices; sent history of the clients references the slab.
+class xrUpdateSlab : public xr_resource
+{
+public:
+	struct item
+	{
+		CSE_Abstract*		E;
+		u16					id;
+		u8					size;			// of the payload
+		u32					offset;			// of the framed entry
+		Fvector				position;		// of the root parent
+	};
+	xr_vector<item>			items;
+	xr_vector<u8>			data;
+
+	void					clear			()						{ items.clear(); data.clear(); }
+	IC const u8*			entry			(const item& I) const	{ return &data[I.offset]; }
+	IC const u8*			payload			(const item& I) const	{ return &data[I.offset+net_update_delta::entry_header]; }
+};
+typedef	resptr_core<xrUpdateSlab,resptr_base<xrUpdateSlab> >	ref_update_slab;
+
+// Piece of a client packet: either a run of slab entries or a delta from the client scratch
+struct xrUpdateSlice
+{
+	u32						offset;
+	u16						size;
+	u8						part;
+	u8						scratch;
+};
+
+// Per-client update state: priorities, acknowledged baselines and the sent history
+struct xrClientUpdates
+{
+	struct entity
+	{
+		float				priority;		// accumulated relevance, sent at >= 1
+		u16					base_seq;
+		u8					base_size;		// 0 - no baseline
+		u8					base			[net_update_delta::max_payload];
+	};
+	struct sent_item
+	{
+		u32					item;			// in the slab
+		u32					part;
+	};
+	struct sent_frame
+	{
+		u16					seq;
+		ref_update_slab		slab;
+		xr_vector<sent_item>	items;
+	};
+	struct stats
+	{
+		u32					updates;
+		u32					sent;			// entities
+		u32					deltas;
+		u32					deferred;		// relevant, but out of budget
+		u32					raw_bytes;		// UPDATE_Write size
+		u32					wire_bytes;		// what actually went
+
+		void				clear			()	{ ZeroMemory(this,sizeof(*this)); }
+	};
+
+	DEFINE_MAP				(u16,entity,ENTITIES,ENTITIES_IT);
+	ENTITIES				entities;
+	sent_frame				frames			[net_update_delta::window];
+	u16						seq;			// of the next update
+	stats					stat;
+
+	void					clear			();
+	void					reset			();				// level change: no entity states or history, the sequence goes on
+	void					forget			(u16 id);		// entity destroyed
+	void					lost			(u16 id);		// the client has no baseline of the entity
+	void					ack				(u16 ack_seq, u32 parts);
+};
+
+struct xrUpdateCandidate
+{
+	float					priority;
+	u32						item;			// in xrUpdateSlab
+	xrClientUpdates::entity*	state;
+
+	bool					operator <		(const xrUpdateCandidate& other) const	{ return priority>other.priority; }	// more urgent first
+};
+
+// Traffic per entity class (section)
+struct xrUpdateClassStats
+{
+	u32						sent;
+	u32						raw_bytes;
+	u32						wire_bytes;
+};
+DEFINE_MAP(shared_str,xrUpdateClassStats,xrUpdateClassStatsMap,xrUpdateClassStatsMapIt);
@@ -81,6 +81,10 @@ CDetailManager::CDetailManager	()
 	hw_BatchSize= 0;
 	hw_VB		= 0;
 	hw_IB		= 0;
+	DS_empty.w_id	(0,DetailSlot::ID_Empty);
+	DS_empty.w_id	(1,DetailSlot::ID_Empty);
+	DS_empty.w_id	(2,DetailSlot::ID_Empty);
+	DS_empty.w_id	(3,DetailSlot::ID_Empty);
 }
 
 CDetailManager::~CDetailManager	()
@@ -139,6 +143,10 @@ void CDetailManager::Load		()
 	for (u32 i=0; i<3; ++i)	m_visibles[i].resize(objects.size());
 	cache_Initialize	();
 
+	// Colliders for decompression on worker threads
+	for (u32 w=1; w<WorkerPool.workers(); ++w)
+		xrc_MT.push_back	(xr_new<xrXRC>());
+
 	// Make dither matrix
 	bwdithermap		(2,dither);
 
@@ -174,6 +182,11 @@ void CDetailManager::Unload		()
 	m_visibles[0].clear	();
 	m_visibles[1].clear	();
 	m_visibles[2].clear	();
+#ifndef _EDITOR
+	for (u32 w=0; w<xrc_MT.size(); ++w)
+		xr_delete		(xrc_MT[w]);
+	xrc_MT.clear		();
+#endif
 	FS.r_close			(dtFS);
 }
 
@@ -308,7 +321,11 @@ void __stdcall	CDetailManager::MT_CALC		()
 			int s_z	= iFloor			(EYE.z/dm_slot_size+.5f);
 
 			Device.Statistic->RenderDUMP_DT_Cache.Begin	();
+#ifdef _EDITOR
 			cache_Update				(s_x,s_z,EYE,dm_max_decompress);
+#else
+			cache_Update				(s_x,s_z,EYE,dm_max_decompress*WorkerPool.workers());
+#endif
 			Device.Statistic->RenderDUMP_DT_Cache.End	();
 
 			UpdateVisibleM				();
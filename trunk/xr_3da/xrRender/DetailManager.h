@@ -101,14 +101,18 @@ public:
 
 #ifndef _EDITOR    
 	xrXRC							xrc;
+	xr_vector<xrXRC*>				xrc_MT;										// colliders of worker threads [worker_id-1]
+	IC xrXRC&						xrc_worker		(u32 worker_id)	{ return worker_id?*xrc_MT[worker_id-1]:xrc; }
 #endif    
 	CacheSlot1 						cache_level1[dm_cache1_line][dm_cache1_line];
 	Slot*							cache		[dm_cache_line][dm_cache_line];	// grid-cache itself
 	svector<Slot*,dm_cache_size>	cache_task;									// non-unpacked slots
+	svector<Slot*,dm_cache_size>	cache_batch;								// slots being unpacked this frame
 	Slot							cache_pool	[dm_cache_size];				// just memory for slots
 	int								cache_cx;
 	int								cache_cz;
 
+	xrCriticalSection				poolSI_MT;									// poolSI access from worker threads
 	PSS								poolSI;										// pool    SlotItem
 
 	void							UpdateVisibleM	();
@@ -151,7 +155,8 @@ public:
 	void							cache_Update	(int sx, int sz, Fvector& view, int limit);
 	void							cache_Task		(int gx, int gz, Slot* D);
 	Slot*							cache_Query		(int sx, int sz);
-	void							cache_Decompress(Slot* D);
+	void							cache_Decompress(Slot* D, u32 worker_id=0);
+	void	__stdcall				cache_DecompressMT(u32 begin, u32 end, u32 worker_id);
 	BOOL							cache_Validate	();
     // cache grid to world
 	int								cg2w_X			(int x)			{ return cache_cx-dm_size+x;					}
@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "DetailManager.h"
 
+typedef std::pair<float,CDetailManager::Slot*>	slot_dist;
+IC bool	slot_dist_pred	(const slot_dist& A, const slot_dist& B)	{ return A.first<B.first; }
+
 void CDetailManager::cache_Initialize	()
 {
 	// Centroid
@@ -147,37 +150,44 @@ void	CDetailManager::cache_Update	(int v_x, int v_z, Fvector& view, int limit)
 	BOOL	bFullUnpack		= FALSE;
 	if (cache_task.size() == dm_cache_size)	{ limit = dm_cache_size; bFullUnpack=TRUE; }
 
-	for (int iteration=0; cache_task.size() && (iteration<limit); iteration++){
-		u32		best_id		= 0;
-		float	best_dist	= flt_max;
-
-		if (bFullUnpack){
-			best_id			= cache_task.size()-1;
-		} else {
-			for (u32 entry=0; entry<cache_task.size(); entry++){
-				// Gain access to data
-				Slot*		S	= cache_task[entry];
-				VERIFY		(stPending == S->type);
-
-				// Estimate
-				Fvector		C;
-				S->vis.box.getcenter	(C);
-				float		D	= view.distance_to_sqr	(C);
-
-				// Select
-				if (D<best_dist)
-				{
-					best_dist	= D;
-					best_id		= entry;
-				}
-			}
+	// Select nearest pending slots into batch
+	cache_batch.clear		();
+	if (bFullUnpack || (int(cache_task.size())<=limit)){
+		for (u32 entry=0; entry<cache_task.size(); entry++)
+			cache_batch.push_back	(cache_task[entry]);
+		cache_task.clear	();
+	} else {
+		static xr_vector<slot_dist>	sorted;
+		sorted.clear_not_free		();
+		for (u32 entry=0; entry<cache_task.size(); entry++){
+			// Gain access to data
+			Slot*		S	= cache_task[entry];
+			VERIFY		(stPending == S->type);
+
+			// Estimate
+			Fvector		C;
+			S->vis.box.getcenter	(C);
+			sorted.push_back		(mk_pair(view.distance_to_sqr(C),S));
 		}
+		std::sort			(sorted.begin(),sorted.end(),slot_dist_pred);
 
-		// Decompress and remove task
-		cache_Decompress	(cache_task[best_id]);
-		cache_task.erase	(best_id);
+		cache_task.clear	();
+		for (u32 entry=0; entry<sorted.size(); entry++){
+			if (int(entry)<limit)	cache_batch.push_back	(sorted[entry].second);
+			else					cache_task.push_back	(sorted[entry].second);
+		}
 	}
 
+	// Decompress, fanned out to worker threads
+#ifdef _EDITOR
+	for (u32 it=0; it<cache_batch.size(); it++)
+		cache_Decompress	(cache_batch[it]);
+#else
+	WorkerPool.parallel_for	(cache_batch.size(),1,CWorkerPool::range_callback(this,&CDetailManager::cache_DecompressMT));
+	Device.Statistic->RenderDUMP_DT_Pending	= cache_task.size();
+#endif
+	cache_batch.clear		();
+
     if (bNeedMegaUpdate){
         for (int _mz1=0; _mz1<dm_cache1_line; _mz1++){
             for (int _mx1=0; _mx1<dm_cache1_line; _mx1++){
@@ -205,11 +215,7 @@ DetailSlot&	CDetailManager::QueryDB(int sx, int sz)
 		u32 linear_id				= db_z*dtH.size_x + db_x;
 		return dtSlots				[linear_id];
 	} else {
-		// Empty slot
-		DS_empty.w_id				(0,DetailSlot::ID_Empty);
-		DS_empty.w_id				(1,DetailSlot::ID_Empty);
-		DS_empty.w_id				(2,DetailSlot::ID_Empty);
-		DS_empty.w_id				(3,DetailSlot::ID_Empty);
+		// Empty slot, filled once by constructor - decompression workers only read it
 		return DS_empty;
 	}
 }
@@ -39,7 +39,13 @@ IC bool		InterpolateAndDither(float* alpha255,	u32 x, u32 y, u32 sx, u32 sy, u32
 	return	c	> dither[col][row];
 }
 
-void		CDetailManager::cache_Decompress(Slot* S)
+void		CDetailManager::cache_DecompressMT(u32 begin, u32 end, u32 worker_id)
+{
+	for (u32 it=begin; it<end; it++)
+		cache_Decompress	(cache_batch[it],worker_id);
+}
+
+void		CDetailManager::cache_Decompress(Slot* S, u32 worker_id)
 {
 	VERIFY				(S);
 	Slot&	D			= *S;
@@ -59,6 +65,7 @@ void		CDetailManager::cache_Decompress(Slot* S)
     Scene->BoxPickObjects(D.vis.box,pinf,GetSnapList());
 	u32	triCount		= pinf.size();
 #else
+	xrXRC&		xrc		= xrc_worker(worker_id);
 	xrc.box_options		(CDB::OPT_FULL_TEST); 
 	xrc.box_query		(g_pGameLevel->ObjectSpace.GetStaticModel(),bC,bD);
 	u32	triCount		= xrc.r_count	();
@@ -83,12 +90,14 @@ void		CDetailManager::cache_Decompress(Slot* S)
 	float		jitter		= density/1.7f;
 	u32			d_size		= iCeil	(dm_slot_size/density);
 	svector<int,dm_obj_in_slot>		selected;
+	xr_vector<SlotItem>				created		[dm_obj_in_slot];	// poolSI is shared, so items are moved there at once
 
     u32 p_rnd	= D.sx*D.sz; //      ()
 	CRandom				r_selection	(0x12071980^p_rnd);
 	CRandom				r_jitter	(0x12071980^p_rnd);
 	CRandom				r_yaw		(0x12071980^p_rnd);
 	CRandom				r_scale		(0x12071980^p_rnd);
+	CRandom				r_wave		(0x12071980^p_rnd);
 
 	// Prepare to actual-bounds-calculations
 	Fbox				Bounds;
@@ -117,8 +126,7 @@ void		CDetailManager::cache_Decompress(Slot* S)
 			else					index = selected[r_selection.randI(selected.size())];
 
 			CDetail*	Dobj	= objects[DS.r_id(index)];
-			SlotItem*	ItemP	= poolSI.create();
-			SlotItem&	Item	= *ItemP;
+			SlotItem	Item;
 
 			// Position (XZ)
 			float		rx = (float(x)/float(d_size))*dm_slot_size + D.vis.box.min.x;
@@ -210,15 +218,29 @@ Device.Statistic->TEST0.End		();
 				if (Dobj->m_Flags.is(DO_NO_WAVING))	Item.vis_ID	= 0;
 				else
 				{
-					if (::Random.randI(0,3)==0)	Item.vis_ID	= 2;	// Second wave
+					if (r_wave.randI(0,3)==0)	Item.vis_ID	= 2;	// Second wave
 					else						Item.vis_ID = 1;	// First wave
 				}
 			}
 
 			// Save it
-			D.G[index].items.push_back(ItemP);
+			created[index].push_back(Item);
+		}
+	}
+
+	poolSI_MT.Enter		();
+	for (u32 index=0; index<dm_obj_in_slot; index++)
+	{
+		SlotItemVec&	items	= D.G[index].items;
+		items.reserve	(items.size()+created[index].size());
+		for (xr_vector<SlotItem>::iterator it=created[index].begin(); it!=created[index].end(); it++)
+		{
+			SlotItem*	ItemP	= poolSI.create();
+			*ItemP				= *it;
+			items.push_back		(ItemP);
 		}
 	}
+	poolSI_MT.Leave		();
 
 	// Update bounds to more tight and real ones
 	D.vis.clear			();
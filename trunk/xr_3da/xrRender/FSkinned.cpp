@@ -186,6 +186,16 @@ void CSkeletonX_ST::Render	(float LOD)
 {
 	_Render		(rm_geom,vCount,0,dwPrimitives);
 }
+u32 CSkeletonX_PM::_SoftVertices	()
+{
+	if (RM_SKINNING_SOFT!=RenderMode)	return 0;
+	return		nSWI.sw[inherited1::last_lod].num_verts;
+}
+u32 CSkeletonX_ST::_SoftVertices	()
+{
+	if (RM_SKINNING_SOFT!=RenderMode)	return 0;
+	return		vCount;
+}
 
 //////////////////////////////////////////////////////////////////////
 void CSkeletonX_PM::Release()
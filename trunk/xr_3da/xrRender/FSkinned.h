@@ -46,6 +46,7 @@ public:
 	virtual void			EnumBoneVertices(SEnumVerticesCallback &C, u16 bone_id);
 	virtual BOOL			PickBone		(Fvector& normal, float& dist, const Fvector& start, const Fvector& dir, u16 bone_id);
 	virtual void			FillVertices	(const Fmatrix& view, CSkeletonWallmark& wm, const Fvector& normal, float size, u16 bone_id);
+	virtual u32				_SoftVertices	();
 private:
 	CSkeletonX_ST				(const CSkeletonX_ST& other);
 	void	operator=			( const CSkeletonX_ST& other);
@@ -67,6 +68,7 @@ public:
 	virtual void			EnumBoneVertices(SEnumVerticesCallback &C, u16 bone_id);
 	virtual BOOL			PickBone		(Fvector& normal, float& dist, const Fvector& start, const Fvector& dir, u16 bone_id);
 	virtual void			FillVertices	(const Fmatrix& view, CSkeletonWallmark& wm, const Fvector& normal, float size, u16 bone_id);
+	virtual u32				_SoftVertices	();
 private:
 	CSkeletonX_PM				(const CSkeletonX_PM& other);
 	void	operator=			( const CSkeletonX_PM& other);
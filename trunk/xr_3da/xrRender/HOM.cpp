@@ -284,6 +284,21 @@ BOOL CHOM::visible		(Fbox2& B, float depth)
 }
 
 BOOL CHOM::visible		(vis_data& vis)
+{
+	if (Device.dwFrame<vis.hom_frame)	return TRUE;				// not at this time :)
+	if (!bEnabled)						return TRUE;				// return - everything visible
+
+#ifdef DEBUG
+	Device.Statistic->RenderCALC_HOM.Begin	();
+#endif
+	BOOL result			= visible			(vis,::Random);
+#ifdef DEBUG
+	Device.Statistic->RenderCALC_HOM.End	();
+#endif
+	return result;
+}
+
+BOOL CHOM::visible		(vis_data& vis, CRandom& rnd)
 {
 	if (Device.dwFrame<vis.hom_frame)	return TRUE;				// not at this time :)
 	if (!bEnabled)						return TRUE;				// return - everything visible
@@ -295,23 +310,17 @@ BOOL CHOM::visible		(vis_data& vis)
 	u32 frame_current	= Device.dwFrame;
 	// u32	frame_prev		= frame_current-1;
 
-#ifdef DEBUG
-	Device.Statistic->RenderCALC_HOM.Begin	();
-#endif
 	BOOL result			= _visible			(vis.box,m_xform_01);
 	u32  delay			= 1;
 	if (result)
 	{
 		// visible	- delay next test
-		delay			= ::Random.randI	(5*2,5*5);
+		delay			= rnd.randI			(5*2,5*5);
 	} else {
 		// hidden	- shedule to next frame
 	}
 	vis.hom_frame			= frame_current + delay;
 	vis.hom_tested			= frame_current	;
-#ifdef DEBUG
-	Device.Statistic->RenderCALC_HOM.End	();
-#endif
 
 	return result;
 }
@@ -48,6 +48,7 @@ public:
 	}
 
 	BOOL					visible		(vis_data&	vis);
+	BOOL					visible		(vis_data&	vis, CRandom& rnd);		// thread-safe as long as 'vis' and 'rnd' are owned by caller
 	BOOL					visible		(Fbox3&		B);
 	BOOL					visible		(sPoly&		P);
 	BOOL					visible		(Fbox2&		B, float depth);	// viewport-space (0..1)
@@ -300,7 +300,7 @@ _DDS:
 	{
 		// Load and get header
 		D3DXIMAGE_INFO			IMG;
-		S						= FS.r_open	(fn);
+		S						= Device.Resources->_OpenTexture	(fn);
 #ifdef DEBUG
 		Msg						("* Loaded: %s[%d]b",fn,S->length());
 #endif // DEBUG
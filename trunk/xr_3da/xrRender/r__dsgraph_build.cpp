@@ -8,6 +8,7 @@
 #include "flod.h"
 #include "particlegroup.h"
 #include "FTreeVisual.h"
+#include "r__radix_sort.h"
 
 using	namespace R_dsgraph;
 
@@ -31,6 +32,19 @@ ICF	float	CalcSSA				(float& distSQ, Fvector& C, float R)
 	distSQ	= Device.vCameraPosition.distance_to_sqr(C)+EPS;
 	return	R/distSQ;
 }
+// screen-space size of the textures of the pass in the main view, for the streaming
+ICF	void	TextureUsage		(SPass& pass, u32 phase, float R, float distSQ)
+{
+	if (!psTextureStreamBudget || CRender::PHASE_NORMAL!=phase)	return;
+	STextureList*	T	= pass.T._get();
+	if (0==T)			return;
+	float	size		= R/_sqrt(distSQ);
+	for (u32 it=0; it<T->size(); it++)
+	{
+		CTexture*	t	= (*T)[it].second._get();
+		if (t)			t->stream_usage	(size,Device.dwFrame);
+	}
+}
 
 void R_dsgraph_structure::r_dsgraph_insert_dynamic	(IRender_Visual *pVisual, Fvector& Center)
 {
@@ -67,6 +81,10 @@ void R_dsgraph_structure::r_dsgraph_insert_dynamic	(IRender_Visual *pVisual, Fve
 	if (0==sh)								return;
 	if (!pmask[sh->flags.iPriority/2])		return;
 
+	// Software skinned meshes are skinned together before the graph is rendered
+	if (MT_SKELETON_GEOMDEF_PM==pVisual->Type || MT_SKELETON_GEOMDEF_ST==pVisual->Type)
+		skinBatch.add		(dynamic_cast<CSkeletonX*>(pVisual));
+
 	// Create common node
 	// NOTE: Invisible elements exist only in R1
 	_MatrixItem		item	= {SSA,RI.val_pObject,pVisual,*RI.val_pTransform};
@@ -134,8 +152,28 @@ void R_dsgraph_structure::r_dsgraph_insert_dynamic	(IRender_Visual *pVisual, Fve
 	}
 #endif
 
+#if RENDER==R_R2
+	if (val_recorder)			{
+		Fbox3		temp		;
+		Fmatrix&	xf			= *RI.val_pTransform;
+		temp.xform	(pVisual->vis.box,xf);
+		val_recorder->push_back	(temp);
+	}
+#endif
+
 	// the most common node
 	SPass&						pass	= *sh->passes.front	();
+	TextureUsage				(pass,phase,pVisual->vis.sphere.R,distSQ);
+	if (ps_r__flags.test(RFLAG_DSGRAPH_QUEUE))	{
+		_RenderQueue&			Q		= mapQueue			[sh->flags.iPriority/2];
+		_QueueMatrix			qitem;
+		if (Q.resolve(pass,SSA,qitem.sid))	{
+			(_MatrixItem&)qitem	= item;
+			qitem.pass			= &pass;
+			Q.matrix.push_back	(qitem);
+			return;
+		}
+	}
 	mapMatrix_T&				map		= mapMatrix			[sh->flags.iPriority/2];
 #ifdef USE_RESOURCE_DEBUGGER
 	mapMatrixVS::TNode*			Nvs		= map.insert		(pass.vs);
@@ -157,15 +195,6 @@ void R_dsgraph_structure::r_dsgraph_insert_dynamic	(IRender_Visual *pVisual, Fve
 	if (SSA>Nps->val.ssa)		{ Nps->val.ssa = SSA;
 	if (SSA>Nvs->val.ssa)		{ Nvs->val.ssa = SSA;
 	} } } } }
-
-#if RENDER==R_R2
-	if (val_recorder)			{
-		Fbox3		temp		;
-		Fmatrix&	xf			= *RI.val_pTransform;
-		temp.xform	(pVisual->vis.box,xf);
-		val_recorder->push_back	(temp);
-	}
-#endif
 }
 
 void R_dsgraph_structure::r_dsgraph_insert_static	(IRender_Visual *pVisual)
@@ -241,7 +270,26 @@ void R_dsgraph_structure::r_dsgraph_insert_static	(IRender_Visual *pVisual)
 	if	(val_feedback && counter_S==val_feedback_breakp)	val_feedback->rfeedback_static(pVisual);
 
 	counter_S					++;
+
+#if RENDER==R_R2
+	if (val_recorder)			{
+		val_recorder->push_back	(pVisual->vis.box	);
+	}
+#endif
+
 	SPass&						pass	= *sh->passes.front	();
+	TextureUsage				(pass,phase,pVisual->vis.sphere.R,distSQ);
+	if (ps_r__flags.test(RFLAG_DSGRAPH_QUEUE))	{
+		_RenderQueue&			Q		= mapQueue			[sh->flags.iPriority/2];
+		_QueueNormal			qitem;
+		if (Q.resolve(pass,SSA,qitem.sid))	{
+			qitem.ssa			= SSA;
+			qitem.pVisual		= pVisual;
+			qitem.pass			= &pass;
+			Q.normal.push_back	(qitem);
+			return;
+		}
+	}
 	mapNormal_T&				map		= mapNormal			[sh->flags.iPriority/2];
 #ifdef USE_RESOURCE_DEBUGGER
 	mapNormalVS::TNode*			Nvs		= map.insert		(pass.vs);
@@ -264,12 +312,6 @@ void R_dsgraph_structure::r_dsgraph_insert_static	(IRender_Visual *pVisual)
 	if (SSA>Nps->val.ssa)		{ Nps->val.ssa = SSA;
 	if (SSA>Nvs->val.ssa)		{ Nvs->val.ssa = SSA;
 	} } } } }
-
-#if RENDER==R_R2
-	if (val_recorder)			{
-		val_recorder->push_back	(pVisual->vis.box	);
-	}
-#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -612,3 +654,261 @@ void CRender::add_Static(IRender_Visual *pVisual, u32 planes)
 		break;
 	}
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel static traversal: sector roots are split into sub-trees (tasks) between worker        ////
+// threads, every worker collects visible visuals into its own bucket, buckets are merged in      ////
+// traversal order and replayed into scene graph on the calling thread (scene graph and           ////
+// render_alloc are single-threaded)                                                              ////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+IC	void	collect_push		(_StaticBucket& B, IRender_Visual* pVisual, u32 type, u32 planes, float ssa=0, float distSQ=0)
+{
+	_StaticItem		item	= {B.key++,pVisual,B.view,ssa,distSQ,planes,type};
+	B.items.push_back		(item);
+}
+
+void R_dsgraph_structure::r_dsgraph_collect_leafs_static	(IRender_Visual *pVisual, _StaticBucket& B)
+{
+	if (!RImplementation.HOM.visible(pVisual->vis,B.rnd))		return;
+
+	xr_vector<IRender_Visual*>::iterator I,E;
+
+	switch (pVisual->Type) {
+	case MT_PARTICLE_GROUP:
+	case MT_SKELETON_ANIM:
+	case MT_SKELETON_RIGID:
+		// touches object state (particles, bones) - leave it to serial path
+		collect_push				(B,pVisual,SI_FULL,0);
+		return;
+	case MT_HIERRARHY:
+		{
+			FHierrarhyVisual* pV	= (FHierrarhyVisual*)pVisual;
+			I = pV->children.begin	();
+			E = pV->children.end	();
+			for (; I!=E; I++)		r_dsgraph_collect_leafs_static	(*I,B);
+		}
+		return;
+	case MT_LOD:
+		{
+			FLOD		* pV	=		(FLOD*) pVisual;
+			float		D;
+			float		ssa		=		CalcSSA(D,pV->vis.sphere.P,pV);
+			ssa					*=		pV->lod_factor;
+			if (ssa<r_ssaLOD_A)
+			{
+				if (ssa<r_ssaDISCARD)	return;
+				collect_push		(B,pVisual,SI_LOD,0,ssa,D);
+			}
+			if (ssa>r_ssaLOD_B)
+			{
+				I = pV->children.begin	();
+				E = pV->children.end	();
+				for (; I!=E; I++)	r_dsgraph_collect_leafs_static	(*I,B);
+			}
+		}
+		return;
+	default:
+		collect_push				(B,pVisual,SI_STATIC,0);
+		return;
+	}
+}
+
+void R_dsgraph_structure::r_dsgraph_collect_static	(IRender_Visual *pVisual, u32 planes, _StaticBucket& B)
+{
+	u32			planes_in	= planes;
+	vis_data&	vis			= pVisual->vis;
+	EFC_Visible	VIS			= B.view->testSAABB	(vis.sphere.P,vis.sphere.R,vis.box.data(),planes);
+	if (fcvNone==VIS)		return;
+	if (!RImplementation.HOM.visible(vis,B.rnd))	return;
+
+	xr_vector<IRender_Visual*>::iterator I,E;
+
+	switch (pVisual->Type) {
+	case MT_PARTICLE_GROUP:
+	case MT_SKELETON_ANIM:
+	case MT_SKELETON_RIGID:
+		// touches object state (particles, bones) - leave it to serial path
+		collect_push				(B,pVisual,(fcvPartial==VIS)?SI_PARTIAL:SI_FULL,planes_in);
+		return;
+	case MT_HIERRARHY:
+		{
+			FHierrarhyVisual* pV	= (FHierrarhyVisual*)pVisual;
+			I = pV->children.begin	();
+			E = pV->children.end	();
+			if (fcvPartial==VIS) {
+				for (; I!=E; I++)	r_dsgraph_collect_static		(*I,planes,B);
+			} else {
+				for (; I!=E; I++)	r_dsgraph_collect_leafs_static	(*I,B);
+			}
+		}
+		return;
+	case MT_LOD:
+		{
+			FLOD		* pV	= (FLOD*) pVisual;
+			float		D;
+			float		ssa		= CalcSSA	(D,pV->vis.sphere.P,pV);
+			ssa					*= pV->lod_factor;
+			if (ssa<r_ssaLOD_A)	
+			{
+				if (ssa<r_ssaDISCARD)	return;
+				collect_push		(B,pVisual,SI_LOD,0,ssa,D);
+			}
+			if (ssa>r_ssaLOD_B)
+			{
+				I = pV->children.begin	();
+				E = pV->children.end	();
+				for (; I!=E; I++)	r_dsgraph_collect_leafs_static	(*I,B);
+			}
+		}
+		return;
+	default:
+		collect_push				(B,pVisual,SI_STATIC,0);
+		return;
+	}
+}
+
+void R_dsgraph_structure::r_dsgraph_collect_static_MT	(u32 begin, u32 end, u32 worker_id)
+{
+	_StaticBucket&		B		= mtBuckets[worker_id];
+	for (u32 t_it=begin; t_it<end; t_it++)
+	{
+		_StaticTask&	T		= mtTasks[t_it];
+		B.key					= u64(t_it)<<32;
+		B.view					= T.view;
+		if (T.full)				r_dsgraph_collect_leafs_static	(T.pVisual,B);
+		else					r_dsgraph_collect_static		(T.pVisual,T.planes,B);
+	}
+}
+
+// Outdoor levels have a single sector, so the work is split below it: the root hierarchy is
+// tested here once (as add_Static would do) and every child becomes a task with the planes left
+void R_dsgraph_structure::r_dsgraph_build_static_tasks	(xr_vector<IRender_Sector*>& _sectors)
+{
+	mtTasks.clear_not_free		();
+	for (u32 s_it=0; s_it<_sectors.size(); s_it++)
+	{
+		CSector*		sector	= (CSector*)_sectors[s_it];
+		IRender_Visual*	root	= sector->root();
+		for (u32 v_it=0; v_it<sector->r_frustums.size(); v_it++)
+		{
+			CFrustum*	view	= &(sector->r_frustums[v_it]);
+			u32			planes	= view->getMask();
+			if (MT_HIERRARHY!=root->Type)	{
+				_StaticTask	T	= {root,view,planes,FALSE};
+				mtTasks.push_back	(T);
+				continue;
+			}
+			vis_data&	vis		= root->vis;
+			EFC_Visible	VIS		= view->testSAABB	(vis.sphere.P,vis.sphere.R,vis.box.data(),planes);
+			if (fcvNone==VIS)						continue;
+			if (!RImplementation.HOM.visible(vis))	continue;
+
+			FHierrarhyVisual*	pV	= (FHierrarhyVisual*)root;
+			for (u32 c_it=0; c_it<pV->children.size(); c_it++)	{
+				_StaticTask	T	= {pV->children[c_it],view,planes,(fcvPartial==VIS)?FALSE:TRUE};
+				mtTasks.push_back	(T);
+			}
+		}
+	}
+}
+
+void R_dsgraph_structure::r_dsgraph_build_static	(xr_vector<IRender_Sector*>& _sectors)
+{
+	Device.Statistic->RenderCALC_Static.Begin	();
+	if (!ps_r__flags.test(RFLAG_DSGRAPH_MT))
+	{
+		for (u32 s_it=0; s_it<_sectors.size(); s_it++)
+		{
+			CSector*	sector		= (CSector*)_sectors[s_it];
+			IRender_Visual*	root	= sector->root();
+			for (u32 v_it=0; v_it<sector->r_frustums.size(); v_it++)	{
+				set_Frustum			(&(sector->r_frustums[v_it]));
+				add_Geometry		(root);
+			}
+		}
+		Device.Statistic->RenderCALC_Static.End	();
+		return;
+	}
+
+	// Collect
+	u32		workers				= WorkerPool.workers();
+	if (mtBuckets.size()<workers)	mtBuckets.resize	(workers);
+	for (u32 w=0; w<mtBuckets.size(); w++)	{
+		mtBuckets[w].items.clear_not_free	();
+		mtBuckets[w].rnd.seed				(Device.dwFrame*(w+1));
+	}
+	r_dsgraph_build_static_tasks(_sectors);
+	WorkerPool.parallel_for		(mtTasks.size(),1,CWorkerPool::range_callback(this,&R_dsgraph_structure::r_dsgraph_collect_static_MT));
+
+	// Merge: radix sort on (task,sequence) gives exactly the serial insertion order
+	mtMerged.clear_not_free		();
+	for (u32 w=0; w<mtBuckets.size(); w++)
+		mtMerged.insert			(mtMerged.end(),mtBuckets[w].items.begin(),mtBuckets[w].items.end());
+	if (mtMerged.empty())		{ Device.Statistic->RenderCALC_Static.End(); return; }
+	mtTemp.resize				(mtMerged.size());
+	_StaticItem*	it			= r_radix_sort	(&*mtMerged.begin(),&*mtTemp.begin(),mtMerged.size());
+	_StaticItem*	end			= it + mtMerged.size();
+
+	// Replay
+	for (; it!=end; it++)
+	{
+		switch (it->type)	{
+		case SI_STATIC:
+			r_dsgraph_insert_static		(it->pVisual);
+			break;
+		case SI_LOD:
+			{
+				mapLOD_Node*	N	=	mapLOD.insertInAnyWay(it->distSQ);
+				N->val.ssa			=	it->ssa;
+				N->val.pVisual		=	it->pVisual;
+			}
+			break;
+		case SI_PARTIAL:
+			set_Frustum					(it->pFrustum);
+			RImplementation.add_Static	(it->pVisual,it->planes);
+			break;
+		case SI_FULL:
+			set_Frustum					(it->pFrustum);
+			RImplementation.add_leafs_Static(it->pVisual);
+			break;
+		}
+	}
+	Device.Statistic->RenderCALC_Static.End	();
+}
+
+// Bones of all kinematics which may get rendered by the traversal of lstRenderables are calculated
+// in one go (hierarchies on worker threads), so the traversal finds them already up to date.
+// With _hom the objects hidden by HOM are skipped. The test is the one of the traversal: a visible
+// result is stored and delays the next test, so the traversal takes it as is; a hidden one is not
+// stored, the traversal repeats it and gets the same answer.
+void R_dsgraph_structure::r_dsgraph_calculate_bones	(u32 _sector_marker, BOOL _hom)
+{
+	for (u32 o_it=0; o_it<lstRenderables.size(); o_it++)
+	{
+		ISpatial*	spatial		= lstRenderables[o_it];
+		if	(0==(spatial->spatial.type & STYPE_RENDERABLE))	continue;
+		spatial->spatial_updatesector	();
+		CSector*	sector		= (CSector*)spatial->spatial.sector;
+		if	(0==sector)										continue;	// disassociated from S/P structure
+		if	(_sector_marker != sector->r_marker)			continue;	// inactive (untouched) sector
+		for (u32 v_it=0; v_it<sector->r_frustums.size(); v_it++)
+		{
+			if (!sector->r_frustums[v_it].testSphere_dirty(spatial->spatial.sphere.P,spatial->spatial.sphere.R))	continue;
+			IRenderable*	renderable	= spatial->dcast_Renderable	();
+			if (0==renderable)								break;
+			if (_hom)	{
+				vis_data&		v_orig	= renderable->renderable.visual->vis;
+				vis_data		v_copy	= v_orig;
+				v_copy.box.xform		(renderable->renderable.xform);
+				if (!RImplementation.HOM.visible(v_copy))	break;
+				v_orig.marker			= v_copy.marker;
+				v_orig.accept_frame		= v_copy.accept_frame;
+				v_orig.hom_frame		= v_copy.hom_frame;
+				v_orig.hom_tested		= v_copy.hom_tested;
+			}
+			bonesBatch.add				(PKinematics(renderable->renderable.visual));
+			break;
+		}
+	}
+	bonesBatch.calculate		();
+}
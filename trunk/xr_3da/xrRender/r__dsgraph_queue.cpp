@@ -0,0 +1,234 @@
+#include "stdafx.h"
+
+#include "r__dsgraph_queue.h"
+
+using	namespace R_dsgraph;
+
+BOOL	_RenderQueue::resolve		(void* _vs, void* _ps, void* _cs, void* _state, void* _tex, float SSA, u16* sid)
+{
+	u32	id		[QS_COUNT]	=
+	{
+		vs.get			(_vs,SSA),
+		ps.get			(_ps,SSA),
+		cs.get			(_cs,SSA),
+		states.get		(_state,SSA),
+		textures.get	(_tex,SSA)
+	};
+	for (u32 it=0; it<QS_COUNT; it++)	{
+		if (0xffff==id[it])	return	FALSE;
+		sid[it]			= u16(id[it]);
+	}
+	return	TRUE;
+}
+
+void	_RenderQueue::ranking		()
+{
+	vs.ranking			(keys,temp);
+	ps.ranking			(keys,temp);
+	cs.ranking			(keys,temp);
+	states.ranking		(keys,temp);
+	textures.ranking	(keys,temp);
+}
+
+// SSA quantized to 14 bits, larger first; everything above 2.0 shares the top bucket
+IC	u64		ssa_bits	(float ssa)
+{
+	u32	bits			= *(u32*)&ssa;
+	u32	q				= (bits>=0x40000000) ? 0x3fff : ((bits>>16)&0x3fff);
+	return	u64(0x3fff - q);
+}
+
+template <class T>
+IC	_QueueKey*	build_keys	(_RenderQueue& Q, T& items)
+{
+	u32	count			= items.size();
+	if (0==count)		return	0;
+	Q.keys.resize		(count);
+	Q.temp.resize		(count);
+	for (u32 it=0; it<count; it++)
+	{
+		const u16*	sid		= items[it].sid;
+		_QueueKey&	K		= Q.keys[it];
+		K.key				=	(u64(Q.vs.rank		[sid[QS_VS]])		<<56)	|
+								(u64(Q.ps.rank		[sid[QS_PS]])		<<46)	|
+								(u64(Q.cs.rank		[sid[QS_CS]])		<<36)	|
+								(u64(Q.states.rank	[sid[QS_STATE]])	<<26)	|
+								(u64(Q.textures.rank[sid[QS_TEX]])		<<14)	|
+								ssa_bits	(items[it].ssa);
+		K.id				= it;
+	}
+	return	r_radix_sort	(&*Q.keys.begin(),&*Q.temp.begin(),count);
+}
+
+_QueueKey*	_RenderQueue::sort_normal	()	{ return build_keys(*this,normal);	}
+_QueueKey*	_RenderQueue::sort_matrix	()	{ return build_keys(*this,matrix);	}
+
+void	_RenderQueue::clear			(bool _normal)
+{
+	matrix.clear		();
+	if (!_normal)		return;
+	normal.clear		();
+	vs.clear			();
+	ps.clear			();
+	cs.clear			();
+	states.clear		();
+	textures.clear		();
+}
+
+void	_RenderQueue::destroy		()
+{
+	clear				(true);
+	keys.clear			();
+	temp.clear			();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark: the same synthetic frame goes through both structures, only
+// pointer keys are used so nothing is dereferenced or rendered
+#ifndef USE_RESOURCE_DEBUGGER
+template <class N>
+IC	bool	cmp_bench_ssa		(N* N1, N* N2)		{	return (N1->val.ssa > N2->val.ssa);		}
+IC	bool	cmp_bench_items		(const _NormalItem& N1, const _NormalItem& N2)	{	return (N1.ssa > N2.ssa);		}
+
+struct	bench_item
+{
+	void*				obj		[QS_COUNT];
+	float				ssa;
+};
+
+static	u32		bench_maps		(xr_vector<bench_item>& src, mapNormal_T& map, float& t_insert, float& t_render)
+{
+	CTimer				T;
+	T.Start				();
+	for (u32 it=0; it<src.size(); it++)
+	{
+		bench_item&					I		= src[it];
+		float						SSA		= I.ssa;
+		mapNormalVS::TNode*			Nvs		= map.insert		((vs_type)I.obj[QS_VS]);
+		mapNormalPS::TNode*			Nps		= Nvs->val.insert	((ps_type)I.obj[QS_PS]);
+		mapNormalCS::TNode*			Ncs		= Nps->val.insert	((R_constant_table*)I.obj[QS_CS]);
+		mapNormalStates::TNode*		Nstate	= Ncs->val.insert	((IDirect3DStateBlock9*)I.obj[QS_STATE]);
+		mapNormalTextures::TNode*	Ntex	= Nstate->val.insert((STextureList*)I.obj[QS_TEX]);
+		_NormalItem					item	= {SSA,0};
+		Ntex->val.push_back					(item);
+		if (SSA>Ntex->val.ssa)		{ Ntex->val.ssa = SSA;
+		if (SSA>Nstate->val.ssa)	{ Nstate->val.ssa = SSA;
+		if (SSA>Ncs->val.ssa)		{ Ncs->val.ssa = SSA;
+		if (SSA>Nps->val.ssa)		{ Nps->val.ssa = SSA;
+		if (SSA>Nvs->val.ssa)		{ Nvs->val.ssa = SSA;
+		} } } } }
+	}
+	t_insert			+= T.GetElapsed_sec();
+
+	// walk exactly as r_dsgraph_render_graph does, one 'change' per visited node
+	T.Start				();
+	u32		changes		= 0;
+	xr_vector<mapNormalVS::TNode*,render_alloc<mapNormalVS::TNode*> >				lVS;
+	xr_vector<mapNormalPS::TNode*,render_alloc<mapNormalPS::TNode*> >				lPS;
+	xr_vector<mapNormalCS::TNode*,render_alloc<mapNormalCS::TNode*> >				lCS;
+	xr_vector<mapNormalStates::TNode*,render_alloc<mapNormalStates::TNode*> >		lStates;
+	xr_vector<mapNormalTextures::TNode*,render_alloc<mapNormalTextures::TNode*> >	lTex;
+	map.getANY_P		(lVS);		std::sort(lVS.begin(),lVS.end(),cmp_bench_ssa<mapNormalVS::TNode>);
+	for (u32 vs_id=0; vs_id<lVS.size(); vs_id++)	{
+		mapNormalPS&	ps		= lVS[vs_id]->val;	ps.ssa = 0;	changes++;
+		ps.getANY_P		(lPS);		std::sort(lPS.begin(),lPS.end(),cmp_bench_ssa<mapNormalPS::TNode>);
+		for (u32 ps_id=0; ps_id<lPS.size(); ps_id++)	{
+			mapNormalCS&	cs		= lPS[ps_id]->val;	cs.ssa = 0;	changes++;
+			cs.getANY_P		(lCS);		std::sort(lCS.begin(),lCS.end(),cmp_bench_ssa<mapNormalCS::TNode>);
+			for (u32 cs_id=0; cs_id<lCS.size(); cs_id++)	{
+				mapNormalStates&	states	= lCS[cs_id]->val;	states.ssa = 0;	changes++;
+				states.getANY_P		(lStates);	std::sort(lStates.begin(),lStates.end(),cmp_bench_ssa<mapNormalStates::TNode>);
+				for (u32 state_id=0; state_id<lStates.size(); state_id++)	{
+					mapNormalTextures&	tex		= lStates[state_id]->val;	tex.ssa = 0;	changes++;
+					tex.getANY_P		(lTex);		std::sort(lTex.begin(),lTex.end(),cmp_bench_ssa<mapNormalTextures::TNode>);
+					for (u32 tex_id=0; tex_id<lTex.size(); tex_id++)	{
+						mapNormalItems&		items	= lTex[tex_id]->val;	items.ssa = 0;	changes++;
+						std::sort			(items.begin(),items.end(),cmp_bench_items);
+						items.clear			();
+					}
+					lTex.clear		();
+					tex.clear		();
+				}
+				lStates.clear	();
+				states.clear	();
+			}
+			lCS.clear		();
+			cs.clear		();
+		}
+		lPS.clear		();
+		ps.clear		();
+	}
+	map.clear			();
+	t_render			+= T.GetElapsed_sec();
+	return	changes;
+}
+
+static	u32		bench_queue		(xr_vector<bench_item>& src, _RenderQueue& Q, float& t_insert, float& t_render)
+{
+	CTimer				T;
+	T.Start				();
+	for (u32 it=0; it<src.size(); it++)
+	{
+		bench_item&		I		= src[it];
+		_QueueNormal	item;
+		if (!Q.resolve(I.obj[QS_VS],I.obj[QS_PS],I.obj[QS_CS],I.obj[QS_STATE],I.obj[QS_TEX],I.ssa,item.sid))	continue;
+		item.ssa				= I.ssa;
+		item.pVisual			= 0;
+		item.pass				= 0;
+		Q.normal.push_back		(item);
+	}
+	t_insert			+= T.GetElapsed_sec();
+
+	T.Start				();
+	u32		changes		= 0;
+	Q.ranking			();
+	_QueueKey*	K		= Q.sort_normal();
+	u16			cur		[QS_COUNT];
+	for (u32 it=0; it<Q.normal.size(); it++)
+	{
+		const u16*	sid		= Q.normal[K[it].id].sid;
+		bool		dirty	= (0==it);
+		for (u32 l=0; l<QS_COUNT; l++)	{
+			if (dirty || (cur[l]!=sid[l]))	{ cur[l] = sid[l]; dirty = true; changes++; }
+		}
+	}
+	Q.clear				(true);
+	t_render			+= T.GetElapsed_sec();
+	return	changes;
+}
+#endif // USE_RESOURCE_DEBUGGER
+
+void		r_dsgraph_queue_benchmark	(u32 count)
+{
+#ifndef USE_RESOURCE_DEBUGGER
+	// distinct objects per level, roughly a mid-sized outdoor frame
+	static const u32	distinct	[QS_COUNT]	= { 40, 120, 160, 200, 900 };
+	const u32			frames		= 16;
+
+	CRandom				rnd			(0x2a);
+	xr_vector<bench_item>	src		(count);
+	for (u32 it=0; it<count; it++)	{
+		for (u32 l=0; l<QS_COUNT; l++)
+			src[it].obj[l]	= (void*)size_t((rnd.randI(distinct[l])+1)*64 + (l<<20));
+		src[it].ssa			= rnd.randF(0.0001f,0.5f);
+	}
+
+	mapNormal_T*		map			= xr_new<mapNormal_T>	();
+	_RenderQueue*		Q			= xr_new<_RenderQueue>	();
+	float				m_insert=0, m_render=0, q_insert=0, q_render=0;
+	u32					m_changes=0, q_changes=0;
+	for (u32 f=0; f<frames; f++)	{
+		m_changes		= bench_maps	(src,*map,m_insert,m_render);
+		q_changes		= bench_queue	(src,*Q,q_insert,q_render);
+	}
+	xr_delete			(Q);
+	xr_delete			(map);
+
+	float				scale		= 1000.f/float(frames);
+	Msg		("* dsgraph benchmark: %d items, %d frames",count,frames);
+	Msg		("- maps  : insert %2.3fms, sort+walk %2.3fms, state changes %d",m_insert*scale,m_render*scale,m_changes);
+	Msg		("- queue : insert %2.3fms, sort+walk %2.3fms, state changes %d",q_insert*scale,q_render*scale,q_changes);
+#else
+	Msg		("! dsgraph benchmark is not available with USE_RESOURCE_DEBUGGER");
+#endif
+}
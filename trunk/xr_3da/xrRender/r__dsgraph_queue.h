@@ -0,0 +1,133 @@
+#pragma once
+
+#include "r__radix_sort.h"
+
+namespace	R_dsgraph
+{
+	// Flat render queue: items are stored unsorted with dense per-frame ids of their
+	// shader objects and are sorted once, with a single radix pass over packed 64-bit keys.
+	// Key layout (msb->lsb): vs(8) | ps(10) | constants(10) | state(10) | textures(12) | ssa(14)
+	// Ids are ranked by the max SSA of their items, the same order the nested maps produce per level.
+	enum	{
+		QS_VS				= 0,
+		QS_PS,
+		QS_CS,
+		QS_STATE,
+		QS_TEX,
+		QS_COUNT
+	};
+
+	struct _QueueKey	{
+		u64					key;
+		u32					id;					// payload index
+	};
+	typedef xr_vector<_QueueKey,render_allocator::helper<_QueueKey>::result>	_QueueKeys;
+
+	struct _QueueNormal	: public _NormalItem
+	{
+		SPass*				pass;
+		u16					sid		[QS_COUNT];
+	};
+	struct _QueueMatrix	: public _MatrixItem
+	{
+		SPass*				pass;
+		u16					sid		[QS_COUNT];
+	};
+
+	// Pointer -> dense id, open addressing, reset per frame by walking the used slots only
+	template <u32 bits>
+	class	_QueueIDs
+	{
+	public:
+		enum	{
+			limit			= (1<<bits),
+			slots			= (2<<bits),
+			invalid			= 0xffff
+		};
+	private:
+		void*				table_key	[slots];
+		u16					table_id	[slots];
+		xr_vector<u32,render_allocator::helper<u32>::result>		used;
+	public:
+		xr_vector<float,render_allocator::helper<float>::result>	ssa;
+		xr_vector<u16,render_allocator::helper<u16>::result>		rank;
+	public:
+		_QueueIDs		()					{ FillMemory(table_id,sizeof(table_id),0xff);	}
+
+		IC u32			size			()	{ return ssa.size();	}
+		IC u32			get				(void* P, float SSA)
+		{
+			u32	h			= (u32(size_t(P)>>4)*2654435761u) >> (31-bits);
+			for (;;)	{
+				u32	id		= table_id[h];
+				if (invalid==id)		break;
+				if (table_key[h]==P)	{ if (SSA>ssa[id]) ssa[id]=SSA; return id; }
+				h			= (h+1)&(slots-1);
+			}
+			u32	id			= ssa.size();
+			if (id>=limit)	return invalid;
+			table_key[h]	= P;
+			table_id[h]		= u16(id);
+			used.push_back	(h);
+			ssa.push_back	(SSA);
+			return			id;
+		}
+		void			ranking			(_QueueKeys& keys, _QueueKeys& temp)
+		{
+			// descending SSA, positive floats compare as integers
+			u32	count		= ssa.size();
+			rank.resize		(count);
+			if (0==count)	return;
+			keys.resize		(count);
+			temp.resize		(count);
+			for (u32 id=0; id<count; id++)	{
+				keys[id].key	= (u64(~*(u32*)&ssa[id])<<16) | id;
+				keys[id].id		= id;
+			}
+			_QueueKey*	S	= r_radix_sort(&*keys.begin(),&*temp.begin(),count);
+			for (u32 r=0; r<count; r++)		rank[S[r].id]	= u16(r);
+		}
+		void			clear			()
+		{
+			for (u32 it=0; it<used.size(); it++)	table_id[used[it]]	= invalid;
+			used.clear		();
+			ssa.clear		();
+			rank.clear		();
+		}
+	};
+
+	class	_RenderQueue
+	{
+	public:
+		_QueueIDs<8>		vs;
+		_QueueIDs<10>		ps;
+		_QueueIDs<10>		cs;
+		_QueueIDs<10>		states;
+		_QueueIDs<12>		textures;
+
+		xr_vector<_QueueNormal,render_allocator::helper<_QueueNormal>::result>	normal;
+		xr_vector<_QueueMatrix,render_allocator::helper<_QueueMatrix>::result>	matrix;
+		_QueueKeys			keys;
+		_QueueKeys			temp;
+	public:
+		// FALSE if some id space is exhausted this frame - caller should use the maps then
+		BOOL				resolve			(void* _vs, void* _ps, void* _cs, void* _state, void* _tex, float SSA, u16* sid);
+		BOOL				resolve			(SPass& pass, float SSA, u16* sid)
+		{
+			return			resolve			(pass.vs._get(),pass.ps._get(),pass.constants._get(),pass.state._get(),pass.T._get(),SSA,sid);
+		}
+
+		// ranks ids by SSA, must precede sorting
+		void				ranking			();
+		// returns payload indices in render order (valid until next call)
+		_QueueKey*			sort_normal		();
+		_QueueKey*			sort_matrix		();
+
+		BOOL				empty			()	{ return normal.empty() && matrix.empty();	}
+		void				clear			(bool _normal);
+		void				destroy			();
+	};
+};
+
+// Synthetic CPU comparison of nested maps vs. flat queue (insertion + ordering)
+void		r_dsgraph_queue_benchmark	(u32 count);
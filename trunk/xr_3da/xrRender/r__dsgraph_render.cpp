@@ -221,10 +221,85 @@ void		sort_tlist_mat
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Flat queue: items come pre-sorted by packed state ids, so state is set only where an id changes.
+// A change at some level re-issues all levels below it, the same calls the nested walk makes.
+void R_dsgraph_structure::r_dsgraph_render_queue	(u32	_priority, bool _clear)
+{
+	_RenderQueue&	Q					= mapQueue	[_priority];
+	if (Q.empty())						return;
+	Q.ranking							();
+
+	// **************************************************** NORMAL
+	if (!Q.normal.empty())
+	{
+		RCache.set_xform_world			(Fidentity);
+		_QueueKey*		K				= Q.sort_normal	();
+		u16				cur				[QS_COUNT];
+		for (u32 it=0; it<Q.normal.size(); it++)
+		{
+			_QueueNormal&	Ni			= Q.normal	[K[it].id];
+			SPass&			pass		= *Ni.pass;
+			bool			dirty		= (0==it);
+#ifdef USE_RESOURCE_DEBUGGER
+			if (dirty || cur[QS_VS]!=Ni.sid[QS_VS])			{ dirty=true; cur[QS_VS]	= Ni.sid[QS_VS];	RCache.set_VS(pass.vs);		}
+			if (dirty || cur[QS_PS]!=Ni.sid[QS_PS])			{ dirty=true; cur[QS_PS]	= Ni.sid[QS_PS];	RCache.set_PS(pass.ps);		}
+#else
+			if (dirty || cur[QS_VS]!=Ni.sid[QS_VS])			{ dirty=true; cur[QS_VS]	= Ni.sid[QS_VS];	RCache.set_VS(pass.vs->vs);	}
+			if (dirty || cur[QS_PS]!=Ni.sid[QS_PS])			{ dirty=true; cur[QS_PS]	= Ni.sid[QS_PS];	RCache.set_PS(pass.ps->ps);	}
+#endif
+			if (dirty || cur[QS_CS]!=Ni.sid[QS_CS])			{ dirty=true; cur[QS_CS]	= Ni.sid[QS_CS];	RCache.set_Constants(pass.constants._get());	}
+			if (dirty || cur[QS_STATE]!=Ni.sid[QS_STATE])	{ dirty=true; cur[QS_STATE]	= Ni.sid[QS_STATE];	RCache.set_States(pass.state->state);	}
+			if (dirty || cur[QS_TEX]!=Ni.sid[QS_TEX])		{
+				cur[QS_TEX]						= Ni.sid[QS_TEX];
+				RCache.set_Textures				(pass.T._get());
+				RImplementation.apply_lmaterial	();
+			}
+			Ni.pVisual->Render					(calcLOD(Ni.ssa,Ni.pVisual->vis.sphere.R));
+		}
+	}
+
+	// **************************************************** MATRIX
+	if (!Q.matrix.empty())
+	{
+		_QueueKey*		K				= Q.sort_matrix	();
+		u16				cur				[QS_COUNT];
+		for (u32 it=0; it<Q.matrix.size(); it++)
+		{
+			_QueueMatrix&	Ni			= Q.matrix	[K[it].id];
+			SPass&			pass		= *Ni.pass;
+			bool			dirty		= (0==it);
+#ifdef USE_RESOURCE_DEBUGGER
+			if (dirty || cur[QS_VS]!=Ni.sid[QS_VS])			{ dirty=true; cur[QS_VS]	= Ni.sid[QS_VS];	RCache.set_VS(pass.vs);		}
+			if (dirty || cur[QS_PS]!=Ni.sid[QS_PS])			{ dirty=true; cur[QS_PS]	= Ni.sid[QS_PS];	RCache.set_PS(pass.ps);		}
+#else
+			if (dirty || cur[QS_VS]!=Ni.sid[QS_VS])			{ dirty=true; cur[QS_VS]	= Ni.sid[QS_VS];	RCache.set_VS(pass.vs->vs);	}
+			if (dirty || cur[QS_PS]!=Ni.sid[QS_PS])			{ dirty=true; cur[QS_PS]	= Ni.sid[QS_PS];	RCache.set_PS(pass.ps->ps);	}
+#endif
+			if (dirty || cur[QS_CS]!=Ni.sid[QS_CS])			{ dirty=true; cur[QS_CS]	= Ni.sid[QS_CS];	RCache.set_Constants(pass.constants._get());	}
+			if (dirty || cur[QS_STATE]!=Ni.sid[QS_STATE])	{ dirty=true; cur[QS_STATE]	= Ni.sid[QS_STATE];	RCache.set_States(pass.state->state);	}
+			if (dirty || cur[QS_TEX]!=Ni.sid[QS_TEX])		{ cur[QS_TEX]	= Ni.sid[QS_TEX];	RCache.set_Textures(pass.T._get());	}
+			RCache.set_xform_world				(Ni.Matrix);
+			RImplementation.apply_object		(Ni.pObject);
+			RImplementation.apply_lmaterial		();
+			Ni.pVisual->Render					(calcLOD(Ni.ssa,Ni.pVisual->vis.sphere.R));
+		}
+	}
+
+	// matrix items never survive the call, same as mapMatrix_Render
+	Q.clear								(_clear);
+}
+
 void R_dsgraph_structure::r_dsgraph_render_graph	(u32	_priority, bool _clear)
 {
 	Device.Statistic->RenderDUMP.Begin		();
 
+	// **************************************************** SKINNING
+	if (!skinBatch.empty())					skinBatch.flush	();
+
+	// **************************************************** QUEUE
+	r_dsgraph_render_queue					(_priority,_clear);
+
 	// **************************************************** NORMAL
 	// Perform sorting based on ScreenSpaceArea
 	// Sorting by SSA and changes minimizations
@@ -462,15 +537,7 @@ void	R_dsgraph_structure::r_dsgraph_render_subspace	(IRender_Sector* _sector, CF
 	PortalTraverser.traverse		( _sector, ViewBase, _cop, mCombined, 0 );
 
 	// Determine visibility for static geometry hierrarhy
-	for (u32 s_it=0; s_it<PortalTraverser.r_sectors.size(); s_it++)
-	{
-		CSector*	sector		= (CSector*)PortalTraverser.r_sectors[s_it];
-		IRender_Visual*	root	= sector->root();
-		for (u32 v_it=0; v_it<sector->r_frustums.size(); v_it++)	{
-			set_Frustum			(&(sector->r_frustums[v_it]));
-			add_Geometry		(root);
-		}
-	}
+	r_dsgraph_build_static		(PortalTraverser.r_sectors);
 
 	if (_dynamic)
 	{
@@ -484,6 +551,7 @@ void	R_dsgraph_structure::r_dsgraph_render_subspace	(IRender_Sector* _sector, CF
 			STYPE_RENDERABLE,
 			ViewBase
 			);
+		r_dsgraph_calculate_bones		(PortalTraverser.i_marker,FALSE);
 
 		// Determine visibility for dynamic part of scene
 		for (u32 o_it=0; o_it<lstRenderables.size(); o_it++)
@@ -3,6 +3,8 @@
 #include "..\render.h"
 #include "..\ispatial.h"
 #include "r__dsgraph_types.h"
+#include "r__dsgraph_queue.h"
+#include "..\SkeletonX.h"
 #include "r__sector.h"
 
 //////////////////////////////////////////////////////////////////////////
@@ -36,7 +38,10 @@ public:
 	// Dynamic scene graph
 	R_dsgraph::mapNormal_T										mapNormal	[2]		;	// 2==(priority/2)
 	R_dsgraph::mapMatrix_T										mapMatrix	[2]		;
+	R_dsgraph::_RenderQueue										mapQueue	[2]		;	// flat alternative to mapNormal/mapMatrix
 	R_dsgraph::mapSorted_T										mapSorted;
+	CSkeletonXBatch												skinBatch;			// soft-skinned visuals of the current phase
+	CKinematicsBatch											bonesBatch;			// kinematics of the current traversal
 	R_dsgraph::mapHUD_T											mapHUD;
 	R_dsgraph::mapLOD_T											mapLOD;
 	R_dsgraph::mapSorted_T										mapDistort;
@@ -69,6 +74,12 @@ public:
 
 	xr_vector<IRender_Visual*,render_alloc<IRender_Visual*> >			lstRecorded	;
 
+	// Parallel static traversal
+	xr_vector<R_dsgraph::_StaticTask>									mtTasks		;
+	xr_vector<R_dsgraph::_StaticBucket>									mtBuckets	;	// [worker_id]
+	xr_vector<R_dsgraph::_StaticItem>									mtMerged	;
+	xr_vector<R_dsgraph::_StaticItem>									mtTemp		;
+
 	u32															counter_S	;
 	u32															counter_D	;
 	BOOL														b_loaded	;
@@ -121,10 +132,19 @@ public:
 
 		lstRecorded.clear		();
 
+		mtTasks.clear			();
+		mtBuckets.clear			();
+		mtMerged.clear			();
+		mtTemp.clear			();
+
 		mapNormal[0].destroy	();
 		mapNormal[1].destroy	();
 		mapMatrix[0].destroy	();
 		mapMatrix[1].destroy	();
+		mapQueue[0].destroy		();
+		mapQueue[1].destroy		();
+		skinBatch.clear			();
+		bonesBatch.clear		();
 		mapSorted.destroy		();
 		mapHUD.destroy			();
 		mapLOD.destroy			();
@@ -142,6 +162,8 @@ public:
 	void		r_dsgraph_insert_static							(IRender_Visual	*pVisual);
 
 	void		r_dsgraph_render_graph							(u32	_priority,	bool _clear=true);
+	void		r_dsgraph_render_queue							(u32	_priority,	bool _clear);
+	BOOL		r_dsgraph_graph_empty							(u32	_priority)	{ return 0==mapNormal[_priority].size() && 0==mapMatrix[_priority].size() && mapQueue[_priority].empty(); }
 	void		r_dsgraph_render_hud							();
 	void		r_dsgraph_render_lods							(bool	_setup_zb,	bool _clear);
 	void		r_dsgraph_render_sorted							();
@@ -152,6 +174,13 @@ public:
 	void		r_dsgraph_render_subspace						(IRender_Sector* _sector, Fmatrix& mCombined, Fvector& _cop, BOOL _dynamic, BOOL _precise_portals=FALSE	);
 	void		r_dsgraph_render_R1_box							(IRender_Sector* _sector, Fbox& _bb, int _element);
 
+	void		r_dsgraph_build_static							(xr_vector<IRender_Sector*>& _sectors);
+	void		r_dsgraph_build_static_tasks					(xr_vector<IRender_Sector*>& _sectors);
+	void		r_dsgraph_calculate_bones						(u32 _sector_marker, BOOL _hom);
+	void		__stdcall	r_dsgraph_collect_static_MT			(u32 begin, u32 end, u32 worker_id);
+	void		r_dsgraph_collect_static						(IRender_Visual	*pVisual, u32 planes, R_dsgraph::_StaticBucket& B);
+	void		r_dsgraph_collect_leafs_static					(IRender_Visual	*pVisual, R_dsgraph::_StaticBucket& B);
+
 public:
 	virtual		u32						memory_usage			()
 	{
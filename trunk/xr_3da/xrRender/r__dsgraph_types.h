@@ -90,6 +90,35 @@ namespace	R_dsgraph
 		IRender_Visual*		pVisual;
 	};
 
+	// Static geometry visibility, collected per worker thread and replayed in traversal order
+	enum	{
+		SI_STATIC			= 0,				// leaf visual			-> r_dsgraph_insert_static
+		SI_LOD,									// lod node				-> mapLOD
+		SI_PARTIAL,								// needs serial path	-> add_Static
+		SI_FULL,								// needs serial path	-> add_leafs_Static
+	};
+	struct _StaticItem	{
+		u64					key;				// (task<<32) | sequence
+		IRender_Visual*		pVisual;
+		CFrustum*			pFrustum;
+		float				ssa;
+		float				distSQ;
+		u32					planes;
+		u32					type;
+	};
+	struct _StaticBucket	{
+		xr_vector<_StaticItem>	items;			// note: default allocator, render_alloc is not thread-safe
+		CRandom					rnd;
+		CFrustum*				view;
+		u64						key;
+	};
+	struct _StaticTask	{						// sub-tree of a sector root, seen through one frustum
+		IRender_Visual*			pVisual;
+		CFrustum*				view;
+		u32						planes;
+		BOOL					full;			// root was fully visible -> leafs path
+	};
+
 #ifdef USE_RESOURCE_DEBUGGER
 	typedef	ref_vs						vs_type;
 	typedef	ref_ps						ps_type;
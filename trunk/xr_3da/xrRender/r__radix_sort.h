@@ -0,0 +1,42 @@
+#pragma once
+
+// LSD radix sort on 64-bit keys, stable, 8 bits per pass
+// T must expose 'u64 key'. 'temp' must hold at least 'count' elements.
+// Passes where every element shares the same byte are skipped, so short keys cost only the bytes they use.
+// Returns pointer to the sorted sequence (either 'data' or 'temp')
+template <class T>
+T*	r_radix_sort	(T* data, T* temp, u32 count)
+{
+	if (count<2)		return data;
+
+	u32		histogram	[8][256];
+	ZeroMemory			(histogram,sizeof(histogram));
+
+	// Single pass over data builds all eight histograms
+	for (u32 it=0; it<count; it++)
+	{
+		u64	key				= data[it].key;
+		for (u32 b=0; b<8; b++)
+			histogram[b][u32(key>>(b*8))&0xff]	++;
+	}
+
+	T*		src			= data;
+	T*		dst			= temp;
+	for (u32 b=0; b<8; b++)
+	{
+		u32*	H			= histogram[b];
+
+		// All keys share this byte - nothing to do
+		if (H[u32(src[0].key>>(b*8))&0xff]==count)	continue;
+
+		u32		offset		= 0;
+		for (u32 v=0; v<256; v++)	{ u32 c = H[v]; H[v] = offset; offset += c; }
+		for (u32 it=0; it<count; it++)
+		{
+			u32	v			= u32(src[it].key>>(b*8))&0xff;
+			dst[H[v]++]		= src[it];
+		}
+		std::swap			(src,dst);
+	}
+	return	src;
+}
@@ -41,6 +41,7 @@ float		ps_r__ssaDONTSORT			=  32.f	;					//RO
 float		ps_r__ssaHZBvsTEX			=  96.f	;					//RO
 
 int			ps_r__tf_Anisotropic		= 4		;
+Flags32		ps_r__flags					= { RFLAG_DSGRAPH_MT };
 
 // R1
 float		ps_r1_ssaLOD_A				= 64.f	;
@@ -201,6 +202,26 @@ public:
 		RImplementation.Models->dump();
 	}
 };
+class CCC_DsgraphBench : public IConsole_Command
+{
+public:
+	CCC_DsgraphBench(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		int		count	= 0;
+		sscanf	(args,"%d",&count);
+		r_dsgraph_queue_benchmark	(count>0 ? u32(count) : 10000);
+	}
+};
+class CCC_SkinBench : public IConsole_Command
+{
+public:
+	CCC_SkinBench(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		int		count	= 0;
+		sscanf	(args,"%d",&count);
+		CSkeletonXBatch::benchmark	(count>0 ? u32(count) : 65536);
+	}
+};
 //-----------------------------------------------------------------------
 class	CCC_Preset		: public CCC_Token
 {
@@ -255,9 +276,13 @@ void		xrRender_initconsole	()
 	CMD4(CCC_Float,		"r__wallmark_shift_v",	&ps_r__WallmarkSHIFT_V,		0.0f,	1.f		);
 	CMD4(CCC_Float,		"r__wallmark_ttl",		&ps_r__WallmarkTTL,			1.0f,	5.f*60.f);
 	CMD1(CCC_ModelPoolStat,"stat_models"		);
+	CMD1(CCC_DsgraphBench,"r__dsgraph_bench"	);
+	CMD1(CCC_SkinBench,	"r__skin_bench"			);
 #endif // DEBUG
 
 //	CMD4(CCC_Integer,	"r__supersample",		&ps_r__Supersample,			1,		4		);
+	CMD3(CCC_Mask,		"r__dsgraph_mt",		&ps_r__flags,				RFLAG_DSGRAPH_MT);
+	CMD3(CCC_Mask,		"r__dsgraph_queue",		&ps_r__flags,				RFLAG_DSGRAPH_QUEUE);
 
 	Fvector	tw_min,tw_max;
 	
@@ -28,6 +28,12 @@ extern ECORE_API	float		ps_r__ssaDISCARD	;
 extern ECORE_API	float		ps_r__ssaDONTSORT	;
 extern ECORE_API	float		ps_r__ssaHZBvsTEX	;
 extern ECORE_API	int			ps_r__tf_Anisotropic;
+extern ECORE_API	Flags32		ps_r__flags;
+enum
+{
+	RFLAG_DSGRAPH_MT			= (1<<0),			// static geometry traversal on worker threads
+	RFLAG_DSGRAPH_QUEUE			= (1<<1),			// flat sort-key queue instead of nested state maps
+};
 
 // R1
 extern ECORE_API	float		ps_r1_ssaLOD_A;
@@ -86,6 +86,7 @@ private:
 	void								LoadSectors				(IReader *fs);
 	void								LoadSWIs				(CStreamReader	*fs);
 
+	friend class						R_dsgraph_structure;	// replays deferred static visuals
 	BOOL								add_Dynamic				(IRender_Visual	*pVisual, u32 planes);		// normal processing
 	void								add_Static				(IRender_Visual	*pVisual, u32 planes);
 	void								add_leafs_Dynamic		(IRender_Visual	*pVisual);					// if detected node's full visibility
@@ -26,6 +26,7 @@ void CRender::level_Load(IReader *fs)
 	{
 		chunk = fs->open_chunk		(fsL_SHADERS);
 		R_ASSERT2					(chunk,"Level doesn't builded correctly.");
+		CTimer	T;	T.Start			();
 		u32 count = chunk->r_u32	();
 		Shaders.resize				(count);
 		for(u32 i=0; i<count; i++)	// skip first shader as "reserved" one
@@ -41,6 +42,7 @@ void CRender::level_Load(IReader *fs)
 			Shaders[i]				= Device.Resources->Create(n_sh,n_tlist);
 		}
 		chunk->close();
+		Msg							("* [shaders] create: %d, %d ms",count,T.GetElapsed_ms());
 	}
 
 	// Components
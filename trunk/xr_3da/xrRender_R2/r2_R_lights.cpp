@@ -99,8 +99,8 @@ void	CRender::render_lights	(light_Package& LP)
 			else							r_pmask	(true,false	);
 			L->svis.begin							();
 			r_dsgraph_render_subspace				(L->spatial.sector, L->X.S.combine, L->position, TRUE);
-			bool	bNormal							= mapNormal[0].size() || mapMatrix[0].size();
-			bool	bSpecial						= mapNormal[1].size() || mapMatrix[1].size() || mapSorted.size();
+			bool	bNormal							= !r_dsgraph_graph_empty(0);
+			bool	bSpecial						= !r_dsgraph_graph_empty(1) || mapSorted.size();
 			if ( bNormal || bSpecial)	{
 				stats.s_merged						++;
 				L_spot_s.push_back					(L);
@@ -72,15 +72,10 @@ void CRender::render_main	(Fmatrix&	m_ViewProjection, bool _fportals)
 			);
 
 		// Determine visibility for static geometry hierrarhy
-		for (u32 s_it=0; s_it<PortalTraverser.r_sectors.size(); s_it++)
-		{
-			CSector*	sector		= (CSector*)PortalTraverser.r_sectors[s_it];
-			IRender_Visual*	root	= sector->root();
-			for (u32 v_it=0; v_it<sector->r_frustums.size(); v_it++)	{
-				set_Frustum			(&(sector->r_frustums[v_it]));
-				add_Geometry		(root);
-			}
-		}
+		r_dsgraph_build_static		(PortalTraverser.r_sectors);
+
+		// Animate everything which may be visible
+		r_dsgraph_calculate_bones	(PortalTraverser.i_marker,TRUE);
 
 		// Traverse frustums
 		for (u32 o_it=0; o_it<lstRenderables.size(); o_it++)
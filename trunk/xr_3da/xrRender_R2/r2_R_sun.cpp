@@ -853,8 +853,8 @@ void CRender::render_sun				()
 	// Render shadow-map
 	//. !!! We should clip based on shrinked frustum (again)
 	{
-		bool	bNormal							= mapNormal[0].size() || mapMatrix[0].size();
-		bool	bSpecial						= mapNormal[1].size() || mapMatrix[1].size() || mapSorted.size();
+		bool	bNormal							= !r_dsgraph_graph_empty(0);
+		bool	bSpecial						= !r_dsgraph_graph_empty(1) || mapSorted.size();
 		if ( bNormal || bSpecial)	{
 			Target->phase_smap_direct			(fuckingsun, SE_SUN_FAR		);
 			RCache.set_xform_world				(Fidentity					);
@@ -1039,7 +1039,7 @@ void CRender::render_sun_near	()
 
 	// Begin SMAP-render
 	{
-		bool	bSpecialFull					= mapNormal[1].size() || mapMatrix[1].size() || mapSorted.size();
+		bool	bSpecialFull					= !r_dsgraph_graph_empty(1) || mapSorted.size();
 		VERIFY									(!bSpecialFull);
 		HOM.Disable								();
 		phase									= PHASE_SMAP;
@@ -1057,8 +1057,8 @@ void CRender::render_sun_near	()
 	// Render shadow-map
 	//. !!! We should clip based on shrinked frustum (again)
 	{
-		bool	bNormal							= mapNormal[0].size() || mapMatrix[0].size();
-		bool	bSpecial						= mapNormal[1].size() || mapMatrix[1].size() || mapSorted.size();
+		bool	bNormal							= !r_dsgraph_graph_empty(0);
+		bool	bSpecial						= !r_dsgraph_graph_empty(1) || mapSorted.size();
 		if ( bNormal || bSpecial)	{
 			Target->phase_smap_direct			(fuckingsun	, SE_SUN_NEAR	);
 			RCache.set_xform_world				(Fidentity					);
@@ -7,6 +7,8 @@
 float			psShedulerCurrent		= 10.f	;
 float			psShedulerTarget		= 10.f	;
 const	float	psShedulerReaction		= 0.1f	;
+const	float	psShedulerJobCost		= 0.02f	;		// ms, estimate for objects never updated yet
+int				psShedulerParallel		= 1		;
 BOOL			g_bSheduleInProgress	= FALSE	;
 
 //-------------------------------------------------------------------------------------
@@ -21,26 +23,65 @@ void CSheduler::Destroy			()
 
 	for (u32 it=0; it<Items.size(); it++)
 	{
-		if (0==Items[it].Object)	
+		if (0==Slots[Items[it].slot].Object)
 		{
 			Items.erase(Items.begin()+it);
 			it	--;
 		}
 	}
-#ifdef DEBUG	
+#ifdef DEBUG
 	if (!Items.empty())
 	{
 		string1024		_objects; _objects[0]=0;
 
 		Msg				("! Sheduler work-list is not empty");
 		for (u32 it=0; it<Items.size(); it++)
-			Msg("%s",*Items[it].Object->shedule_Name().c_str());
+			Msg("%s",*Slots[Items[it].slot].scheduled_name);
 	}
 #endif // DEBUG
 	ItemsRT.clear		();
 	Items.clear			();
 	ItemsProcessed.clear();
 	Registration.clear	();
+	Slots.clear			();
+	SlotsFree.clear		();
+	Jobs.clear			();
+}
+
+u32		CSheduler::slot_alloc		(ISheduled* O)
+{
+	u32		slot;
+	if (SlotsFree.empty())		{
+		slot					= Slots.size();
+		Slots.push_back			(Slot());
+	} else {
+		slot					= SlotsFree.back();
+		SlotsFree.pop_back		();
+	}
+	Slot&	S					= Slots[slot];
+	S.Object					= O;
+	S.scheduled_name			= O->shedule_Name();
+	S.cost						= 0.f;
+	S.cost_max					= 0.f;
+	S.updates					= 0;
+	O->shedule_slot				= slot;
+	return	slot;
+}
+
+void	CSheduler::slot_free		(u32 slot)
+{
+	Slot&	S					= Slots[slot];
+	S.Object					= NULL;
+	S.scheduled_name			= 0;
+	SlotsFree.push_back			(slot);
+}
+
+void	CSheduler::slot_stat		(u32 slot, float ms)
+{
+	Slot&	S					= Slots[slot];
+	S.cost						= S.updates ? (0.9f*S.cost + 0.1f*ms) : ms;
+	S.cost_max					= _max(S.cost_max,ms);
+	S.updates					++;
 }
 
 void	CSheduler::internal_Registration()
@@ -70,13 +111,13 @@ void	CSheduler::internal_Registration()
 				internal_Register		(R.Object,R.RT);
 			}
 #ifdef DEBUG_SCHEDULER
-			else 
+			else
 				Msg						("SCHEDULER: internal register skipped, because unregister found [%s][%x][%s]","unknown",R.Object,R.RT ? "true" : "false");
 #endif // DEBUG_SCHEDULER
 		}
 		else		{
 			// unregister
-			internal_Unregister			(R.Object,R.RT);
+			internal_Unregister			(R.Object,R.slot);
 		}
 	}
 	Registration.clear	();
@@ -85,58 +126,30 @@ void	CSheduler::internal_Registration()
 void CSheduler::internal_Register	(ISheduled* O, BOOL RT)
 {
 	VERIFY	(!O->shedule.b_locked)	;
-	if (RT)
-	{
-		// Fill item structure
-		Item						TNext;
-		TNext.dwTimeForExecute		= Device.dwTimeGlobal;
-		TNext.dwTimeOfLastExecute	= Device.dwTimeGlobal;
-		TNext.Object				= O;
-		TNext.scheduled_name		= O->shedule_Name();
-		O->shedule.b_RT				= TRUE;
 
-		ItemsRT.push_back			(TNext);
-	} else {
-		// Fill item structure
-		Item						TNext;
-		TNext.dwTimeForExecute		= Device.dwTimeGlobal;
-		TNext.dwTimeOfLastExecute	= Device.dwTimeGlobal;
-		TNext.Object				= O;
-		TNext.scheduled_name		= O->shedule_Name();
-		O->shedule.b_RT				= FALSE;
+	// Fill item structure
+	Item						TNext;
+	TNext.dwTimeForExecute		= Device.dwTimeGlobal;
+	TNext.dwTimeOfLastExecute	= Device.dwTimeGlobal;
+	TNext.slot					= slot_alloc(O);
+	O->shedule.b_RT				= RT;
 
-		// Insert into priority Queue
-		Push						(TNext);
-	}
+	if (RT)		ItemsRT.push_back	(TNext);
+	else		Push				(TNext);	// Insert into priority Queue
 }
 
-bool CSheduler::internal_Unregister	(ISheduled* O, BOOL RT, bool warn_on_not_found)
+bool CSheduler::internal_Unregister	(ISheduled* O, u32 slot, bool warn_on_not_found)
 {
 	//the object may be already dead
 	//VERIFY	(!O->shedule.b_locked)	;
-	if (RT)
-	{
-		for (u32 i=0; i<ItemsRT.size(); i++)
-		{
-			if (ItemsRT[i].Object==O) {
-#ifdef DEBUG_SCHEDULER
-				Msg					("SCHEDULER: internal unregister [%s][%x][%s]","unknown",O,"true");
-#endif // DEBUG_SCHEDULER
-				ItemsRT.erase(ItemsRT.begin()+i);
-				return				(true);
-			}
-		}
-	} else {
-		for (u32 i=0; i<Items.size(); i++)
-		{
-			if (Items[i].Object==O) {
+
+	// the item itself is dropped (and the slot is reused) when the queue reaches it
+	if (slot<Slots.size() && Slots[slot].Object==O)	{
 #ifdef DEBUG_SCHEDULER
-				Msg					("SCHEDULER: internal unregister [%s][%x][%s]",*Items[i].scheduled_name,O,"false");
+		Msg							("SCHEDULER: internal unregister [%s][%x]",*Slots[slot].scheduled_name,O);
 #endif // DEBUG_SCHEDULER
-				Items[i].Object	= NULL;
-				return				(true);
-			}
-		}
+		Slots[slot].Object			= NULL;
+		return						(true);
 	}
 
 #ifdef DEBUG
@@ -151,41 +164,9 @@ bool CSheduler::internal_Unregister	(ISheduled* O, BOOL RT, bool warn_on_not_fou
 bool CSheduler::Registered		(ISheduled *object) const
 {
 	u32							count = 0;
-	typedef xr_vector<Item>		ITEMS;
-
-	{
-		ITEMS::const_iterator	I = ItemsRT.begin();
-		ITEMS::const_iterator	E = ItemsRT.end();
-		for ( ; I != E; ++I)
-			if ((*I).Object == object) {
-//				Msg				("0x%8x found in RT",object);
-				count			= 1;
-				break;
-			}
-	}
-	{
-		ITEMS::const_iterator	I = Items.begin();
-		ITEMS::const_iterator	E = Items.end();
-		for ( ; I != E; ++I)
-			if ((*I).Object == object) {
-//				Msg				("0x%8x found in non-RT",object);
-				VERIFY			(!count);
-				count			= 1;
-				break;
-			}
-	}
-
-	{
-		ITEMS::const_iterator	I = ItemsProcessed.begin();
-		ITEMS::const_iterator	E = ItemsProcessed.end();
-		for ( ; I != E; ++I)
-			if ((*I).Object == object) {
-//				Msg				("0x%8x found in process items",object);
-				VERIFY			(!count);
-				count			= 1;
-				break;
-			}
-	}
+	u32							slot = object->shedule_slot;
+	if ((slot < Slots.size()) && (Slots[slot].Object == object))
+		count					= 1;
 
 	typedef xr_vector<ItemReg>	ITEMS_REG;
 	ITEMS_REG::const_iterator	I = Registration.begin();
@@ -212,12 +193,14 @@ bool CSheduler::Registered		(ISheduled *object) const
 
 void	CSheduler::Register		(ISheduled* A, BOOL RT				)
 {
+	RegistrationLock.Enter		();
 	VERIFY		(!Registered(A));
 
 	ItemReg		R;
 	R.OP		= TRUE				;
 	R.RT		= RT				;
 	R.Object	= A					;
+	R.slot		= u32(-1)			;
 	R.Object->shedule.b_RT	= RT	;
 
 #ifdef DEBUG_SCHEDULER
@@ -225,27 +208,31 @@ void	CSheduler::Register		(ISheduled* A, BOOL RT				)
 #endif // DEBUG_SCHEDULER
 
 	Registration.push_back	(R);
+	RegistrationLock.Leave		();
 }
 
 void	CSheduler::Unregister	(ISheduled* A						)
 {
+	RegistrationLock.Enter		();
 	VERIFY		(Registered(A));
 
 #ifdef DEBUG_SCHEDULER
 	Msg			("SCHEDULER: unregister [%s][%x]",*A->shedule_Name(),A);
 #endif // DEBUG_SCHEDULER
 
-	if (m_processing_now) {
-		if (internal_Unregister(A,A->shedule.b_RT,false))
-			return;
+	if (m_processing_now && internal_Unregister(A,A->shedule_slot,false))	{
+		RegistrationLock.Leave	();
+		return;
 	}
 
 	ItemReg		R;
 	R.OP		= FALSE				;
 	R.RT		= A->shedule.b_RT	;
 	R.Object	= A					;
+	R.slot		= A->shedule_slot	;
 
 	Registration.push_back			(R);
+	RegistrationLock.Leave		();
 }
 
 void CSheduler::EnsureOrder		(ISheduled* Before, ISheduled* After)
@@ -254,7 +241,7 @@ void CSheduler::EnsureOrder		(ISheduled* Before, ISheduled* After)
 
 	for (u32 i=0; i<ItemsRT.size(); i++)
 	{
-		if (ItemsRT[i].Object==After) 
+		if (Slots[ItemsRT[i].slot].Object==After)
 		{
 			Item	A			= ItemsRT[i];
 			ItemsRT.erase		(ItemsRT.begin()+i);
@@ -278,120 +265,114 @@ void CSheduler::Pop					()
 
 void CSheduler::ProcessStep			()
 {
-	// Normal priority
+	// Phase 1: objects not flagged as thread-safe are updated right away, in the queue order
+	// Phase 2: thread-safe ones are collected and updated in parallel (see ProcessJobs)
+	// The budget accounts for the collected jobs by their measured cost spread over the workers
 	u32		dwTime					= Device.dwTimeGlobal;
-	CTimer							eTimer;
-	for (int i=0;!Items.empty() && Top().dwTimeForExecute < dwTime; ++i) {
-		u32		delta_ms			= dwTime - Top().dwTimeForExecute;
-
+	float	ms_per_cycle			= 1000.f/float(CPU::qpc_freq);
+	u32		workers					= psShedulerParallel ? WorkerPool.workers() : 1;
+	u64		jobs_cycles				= 0;
+	Jobs.clear						();
+	while (!Items.empty() && Top().dwTimeForExecute < dwTime) {
 		// Update
 		Item	T					= Top	();
+		Slot&	S					= Slots	[T.slot];
+		ISheduled*	O				= S.Object;
 #ifdef DEBUG_SCHEDULER
-		Msg		("SCHEDULER: process step [%s][%x][false]",*T.scheduled_name,T.Object);
+		Msg		("SCHEDULER: process step [%s][%x][false]",*S.scheduled_name,O);
 #endif // DEBUG_SCHEDULER
 		u32		Elapsed				= dwTime-T.dwTimeOfLastExecute;
 		bool	condition;
-		
+
 #ifndef DEBUG
 		__try {
 #endif // DEBUG
-			condition				= (NULL==T.Object || !T.Object->shedule_Needed());
+			condition				= (NULL==O || !O->shedule_Needed());
 #ifndef DEBUG
 		}
 		__except(EXCEPTION_EXECUTE_HANDLER) {
-			Msg						("Scheduler tried to update object %s",*T.scheduled_name);
+			Msg						("Scheduler tried to update object %s",*S.scheduled_name);
 			FlushLog				();
-			T.Object				= 0;
-			continue;
+			condition				= true;
 		}
 #endif // DEBUG
 
 		if (condition) {
 			// Erase element
 #ifdef DEBUG_SCHEDULER
-			Msg						("SCHEDULER: process unregister [%s][%x][%s]",*T.scheduled_name,T.Object,"false");
+			Msg						("SCHEDULER: process unregister [%s][%x][%s]",*S.scheduled_name,O,"false");
 #endif // DEBUG_SCHEDULER
-//			if (T.Object)
-//				Msg					("0x%08x UNREGISTERS because shedule_Needed() returned false",T.Object);
-//			else
-//				Msg					("UNREGISTERS unknown object");
 			Pop						();
+			slot_free				(T.slot);
 			continue;
 		}
 
 		// Insert into priority Queue
 		Pop							();
 
+		u64		cycles_update		= CPU::QPC();
 #ifndef DEBUG
 		__try {
 #endif // DEBUG
-			// Real update call
-			// Msg						("------- %d:",Device.dwFrame);
-#ifdef DEBUG
-			T.Object->dbg_startframe	= Device.dwFrame;
-			eTimer.Start				();
-			LPCSTR		_obj_name		= T.Object->shedule_Name().c_str();
-#endif // DEBUG
-
 			// Calc next update interval
-			u32		dwMin				= _max(u32(30),T.Object->shedule.t_min);
-			u32		dwMax				= (1000+T.Object->shedule.t_max)/2;
-			float	scale				= T.Object->shedule_Scale	(); 
+			u32		dwMin				= _max(u32(30),O->shedule.t_min);
+			u32		dwMax				= (1000+O->shedule.t_max)/2;
+			float	scale				= O->shedule_Scale	();
 			u32		dwUpdate			= dwMin+iFloor(float(dwMax-dwMin)*scale);
 			clamp	(dwUpdate,u32(_max(dwMin,u32(20))),dwMax);
-
-
-//			try {
-				T.Object->shedule_Update	(clampr(Elapsed,u32(1),u32(_max(u32(T.Object->shedule.t_max),u32(1000)))) );
-//			} catch (...) {
+			u32		dt					= clampr(Elapsed,u32(1),u32(_max(u32(O->shedule.t_max),u32(1000))));
+
+			if (psShedulerParallel && O->shedule.b_MT)	{
+				// deferred
+				Job						J;
+				J.Object				= O;
+				J.slot					= T.slot;
+				J.dt					= dt;
+				J.dwTimeForExecute		= dwTime+dwUpdate;
+				J.cycles				= 0;
+				J.failed				= FALSE;
+				Jobs.push_back			(J);
+				jobs_cycles				+= u64(_max(S.cost,psShedulerJobCost)/ms_per_cycle);
+			} else {
+				// Real update call
 #ifdef DEBUG
-//				Msg		("! xrSheduler: object '%s' raised an exception", _obj_name);
-//				throw	;
-#endif
-//			}
+				O->dbg_startframe		= Device.dwFrame;
+#endif // DEBUG
+				O->shedule_Update		(dt);
+				float	ms				= float(CPU::QPC()-cycles_update)*ms_per_cycle;
+				slot_stat				(T.slot,ms);
+
+				// Fill item structure
+				Item					TNext;
+				TNext.dwTimeForExecute	= dwTime+dwUpdate;
+				TNext.dwTimeOfLastExecute	= dwTime;
+				TNext.slot				= T.slot;
+				ItemsProcessed.push_back(TNext);
 #ifdef DEBUG
-			u32	execTime				= eTimer.GetElapsed_ms		();
+				if (ms > 15.f)			{
+					Msg	("* xrSheduler: too much time consumed by object [%s] (%2.1fms)",	*Slots[T.slot].scheduled_name, ms	);
+				}
 #endif
-
-			// Fill item structure
-			Item						TNext;
-			TNext.dwTimeForExecute		= dwTime+dwUpdate;
-			TNext.dwTimeOfLastExecute	= dwTime;
-			TNext.Object				= T.Object;
-			TNext.scheduled_name		= T.Object->shedule_Name();
-
-			ItemsProcessed.push_back	(TNext);
-#ifdef DEBUG
-//		u32	execTime				= eTimer.GetElapsed_ms		();
-			// VERIFY3					(T.Object->dbg_update_shedule == T.Object->dbg_startframe, "Broken sequence of calls to 'shedule_Update'", _obj_name );
-			if (delta_ms> 3*dwUpdate)	{
-				//Msg	("! xrSheduler: failed to shedule object [%s] (%dms)",	_obj_name, delta_ms	);
-			}
-			if (execTime> 15)			{
-				Msg	("* xrSheduler: too much time consumed by object [%s] (%dms)",	_obj_name, execTime	);
 			}
-#endif
 #ifndef DEBUG
 		}
 		__except(EXCEPTION_EXECUTE_HANDLER) {
-			Msg						("Scheduler tried to update object %s",*T.scheduled_name);
+			Msg						("Scheduler tried to update object %s",*Slots[T.slot].scheduled_name);
 			FlushLog				();
-			T.Object				= 0;
+			slot_free				(T.slot);
 			continue;
 		}
 #endif // DEBUG
 
-		// 
-		if ((i % 3) != (3 - 1))
-			continue;
-
-		if (CPU::QPC() > cycles_limit)		{
+		if (CPU::QPC() + jobs_cycles/workers > cycles_limit)		{
 			// we have maxed out the load - increase heap
 			psShedulerTarget		+= (psShedulerReaction * 3);
 			break;
 		}
 	}
 
+	ProcessJobs						();
+
 	// Push "processed" back
 	while (ItemsProcessed.size())	{
 		Push	(ItemsProcessed.back())	;
@@ -401,10 +382,69 @@ void CSheduler::ProcessStep			()
 	// always try to decrease target
 	psShedulerTarget	-= psShedulerReaction;
 }
+
+void __stdcall CSheduler::ProcessJobs_MT	(u32 begin, u32 end, u32 worker_id)
+{
+	for (u32 it=begin; it<end; it++)
+	{
+		Job&	J					= Jobs[it];
+		u64		start				= CPU::QPC();
+#ifndef DEBUG
+		__try {
+#endif // DEBUG
+#ifdef DEBUG
+			J.Object->dbg_startframe	= Device.dwFrame;
+#endif // DEBUG
+			J.Object->shedule_Update	(J.dt);
+#ifndef DEBUG
+		}
+		__except(EXCEPTION_EXECUTE_HANDLER) {
+			J.failed				= TRUE;
+		}
+#endif // DEBUG
+		J.cycles					= CPU::QPC()-start;
+	}
+}
+
+void CSheduler::ProcessJobs			()
+{
+	// objects unregistered during the first phase are not updated
+	for (u32 it=0; it<Jobs.size(); it++)
+	{
+		if (Slots[Jobs[it].slot].Object==Jobs[it].Object)	continue;
+		slot_free					(Jobs[it].slot);
+		Jobs[it]					= Jobs.back();
+		Jobs.pop_back				();
+		it							--;
+	}
+	if (Jobs.empty())				return;
+
+	WorkerPool.parallel_for			(Jobs.size(),1,CWorkerPool::range_callback(this,&CSheduler::ProcessJobs_MT));
+
+	float	ms_per_cycle			= 1000.f/float(CPU::qpc_freq);
+	for (u32 it=0; it<Jobs.size(); it++)
+	{
+		Job&	J					= Jobs[it];
+		if (J.failed)				{
+			Msg						("Scheduler tried to update object %s",*Slots[J.slot].scheduled_name);
+			FlushLog				();
+			slot_free				(J.slot);
+			continue;
+		}
+		slot_stat					(J.slot,float(J.cycles)*ms_per_cycle);
+
+		Item						TNext;
+		TNext.dwTimeForExecute		= J.dwTimeForExecute;
+		TNext.dwTimeOfLastExecute	= Device.dwTimeGlobal;
+		TNext.slot					= J.slot;
+		ItemsProcessed.push_back	(TNext);
+	}
+	Jobs.clear						();
+}
 /*
 void CSheduler::Switch				()
 {
-	if (fibered)	
+	if (fibered)
 	{
 		fibered						= FALSE;
 		SwitchToFiber				(fiber_main);
@@ -430,13 +470,20 @@ void CSheduler::Update				()
 	for (u32 it=0; it<ItemsRT.size(); it++)
 	{
 		Item&	T					= ItemsRT[it];
-		R_ASSERT					(T.Object);
+		ISheduled*	O				= Slots[T.slot].Object;
+		if (0==O)					{
+			// unregistered
+			slot_free				(T.slot);
+			ItemsRT.erase			(ItemsRT.begin()+it);
+			it						--;
+			continue;
+		}
 #ifdef DEBUG_SCHEDULER
-		Msg							("SCHEDULER: process step [%s][%x][true]",*T.Object->shedule_Name(),T.Object);
+		Msg							("SCHEDULER: process step [%s][%x][true]",*O->shedule_Name(),O);
 #endif // DEBUG_SCHEDULER
-		if(!T.Object->shedule_Needed()){
+		if(!O->shedule_Needed()){
 #ifdef DEBUG_SCHEDULER
-			Msg						("SCHEDULER: process unregister [%s][%x][%s]",*T.Object->shedule_Name(),T.Object,"false");
+			Msg						("SCHEDULER: process unregister [%s][%x][%s]",*O->shedule_Name(),O,"false");
 #endif // DEBUG_SCHEDULER
 			T.dwTimeOfLastExecute	= dwTime;
 			continue;
@@ -444,10 +491,10 @@ void CSheduler::Update				()
 
 		u32	Elapsed					= dwTime-T.dwTimeOfLastExecute;
 #ifdef DEBUG
-		VERIFY						(T.Object->dbg_startframe != Device.dwFrame);
-		T.Object->dbg_startframe	= Device.dwFrame;
+		VERIFY						(O->dbg_startframe != Device.dwFrame);
+		O->dbg_startframe			= Device.dwFrame;
 #endif
-		T.Object->shedule_Update	(Elapsed);
+		O->shedule_Update			(Elapsed);
 		T.dwTimeOfLastExecute		= dwTime;
 	}
 
@@ -466,3 +513,31 @@ void CSheduler::Update				()
 	internal_Registration			();
 	Device.Statistic->Sheduler.End	();
 }
+
+struct	sheduler_stat_pred
+{
+	bool	operator ()	(const std::pair<float,u32>& a, const std::pair<float,u32>& b) const	{ return a.first>b.first; }
+};
+void CSheduler::DumpStatistics		()
+{
+	xr_vector<std::pair<float,u32> >	order;
+	u32		mt						= 0;
+	float	total					= 0.f;
+	for (u32 it=0; it<Slots.size(); it++)
+	{
+		Slot&	S					= Slots[it];
+		if (0==S.Object)			continue;
+		if (S.Object->shedule.b_MT)	mt++;
+		total						+= S.cost;
+		order.push_back				(mk_pair(S.cost,it));
+	}
+	std::sort						(order.begin(),order.end(),sheduler_stat_pred());
+
+	Msg		("- Sheduler: %d objects (%d RT, %d thread-safe), %d free slots, sum of updates %2.3fms",order.size(),ItemsRT.size(),mt,SlotsFree.size(),total);
+	Msg		("- %8s %8s %8s %3s %s","cost","max","updates","mt","name");
+	for (u32 it=0; it<_min(order.size(),u32(32)); it++)
+	{
+		Slot&	S					= Slots[order[it].second];
+		Msg	("* %8.3f %8.3f %8d %3s %s",S.cost,S.cost_max,S.updates,S.Object->shedule.b_MT?"+":"",*S.scheduled_name);
+	}
+}
@@ -9,24 +9,48 @@ private:
 	{
 		u32			dwTimeForExecute;
 		u32			dwTimeOfLastExecute;
-		shared_str	scheduled_name;
-		ISheduled*	Object;
+		u32			slot;
 		u32			dwPadding;				// for align-issues
 
 		IC bool		operator < (Item& I)
 		{	return dwTimeForExecute > I.dwTimeForExecute; }
 	};
+	// one per registered object, ISheduled::shedule_slot is the handle
+	// unregistered slot keeps NULL object until the item referencing it is reached
+	struct Slot
+	{
+		ISheduled*	Object;
+		shared_str	scheduled_name;
+		float		cost;					// ms per update, smoothed
+		float		cost_max;				// ms
+		u32			updates;
+	};
+	// update of thread-safe object, deferred to the parallel phase
+	struct Job
+	{
+		ISheduled*	Object;
+		u32			slot;
+		u32			dt;
+		u32			dwTimeForExecute;		// next one
+		u64			cycles;
+		BOOL		failed;
+	};
 	struct	ItemReg
 	{
 		BOOL		OP;
 		BOOL		RT;
 		ISheduled*	Object;
+		u32			slot;					// at the time of unregister, the object may be dead later
 	};
 private:
 	xr_vector<Item>			ItemsRT			;
 	xr_vector<Item>			Items			;
 	xr_vector<Item>			ItemsProcessed	;
 	xr_vector<ItemReg>		Registration	;
+	xr_vector<Slot>			Slots			;
+	xr_vector<u32>			SlotsFree		;
+	xr_vector<Job>			Jobs			;
+	xrCriticalSection		RegistrationLock;
 	bool					m_processing_now;
 
 	IC void			Push	(Item& I);
@@ -35,9 +59,14 @@ private:
 	{
 		return Items.front();
 	}
+	u32				slot_alloc				(ISheduled* O);
+	void			slot_free				(u32 slot);
+	void			slot_stat				(u32 slot, float ms);
 	void			internal_Register		(ISheduled* A, BOOL RT=FALSE		);
-	bool			internal_Unregister		(ISheduled* A, BOOL RT, bool warn_on_not_found = true);
+	bool			internal_Unregister		(ISheduled* A, u32 slot, bool warn_on_not_found = true);
 	void			internal_Registration	();
+	void			ProcessJobs				();
+	void __stdcall	ProcessJobs_MT			(u32 begin, u32 end, u32 worker_id);
 public:
 	u64				cycles_start;
 	u64				cycles_limit;
@@ -55,4 +84,5 @@ public:
 
 	void			Initialize	();
 	void			Destroy		();
+	void			DumpStatistics	();
 };
@@ -103,6 +103,9 @@ CObjectSpace::CObjectSpace	( )
 	sh_debug.create				("debug\\wireframe","$null");
 #endif
 	m_BoundingVolume.invalidate	();
+	m_static_rays.resize		(static_rays_count);
+	for (u32 it=0; it<m_static_rays.size(); ++it)
+		m_static_rays[it].frame	= u32(-1);
 }
 //----------------------------------------------------------------------
 CObjectSpace::~CObjectSpace	( )
@@ -22,6 +22,21 @@ private:
 	xrXRC								xrc;				// MT: dangerous
 	collide::rq_results					r_temp;				// MT: dangerous
 	xr_vector<ISpatial*>				r_spatial;			// MT: dangerous
+	xr_vector<ISpatial*>				r_batch;			// MT: dangerous
+
+	// frame-scoped memo of the single hit static queries, direct mapped on quantized start, direction and range
+	struct	static_ray
+	{
+		Fvector							start;
+		Fvector							dir;
+		float							range;
+		u32								flags;
+		u32								frame;
+		BOOL							hit;
+		CDB::RESULT						result;
+	};
+	enum								{ static_rays_count = 2048 };
+	xr_vector<static_ray>				m_static_rays;		// MT: dangerous
 public:
 
 #ifdef DEBUG
@@ -31,6 +46,9 @@ public:
 #endif
 
 private:
+	BOOL								_RayStatic			( const Fvector &start, const Fvector &dir, float range, u32 flags, CDB::RESULT& R);
+	bool								_RayBatchGather		( const collide::ray_defs* rays, u32 count );
+	bool								_RayBatchCandidate	( ISpatial* spatial, const collide::ray_defs& Q, float range, u32 d_flags );
 	BOOL								_RayTest			( const Fvector &start, const Fvector &dir, float range, collide::rq_target tgt, collide::ray_cache* cache, CObject* ignore_object);
 	BOOL								_RayPick			( const Fvector &start, const Fvector &dir, float range, collide::rq_target tgt, collide::rq_result& R, CObject* ignore_object );
 	BOOL								_RayQuery			( collide::rq_results& dest, const collide::ray_defs& rq, collide::rq_callback* cb, LPVOID user_data, collide::test_callback* tb, CObject* ignore_object);
@@ -51,6 +69,12 @@ public:
 	// General collision query
 	BOOL								RayQuery			( collide::rq_results& dest, const collide::ray_defs& rq, collide::rq_callback* cb, LPVOID user_data, collide::test_callback* tb, CObject* ignore_object);
 	BOOL								RayQuery			( collide::rq_results& dest, ICollisionForm* target, const collide::ray_defs& rq);
+
+	// Conservative test of a number of rays under one lock: static geometry exactly (any hit), dynamic objects by their bounds
+	// Static traces go through the frame cache, dynamic candidates of a coherent batch are gathered once
+	// A ray not touched (touched[i]==0) is guaranteed to find nothing with RayQuery
+	// Returns the number of rays touched
+	u32									RayTestBatch		( const collide::ray_defs* rays, u32 count, u8* touched, CObject* ignore_object );
 	// void								BoxQuery			( collide::rq_results& dest, const Fbox& B, const Fmatrix& M, u32 flags=clGET_TRIS|clGET_BOXES|clQUERY_STATIC|clQUERY_DYNAMIC);
 
 	int									GetNearest			( xr_vector<CObject*>&	q_nearest, ICollisionForm *obj, float range );
@@ -10,6 +10,44 @@
 
 using namespace	collide;
 
+//--------------------------------------------------------------------------------
+// Static single hit query, memoized for the frame - AI, bullets, sounds and HUD
+// shoot a lot of identical rays
+//--------------------------------------------------------------------------------
+IC u32	ray_key	(const Fvector &start, const Fvector &dir, float range, u32 flags)
+{
+	// 1cm cells of the start and the range, 1/1024 of the direction
+	u32		h	= u32(iFloor(start.x*100.f))*73856093u ^ u32(iFloor(start.y*100.f))*19349663u ^ u32(iFloor(start.z*100.f))*83492791u;
+	h			^= u32(iFloor(dir.x*1024.f))*2654435761u ^ u32(iFloor(dir.y*1024.f))*2246822519u ^ u32(iFloor(dir.z*1024.f))*3266489917u;
+	h			^= u32(iFloor(range*100.f))*668265263u ^ flags*374761393u;
+	return	h ^ (h>>15);
+}
+BOOL CObjectSpace::_RayStatic	( const Fvector &start, const Fvector &dir, float range, u32 flags, CDB::RESULT& R)
+{
+	VERIFY					(flags&(CDB::OPT_ONLYFIRST|CDB::OPT_ONLYNEAREST));
+	Device.Statistic->clRAY_static	++;
+
+	static_ray&	E			= m_static_rays[ray_key(start,dir,range,flags)&(static_rays_count-1)];
+	if ((E.frame==Device.dwFrame) && (E.flags==flags) && E.start.similar(start,EPS) && E.dir.similar(dir,EPS) && fsimilar(E.range,range,EPS))
+	{
+		Device.Statistic->clRAY_cached	++;
+		R					= E.result;
+		return				E.hit;
+	}
+
+	xrc.ray_options			(flags);
+	xrc.ray_query			(&Static,start,dir,range);
+	E.start					= start;
+	E.dir					= dir;
+	E.range					= range;
+	E.flags					= flags;
+	E.frame					= Device.dwFrame;
+	E.hit					= xrc.r_count()!=0;
+	if (E.hit)				E.result	= *xrc.r_begin();
+	R						= E.result;
+	return					E.hit;
+}
+
 //--------------------------------------------------------------------------------
 // RayTest - Occluded/No
 //--------------------------------------------------------------------------------
@@ -26,7 +64,6 @@ BOOL CObjectSpace::_RayTest	( const Fvector &start, const Fvector &dir, float ra
 	VERIFY					(_abs(dir.magnitude()-1)<EPS);
 	r_temp.r_clear			();
 
-	xrc.ray_options			(CDB::OPT_ONLYFIRST);
 	collide::ray_defs	Q	(start,dir,range,CDB::OPT_ONLYFIRST,tgt);
 
 	// dynamic test
@@ -64,15 +101,14 @@ BOOL CObjectSpace::_RayTest	( const Fvector &start, const Fvector &dir, float ra
 			}
 			
 			// 2. Polygon doesn't pick - real database query
-			xrc.ray_query	(&Static,start,dir,range);
-			if (0==xrc.r_count()) {
+			CDB::RESULT		R;
+			if (!_RayStatic(start,dir,range,CDB::OPT_ONLYFIRST,R)) {
 				cache->set		(start,dir,range,FALSE);
 				return FALSE;
 			} else {
 				// cache polygon
 				cache->set		(start,dir,range,TRUE);
-				CDB::RESULT*	R	= xrc.r_begin();
-				CDB::TRI&		T	= Static.get_tris() [ R->id ];
+				CDB::TRI&		T	= Static.get_tris() [ R.id ];
 				Fvector*		V	= Static.get_verts();
 				cache->verts[0].set	(V[T.verts[0]]);
 				cache->verts[1].set	(V[T.verts[1]]);
@@ -80,8 +116,8 @@ BOOL CObjectSpace::_RayTest	( const Fvector &start, const Fvector &dir, float ra
 				return TRUE;
 			}
 		} else {
-			xrc.ray_query		(&Static,start,dir,range);
-			return xrc.r_count	();
+			CDB::RESULT		R;
+			return _RayStatic	(start,dir,range,CDB::OPT_ONLYFIRST,R);
 		}
 	}
 	return FALSE;
@@ -104,9 +140,8 @@ BOOL CObjectSpace::_RayPick	( const Fvector &start, const Fvector &dir, float ra
 	R.O		= 0; R.range = range; R.element = -1;
 	// static test
 	if (tgt&rqtStatic){ 
-		xrc.ray_options		(CDB::OPT_ONLYNEAREST | CDB::OPT_CULL);
-		xrc.ray_query		(&Static,start,dir,range);
-		if (xrc.r_count())  R.set_if_less(xrc.r_begin());
+		CDB::RESULT			S;
+		if (_RayStatic(start,dir,range,CDB::OPT_ONLYNEAREST|CDB::OPT_CULL,S))	R.set_if_less(&S);
 	}
 	// dynamic test
 	if (tgt&rqtDyn){ 
@@ -164,7 +199,11 @@ BOOL CObjectSpace::_RayQuery2	(collide::rq_results& r_dest, const collide::ray_d
 	u32			d_flags =	STYPE_COLLIDEABLE|((R.tgt&rqtObstacle)?STYPE_OBSTACLE:0)|((R.tgt&rqtShape)?STYPE_SHAPE:0);
 
 	// Test static
-	if (R.tgt&s_mask){ 
+	if ((R.tgt&s_mask) && (R.flags&(CDB::OPT_ONLYFIRST|CDB::OPT_ONLYNEAREST))){
+		CDB::RESULT		S;
+		if (_RayStatic(R.start,R.dir,R.range,R.flags,S))
+			r_temp.append_result(rq_result().set(0,S.range,S.id));
+	}else if (R.tgt&s_mask){ 
 		xrc.ray_options	(R.flags);
 		xrc.ray_query	(&Static,R.start,R.dir,R.range);
 		if (xrc.r_count()){	
@@ -223,13 +262,10 @@ BOOL CObjectSpace::_RayQuery3	(collide::rq_results& r_dest, const collide::ray_d
 			// static test allowed
 
 			// test static
-			xrc.ray_options		(s_rd.flags);
-			xrc.ray_query		(&Static,s_rd.start,s_rd.dir,s_rd.range);
-
-			if (xrc.r_count())	{	
-				VERIFY			(xrc.r_count()==1);
+			CDB::RESULT			S;
+			if (_RayStatic(s_rd.start,s_rd.dir,s_rd.range,s_rd.flags,S))	{	
 				rq_result		s_res;
-				s_res.set		(0,xrc.r_begin()->range,xrc.r_begin()->id);
+				s_res.set		(0,S.range,S.id);
 				// update dynamic test range
 				d_rd.range		= s_res.range;
 				// set next static start & range
@@ -308,10 +344,9 @@ BOOL CObjectSpace::_RayQuery	(collide::rq_results& r_dest, const collide::ray_de
 			s_res.set		(0,s_rd.range,-1);
 			// Test static model
 			if (s_rd.range>EPS){
-				xrc.ray_options	(s_rd.flags);
-				xrc.ray_query	(&Static,s_rd.start,s_rd.dir,s_rd.range);
-				if (xrc.r_count()){	
-					if (s_res.set_if_less(xrc.r_begin())){
+				CDB::RESULT		S;
+				if (_RayStatic(s_rd.start,s_rd.dir,s_rd.range,s_rd.flags,S)){	
+					if (s_res.set_if_less(&S)){
 						// set new static start & range
 						s_rd.range	-=	(s_res.range+EPS_L);
 						s_rd.start.mad	(s_rd.dir,s_res.range+EPS_L);
@@ -394,6 +429,86 @@ BOOL CObjectSpace::_RayQuery	(collide::rq_results& r_dest, const collide::ray_de
 	return r_dest.r_count	()	;
 }
 
+//--------------------------------------------------------------------------------
+// RayTestBatch
+//--------------------------------------------------------------------------------
+IC float half_perimeter	(const Fbox& B)
+{
+	return (B.max.x-B.min.x) + (B.max.y-B.min.y) + (B.max.z-B.min.z);
+}
+// the dynamic candidates are gathered once, if the bounds of the batch are not worse than the rays taken apart
+bool CObjectSpace::_RayBatchGather	(const collide::ray_defs* rays, u32 count)
+{
+	Device.Statistic->clRAY_batch		++;
+	Device.Statistic->clRAY_batch_rays	+= count;
+
+	Fbox		bounds;			bounds.invalidate	();
+	float		apart			= 0.f;
+	for (u32 it=0; it<count; ++it)
+	{
+		const ray_defs&	Q		= rays[it];
+		if (0==(Q.tgt&rqtDyn))	continue;
+		Fbox		B;			B.invalidate		();
+		B.modify				(Q.start);
+		B.modify				(Fvector().mad(Q.start,Q.dir,Q.range));
+		bounds.merge			(B);
+		apart					+= half_perimeter(B);
+	}
+	bool		shared			= (count>1) && (apart>0.f) && (half_perimeter(bounds)<=apart);
+	if (shared)	{
+		Fvector		C,D;		bounds.get_CD		(C,D);
+		g_SpatialSpace->q_box	(r_batch,0,STYPE_COLLIDEABLE,C,D);
+	}
+	return		shared;
+}
+// the same as ISpatial_DB::q_ray does for the items
+bool CObjectSpace::_RayBatchCandidate	(ISpatial* spatial, const collide::ray_defs& Q, float range, u32 d_flags)
+{
+	if (d_flags!=(spatial->spatial.type&d_flags))	return false;
+	int					quantity;
+	float				afT[2];
+	Fsphere::ERP_Result	rp	= spatial->spatial.sphere.intersect(Q.start,Q.dir,range,quantity,afT);
+	return	(rp==Fsphere::rpOriginInside) || ((rp==Fsphere::rpOriginOutside)&&(afT[0]<range));
+}
+u32 CObjectSpace::RayTestBatch	(const collide::ray_defs* rays, u32 count, u8* touched, CObject* ignore_object)
+{
+	Lock.Enter					();
+	bool		shared			= _RayBatchGather(rays,count);
+
+	u32			result			= 0;
+	for (u32 it=0; it<count; ++it)
+	{
+		const ray_defs&	Q		= rays[it];
+		touched[it]				= 0;
+
+		// static test
+		if (Q.tgt&rqtStatic){
+			CDB::RESULT			S;
+			touched[it]			= _RayStatic(Q.start,Q.dir,Q.range,CDB::OPT_ONLYFIRST|(Q.flags&CDB::OPT_CULL),S) ? 1 : 0;
+		}
+		// dynamic test - any object RayQuery would pass to the test callback
+		if (!touched[it] && (Q.tgt&rqtDyn)){
+			u32			d_flags =	STYPE_COLLIDEABLE|((Q.tgt&rqtObstacle)?STYPE_OBSTACLE:0)|((Q.tgt&rqtShape)?STYPE_SHAPE:0);
+			xr_vector<ISpatial*>&	candidates	= shared ? r_batch : r_spatial;
+			if (!shared)		g_SpatialSpace->q_ray	(r_spatial,0,d_flags,Q.start,Q.dir,Q.range);
+			for (u32 o_it=0; o_it<candidates.size(); o_it++){
+				ISpatial*	spatial			= candidates[o_it];
+				if (shared && !_RayBatchCandidate(spatial,Q,Q.range,d_flags))	continue;
+				CObject*	collidable		= spatial->dcast_CObject();
+				if			(0==collidable)				continue;
+				if			(collidable==ignore_object)	continue;
+				touched[it]					= 1;
+				break;
+			}
+		}
+		result					+= touched[it];
+	}
+	r_spatial.clear_not_free	();
+	r_batch.clear_not_free		();
+	Lock.Leave					();
+	return						result;
+}
+
 BOOL CObjectSpace::RayQuery	(collide::rq_results& r_dest, ICollisionForm* target, const collide::ray_defs& R)
 {
 	VERIFY					(target);
@@ -103,6 +103,40 @@ public:
 		g_pMotionsContainer->dump();
 	}
 };
+class CCC_MotionsBench : public IConsole_Command
+{
+public:
+	CCC_MotionsBench(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		g_pMotionsContainer->benchmark();
+	}
+};
+class CCC_ShedulerStat : public IConsole_Command
+{
+public:
+	CCC_ShedulerStat(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		Engine.Sheduler.DumpStatistics();
+	}
+};
+class CCC_ObjectsBench : public IConsole_Command
+{
+public:
+	CCC_ObjectsBench(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		if (g_pGameLevel)	g_pGameLevel->Objects.benchmark();
+	}
+};
+class CCC_SpatialBench : public IConsole_Command
+{
+public:
+	CCC_SpatialBench(LPCSTR N) : IConsole_Command(N)  { bEmptyArgsHandled = TRUE; };
+	virtual void Execute(LPCSTR args) {
+		int		count	= 0;
+		sscanf	(args,"%d",&count);
+		ISpatial_DB::benchmark	(count>0 ? u32(count) : 4096);
+	}
+};
 class CCC_TexturesStat : public IConsole_Command
 {
 public:
@@ -497,6 +531,8 @@ extern Flags32		psEnvFlags;
 extern float		r__dtex_range;
 
 extern int			g_ErrorLineCount;
+extern int			psShedulerParallel;
+extern int			psTextureLoadParallel;
 
 
 ENGINE_API int			ps_r__Supersample			= 1;
@@ -514,7 +550,11 @@ void CCC_Register()
 //	CMD1(CCC_Crash,		"crash"					);
 
 	CMD1(CCC_MotionsStat,	"stat_motions"		);
+	CMD1(CCC_MotionsBench,	"stat_motions_bench");
 	CMD1(CCC_TexturesStat,	"stat_textures"		);
+	CMD1(CCC_ShedulerStat,	"stat_sheduler"		);
+	CMD1(CCC_ObjectsBench,	"stat_objects_bench");
+	CMD1(CCC_SpatialBench,	"stat_spatial_bench");
 #endif
 
 #ifdef DEBUG_MEMORY_MANAGER
@@ -531,6 +571,8 @@ void CCC_Register()
 	CMD3(CCC_Mask,		"mt_sound",				&psDeviceFlags,			mtSound);
 	CMD3(CCC_Mask,		"mt_physics",			&psDeviceFlags,			mtPhysics);
 	CMD3(CCC_Mask,		"mt_network",			&psDeviceFlags,			mtNetwork);
+	CMD4(CCC_Integer,	"mt_sheduler",			&psShedulerParallel,	0,	1);
+	CMD4(CCC_Integer,	"mt_texture_load",		&psTextureLoadParallel,	0,	1);
 	
 	// Events
 	CMD1(CCC_E_Dump,	"e_list"				);
@@ -558,6 +600,8 @@ void CCC_Register()
 	CMD3(CCC_Mask,		"rs_refresh_60hz",		&psDeviceFlags,		rsRefresh60hz			);
 	CMD3(CCC_Mask,		"rs_stats",				&psDeviceFlags,		rsStatistic				);
 	CMD4(CCC_Float,		"rs_vis_distance",		&psVisDistance,		0.4f,	1.5f			);
+	CMD4(CCC_Integer,	"rs_anim_cache",		&psAnimCache,		0,		512				);
+	CMD4(CCC_Float,		"rs_anim_compress",		&psAnimCompress,	0.f,	0.01f			);
 
 #ifdef DEBUG
 	CMD3(CCC_Mask,		"rs_cam_pos",			&psDeviceFlags,		rsCameraPos				);
@@ -574,6 +618,8 @@ void CCC_Register()
 
 	// Texture manager	
 	CMD4(CCC_Integer,	"texture_lod",			&psTextureLOD,				0,	4	);
+	CMD4(CCC_Integer,	"texture_stream_budget",&psTextureStreamBudget,		0,	2048);
+	CMD4(CCC_Float,		"texture_stream_scale",	&psTextureStreamScale,		0.25f,	4.f	);
 	CMD4(CCC_Integer,	"net_dedicated_sleep",	&psNET_DedicatedSleep,		0,	64	);
 
 	// General video control
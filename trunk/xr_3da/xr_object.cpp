@@ -18,6 +18,7 @@ void CObject::MakeMeCrow_internal	()
 void CObject::cName_set			(shared_str N)
 { 
 	NameObject	=	N; 
+	if (g_pGameLevel)	g_pGameLevel->Objects.net_Reindex(this);
 }
 void CObject::cNameSect_set		(shared_str N)
 { 
@@ -100,6 +101,7 @@ CObject::CObject		( )		: ISpatial(g_SpatialSpace)
 {
 	// Transform
 	Props.storage				= 0;
+	Handle						= 0;
 
 	Parent						= NULL;
 
@@ -54,6 +54,7 @@ public:
 private:
 	// Some property variables
 	ObjectProperties					Props;
+	u32									Handle;				// weak reference handle, see xr_object_handle.h
 	shared_str							NameObject;
 	shared_str							NameSection;
 	shared_str							NameVisual;
@@ -85,6 +86,8 @@ public:
 	ICF BOOL							Remote				()			const	{ return !Props.net_Local;	}
 	ICF u16								ID					()			const	{ return Props.net_ID;		}
 	ICF void							setID				(u16 _ID)			{ Props.net_ID = _ID;		}
+	ICF u32								handle				()			const	{ return Handle;			}
+	ICF void							setHandle			(u32 _handle)		{ Handle = _handle;			}
 	virtual BOOL						Ready				()					{ return Props.net_Ready;	}
 	BOOL								GetTmpPreDestroy		()		const	{ return Props.bPreDestroy;	}
 	void								SetTmpPreDestroy	(BOOL b)			{ Props.bPreDestroy = b;}
@@ -0,0 +1,80 @@
+#ifndef __XR_OBJECT_HANDLE_H__
+#define __XR_OBJECT_HANDLE_H__
+#pragma once
+
+// Weak references to game objects: 16 bit slot index + 16 bit generation of the slot.
+// CObjectList takes a slot when an object is created and releases it when the object goes to
+// destroy, bumping the generation - so a stale reference resolves to NULL on access and its
+// holder does not need a relcase callback (pure_relcase) to be purged.
+// Handle 0 is never valid.
+class	ENGINE_API	CObject;
+
+class	ENGINE_API	CObjectHandles
+{
+private:
+	struct	slot
+	{
+		CObject*					object;
+		u16							generation;
+	};
+	xr_vector<slot>					m_slots;
+	xr_vector<u16>					m_free;
+public:
+	u32								alloc		(CObject* O)
+	{
+		u16		id;
+		if (m_free.empty())			{
+			R_ASSERT2				(m_slots.size()<0xffff,"too many objects");
+			id						= u16(m_slots.size());
+			m_slots.push_back		(slot());
+			m_slots.back().generation	= 1;
+		} else {
+			id						= m_free.back();
+			m_free.pop_back			();
+		}
+		m_slots[id].object			= O;
+		return	(u32(m_slots[id].generation)<<16) | id;
+	}
+	void							release		(u32 handle)
+	{
+		VERIFY						(valid(handle));
+		slot&	S					= m_slots[handle&0xffff];
+		S.object					= NULL;
+		if (0==++S.generation)		S.generation = 1;
+		m_free.push_back			(u16(handle&0xffff));
+	}
+	IC bool							valid		(u32 handle) const
+	{
+		u32		id					= handle&0xffff;
+		return	(id<m_slots.size()) && (m_slots[id].generation==(handle>>16));
+	}
+	IC CObject*						resolve		(u32 handle) const
+	{
+		return	valid(handle) ? m_slots[handle&0xffff].object : NULL;
+	}
+	void							clear		()
+	{
+		m_slots.clear				();
+		m_free.clear				();
+	}
+};
+extern ENGINE_API	CObjectHandles	g_object_handles;
+
+// Typed weak reference, keeps the pointer (which may be an interface of the object)
+// together with the handle of the owning object
+template <class T>
+class	object_handle
+{
+private:
+	T*								m_object;
+	u32								m_handle;
+public:
+									object_handle	()							: m_object(0), m_handle(0)	{}
+									object_handle	(T* O, u32 handle)			: m_object(O), m_handle(O ? handle : 0)	{}
+	IC T*							get				() const					{ return g_object_handles.valid(m_handle) ? m_object : 0;	}
+	IC bool							valid			() const					{ return g_object_handles.valid(m_handle);	}
+	IC u32							handle			() const					{ return m_handle;	}
+	IC bool							operator ==		(const T* O) const			{ return O && (m_object==O) && valid();	}
+};
+
+#endif //__XR_OBJECT_HANDLE_H__
@@ -4,6 +4,7 @@
 
 #include "xrSheduler.h"
 #include "xr_object_list.h"
+#include "xr_object_handle.h"
 #include "std_classes.h"
 
 #include "xr_object.h"
@@ -11,6 +12,8 @@
 
 #include "CustomHUD.h"
 
+ENGINE_API	CObjectHandles	g_object_handles;
+
 class fClassEQ {
 	CLASS_ID cls;
 public:
@@ -18,8 +21,21 @@ public:
 	IC bool operator() (CObject* O) { return cls==O->CLS_ID; }
 };
 
+IC u32	hash_mix		(u32 h)
+{
+	h						^= h>>16;
+	h						*= 0x7feb352d;
+	h						^= h>>15;
+	h						*= 0x846ca68b;
+	h						^= h>>16;
+	return					h;
+}
+IC u32	name_key		(const shared_str& name)	{ return hash_mix(u32(size_t(name._get())));	}
+IC u32	cls_key			(CLASS_ID cls)				{ return hash_mix(u32(cls)^u32(cls>>32));		}
+
 CObjectList::CObjectList	( )
 {
+	net_count				= 0;
 	objects_dup_memsz		= 512;
 	objects_dup				= xr_alloc	<CObject*>	(objects_dup_memsz);
 	crows					= &crows_0	;
@@ -30,16 +46,16 @@ CObjectList::~CObjectList	( )
 	R_ASSERT				( objects_active.empty()	);
 	R_ASSERT				( objects_sleeping.empty()	);
 	R_ASSERT				( destroy_queue.empty()		);
-	R_ASSERT				( map_NETID.empty()			);
+	R_ASSERT				( 0==net_count				);
 	xr_free					( objects_dup);
 }
 
 CObject*	CObjectList::FindObjectByName	( shared_str name )
 {
-	for (xr_vector<CObject*>::iterator I=objects_active.begin(); I!=objects_active.end(); I++)
-		if ((*I)->cName().equal(name))	return (*I);
-	for (xr_vector<CObject*>::iterator I=objects_sleeping.begin(); I!=objects_sleeping.end(); I++)
-		if ((*I)->cName().equal(name))	return (*I);
+	if (net_by_name.empty())				return NULL;
+	u32		mask							= net_by_name.size()-1;
+	for (u32 ID=net_by_name[name_key(name)&mask]; ID!=u32(-1); ID=net_entries[ID].next_name)
+		if (net_entries[ID].object->cName().equal(name))	return net_entries[ID].object;
 	return	NULL;
 }
 CObject*	CObjectList::FindObjectByName	( LPCSTR name )
@@ -49,15 +65,10 @@ CObject*	CObjectList::FindObjectByName	( LPCSTR name )
 
 CObject*	CObjectList::FindObjectByCLS_ID	( CLASS_ID cls )
 {
-	{
-		xr_vector<CObject*>::iterator O	= std::find_if(objects_active.begin(),objects_active.end(),fClassEQ(cls));
-		if (O!=objects_active.end())	return *O;
-	}
-	{
-		xr_vector<CObject*>::iterator O	= std::find_if(objects_sleeping.begin(),objects_sleeping.end(),fClassEQ(cls));
-		if (O!=objects_sleeping.end())	return *O;
-	}
-
+	if (net_by_cls.empty())					return NULL;
+	u32		mask							= net_by_cls.size()-1;
+	for (u32 ID=net_by_cls[cls_key(cls)&mask]; ID!=u32(-1); ID=net_entries[ID].next_cls)
+		if (net_entries[ID].object->CLS_ID==cls)	return net_entries[ID].object;
 	return	NULL;
 }
 
@@ -172,6 +183,15 @@ void CObjectList::Update		(bool bForce)
 	// Destroy
 	if (!destroy_queue.empty()) 
 	{
+		// Weak references go stale at once, their holders are not notified
+		for (int it = destroy_queue.size()-1; it>=0; it--)	{
+			CObject*		O	= destroy_queue[it];
+			if (O->handle())	{
+				g_object_handles.release	(O->handle());
+				O->setHandle	(0);
+			}
+		}
+
 		// Info
 		for (xr_vector<CObject*>::iterator oit=objects_active.begin(); oit!=objects_active.end(); oit++)
 			for (int it = destroy_queue.size()-1; it>=0; it--){	
@@ -213,19 +233,76 @@ void CObjectList::Update		(bool bForce)
 void CObjectList::net_Register		(CObject* O)
 {
 	R_ASSERT		(O);
-	map_NETID.insert(mk_pair(O->ID(),O));
+	u32		ID		= O->ID();
+	if (ID>=net_entries.size())	{
+		net_entry	E;
+		E.object	= NULL;
+		E.name_key	= 0;
+		E.next_name	= u32(-1);
+		E.next_cls	= u32(-1);
+		net_entries.resize	(ID+1,E);
+	}
+	if (net_entries[ID].object)	return;		// the first one keeps the ID
 	//Msg			("-------------------------------- Register: %s",O->cName());
+
+	net_entries[ID].object	= O;
+	net_count		++;
+	if (net_count>net_by_name.size())	net_rehash(_max(net_by_name.size()*2,u32(256)));
+	else								net_link	(ID);
 }
 
 void CObjectList::net_Unregister	(CObject* O)
 {
-	xr_map<u32,CObject*>::iterator	it = map_NETID.find(O->ID());
-	if ((it!=map_NETID.end()) && (it->second == O))	{
+	u32		ID		= O->ID();
+	if ((ID<net_entries.size()) && (net_entries[ID].object == O))	{
 		// Msg			("-------------------------------- Unregster: %s",O->cName());
-		map_NETID.erase(it);
+		net_unlink					(ID);
+		net_entries[ID].object		= NULL;
+		net_count					--;
 	}
 }
 
+void CObjectList::net_Reindex		(CObject* O)
+{
+	u32		ID		= O->ID();
+	if ((ID<net_entries.size()) && (net_entries[ID].object == O))	{
+		net_unlink					(ID);
+		net_link					(ID);
+	}
+}
+
+void CObjectList::net_link			(u32 ID)
+{
+	net_entry&	E					= net_entries[ID];
+	E.name_key						= name_key(E.object->cName());
+	u32&		head_name			= net_by_name[E.name_key&(net_by_name.size()-1)];
+	E.next_name						= head_name;
+	head_name						= ID;
+	u32&		head_cls			= net_by_cls[cls_key(E.object->CLS_ID)&(net_by_cls.size()-1)];
+	E.next_cls						= head_cls;
+	head_cls						= ID;
+}
+
+void CObjectList::net_unlink		(u32 ID)
+{
+	net_entry&	E					= net_entries[ID];
+	u32*		it;
+	for (it=&net_by_name[E.name_key&(net_by_name.size()-1)]; *it!=ID; it=&net_entries[*it].next_name)
+		VERIFY						(*it!=u32(-1));
+	*it								= E.next_name;
+	for (it=&net_by_cls[cls_key(E.object->CLS_ID)&(net_by_cls.size()-1)]; *it!=ID; it=&net_entries[*it].next_cls)
+		VERIFY						(*it!=u32(-1));
+	*it								= E.next_cls;
+}
+
+void CObjectList::net_rehash		(u32 buckets)
+{
+	net_by_name.assign				(buckets,u32(-1));
+	net_by_cls.assign				(buckets/4,u32(-1));
+	for (u32 ID=0; ID<net_entries.size(); ID++)
+		if (net_entries[ID].object)	net_link(ID);
+}
+
 int	g_Dump_Export_Obj = 0;
 
 u32	CObjectList::net_Export			(NET_Packet* _Packet,	u32 start, u32 max_object_size	)
@@ -294,13 +371,12 @@ void CObjectList::net_Import		(NET_Packet* Packet)
 
 CObject* CObjectList::net_Find			(u32 ID)
 {
-	xr_map<u32,CObject*>::iterator	it = map_NETID.find(ID);
-	return (it==map_NETID.end())?0:it->second;
+	return (ID<net_entries.size()) ? net_entries[ID].object : NULL;
 }
 
 void CObjectList::Load		()
 {
-	R_ASSERT				(map_NETID.empty() && objects_active.empty() && destroy_queue.empty() && objects_sleeping.empty());
+	R_ASSERT				((0==net_count) && objects_active.empty() && destroy_queue.empty() && objects_sleeping.empty());
 }
 
 void CObjectList::Unload	( )
@@ -339,6 +415,7 @@ CObject*	CObjectList::Create				( LPCSTR	name	)
 {
 	CObject*	O				= g_pGamePersistent->ObjectPool.create(name);
 //	Msg("CObjectList::Create [%x]%s", O, name);
+	O->setHandle				(g_object_handles.alloc(O));
 	objects_sleeping.push_back	(O);
 	return						O;
 }
@@ -348,6 +425,11 @@ void		CObjectList::Destroy			( CObject*	O		)
 	if (0==O)								return;
 	net_Unregister							(O);
 
+	if (O->handle())						{
+		g_object_handles.release			(O->handle());
+		O->setHandle						(0);
+	}
+
 	// crows
 	xr_vector<CObject*>::iterator _i0		= std::find(crows_0.begin(),crows_0.end(),O);
 	if	(_i0!=crows_0.end())				crows_0.erase	(_i0);
@@ -411,6 +493,60 @@ bool CObjectList::dump_all_objects()
 	return false;
 }
 
+void CObjectList::benchmark()
+{
+	// every registered object is looked up by ID, name and class, the indices against linear scans
+	xr_vector<CObject*>		objects;
+	for (u32 ID=0; ID<net_entries.size(); ID++)
+		if (net_entries[ID].object)		objects.push_back(net_entries[ID].object);
+	if (objects.empty())	{
+		Msg					("! no objects registered");
+		return;
+	}
+
+	CTimer					T;
+	u32						found = 0;
+	float					t_id, t_name, t_cls, t_name_linear, t_cls_linear;
+	xr_vector<CObject*>::iterator I, E = objects.end();
+
+	T.Start					();
+	for (I=objects.begin(); I!=E; I++)	found	+= (net_Find((*I)->ID())==*I) ? 1 : 0;
+	t_id					= T.GetElapsed_sec()*1000.f;
+
+	T.Start					();
+	for (I=objects.begin(); I!=E; I++)	found	+= FindObjectByName((*I)->cName()) ? 1 : 0;
+	t_name					= T.GetElapsed_sec()*1000.f;
+
+	T.Start					();
+	for (I=objects.begin(); I!=E; I++)	found	+= FindObjectByCLS_ID((*I)->CLS_ID) ? 1 : 0;
+	t_cls					= T.GetElapsed_sec()*1000.f;
+
+	T.Start					();
+	for (I=objects.begin(); I!=E; I++)	{
+		xr_vector<CObject*>::iterator it;
+		for (it=objects_active.begin(); it!=objects_active.end(); it++)
+			if ((*it)->cName().equal((*I)->cName()))	break;
+		if (it==objects_active.end())
+			for (it=objects_sleeping.begin(); it!=objects_sleeping.end(); it++)
+				if ((*it)->cName().equal((*I)->cName()))	break;
+		found				+= (it!=objects_sleeping.end()) ? 1 : 0;
+	}
+	t_name_linear			= T.GetElapsed_sec()*1000.f;
+
+	T.Start					();
+	for (I=objects.begin(); I!=E; I++)	{
+		xr_vector<CObject*>::iterator it	= std::find_if(objects_active.begin(),objects_active.end(),fClassEQ((*I)->CLS_ID));
+		if (it==objects_active.end())	it	= std::find_if(objects_sleeping.begin(),objects_sleeping.end(),fClassEQ((*I)->CLS_ID));
+		found				+= (it!=objects_sleeping.end()) ? 1 : 0;
+	}
+	t_cls_linear			= T.GetElapsed_sec()*1000.f;
+
+	Msg		("- objects: %d lookups of each kind, %d found",objects.size(),found);
+	Msg		("- by ID   : %2.3fms",t_id);
+	Msg		("- by name : %2.3fms, linear scan %2.3fms",t_name,t_name_linear);
+	Msg		("- by class: %2.3fms, linear scan %2.3fms",t_cls,t_cls_linear);
+}
+
 void CObjectList::register_object_to_destroy(CObject *object_to_destroy)
 {
 	VERIFY					(!registered_object_to_destroy(object_to_destroy));
@@ -8,8 +8,20 @@ class	NET_Packet	;
 class	ENGINE_API 				CObjectList
 {
 private:
+	// net_Register'ed objects: flat table by ID, chained into hashed indices by name and class
+	struct	net_entry
+	{
+		CObject*				object				;
+		u32						name_key			;	// hash of the name the object is linked under
+		u32						next_name			;
+		u32						next_cls			;
+	};
+	xr_vector<net_entry>		net_entries			;
+	u32							net_count			;
+	xr_vector<u32>				net_by_name			;	// bucket heads (IDs), u32(-1) - empty
+	xr_vector<u32>				net_by_cls			;
+
 	// data
-	xr_map<u32,CObject*>		map_NETID			;
 	xr_vector<CObject*>			destroy_queue		;
 	xr_vector<CObject*>			objects_active		;
 	xr_vector<CObject*>			objects_sleeping	;
@@ -59,6 +71,7 @@ public:
 	u32							net_Export			( NET_Packet*	P,		u32 _start, u32 _count	);	// return next start
 	void						net_Import			( NET_Packet*	P		);
 	CObject*					net_Find			( u32 ID				);
+	void						net_Reindex			( CObject*		O		);	// after rename
 
 	void						o_crow				(CObject*	O)			{
 		crows->push_back(O)		;
@@ -73,6 +86,11 @@ public:
 		else							return objects_sleeping	[_it-objects_active.size()];
 	}
 	bool						dump_all_objects	();
+	void						benchmark			();
+private:
+	void						net_link			( u32 ID				);
+	void						net_unlink			( u32 ID				);
+	void						net_rehash			( u32 buckets			);
 
 public:
 			void				register_object_to_destroy	(CObject *object_to_destroy);